@@ -0,0 +1,43 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Allocator.h"
+
+AllocatorCache::~AllocatorCache() {}
+
+void AllocatorCache::releaseThreadCaches() {
+    AllocatorCache*& caches = threadCaches();
+    while (caches != NULL) {
+        AllocatorCache* cache = caches;
+        caches = cache->m_next;
+        cache->release();
+        delete cache;
+    }
+}
+
+AllocatorCache::AllocatorCache() {
+    AllocatorCache*& caches = threadCaches();
+    m_next = caches;
+    caches = this;
+}
+
+AllocatorCache*& AllocatorCache::threadCaches() {
+    static wxTLS_TYPE(AllocatorCache*) caches;
+    return wxTLS_VALUE(caches);
+}
@@ -20,183 +20,266 @@
 #ifndef TrenchBroom_Allocator_h
 #define TrenchBroom_Allocator_h
 
+#include <algorithm>
 #include <cassert>
-#include <iostream>
-#include <limits>
-#include <stack>
+#include <cstddef>
+#include <map>
 #include <vector>
 
+#include <wx/thread.h>
+#include <wx/tls.h>
+
 // Undefine this to prevent false positives when looking for memory leaks.
 #define TB_ENABLE_ALLOCATOR 1
 
-template <class T, size_t PoolSize = 64, size_t BlocksPerChunk = 256>
+/*
+ Every thread that allocates objects through an Allocator keeps a small cache of free blocks per allocator so that
+ most allocations and deallocations do not have to synchronize with other threads. The caches of a thread are
+ linked together so that they can be returned when the thread exits.
+ */
+class AllocatorCache {
+private:
+    AllocatorCache* m_next;
+public:
+    virtual ~AllocatorCache();
+    
+    // Returns the blocks cached by the calling thread to their allocators. Must be called by every thread other than
+    // the main thread before it exits, otherwise its cached blocks are lost.
+    static void releaseThreadCaches();
+protected:
+    AllocatorCache();
+private:
+    static AllocatorCache*& threadCaches();
+    virtual void release() = 0;
+};
+
+/*
+ A pool allocator for objects of type T. The blocks are carved out of chunks which are shared by all threads. Blocks
+ are moved between the chunks and the threads' caches in batches, so a block may be freed by a different thread than
+ the one which allocated it.
+ */
+template <class T, size_t BlocksPerChunk = 256>
 class Allocator {
 private:
-    class Chunk {
-    private:
-        unsigned char m_firstFreeBlock;
-        unsigned char m_numFreeBlocks;
-        unsigned char m_blocks[BlocksPerChunk * sizeof(T)];
-    public:
+    // the number of blocks that are moved between a thread's cache and the chunks at once
+    static const size_t BatchSize = 64;
+    // the number of completely free chunks to keep around
+    static const size_t MaxEmptyChunks = 2;
+    
+    union Block {
+        Block* next;
+        long double alignment;
+        unsigned char data[sizeof(T)];
+    };
+    
+    struct Chunk {
+        Block blocks[BlocksPerChunk];
+        Block* freeBlocks;
+        size_t freeCount;
+        bool available;
+        
         Chunk() :
-        m_firstFreeBlock(0),
-        m_numFreeBlocks(BlocksPerChunk - 1) {
-            for (size_t i = 0; i < BlocksPerChunk - 1; i++)
-                m_blocks[i * sizeof(T)] = static_cast<unsigned char>(i + 1);
+        freeBlocks(NULL),
+        freeCount(BlocksPerChunk),
+        available(false) {
+            for (size_t i = BlocksPerChunk; i > 0; --i) {
+                blocks[i - 1].next = freeBlocks;
+                freeBlocks = &blocks[i - 1];
+            }
+        }
+        
+        bool contains(const Block* block) const {
+            return block >= blocks && block < blocks + BlocksPerChunk;
         }
         
-        bool contains(const T* t) const {
-            const unsigned char* block = reinterpret_cast<const unsigned char*>(t);
-            if (block < m_blocks)
-                return false;
-            size_t offset = static_cast<size_t>(block - m_blocks);
-            return offset < (BlocksPerChunk - 1) * sizeof(T);
+        bool empty() const {
+            return freeCount == BlocksPerChunk;
         }
+    };
+    
+    class Chunks {
+    private:
+        typedef std::map<const Block*, Chunk*> ChunkMap;
+        typedef std::vector<Chunk*> ChunkList;
         
-        T* allocate() {
-            if (m_numFreeBlocks == 0)
-                return NULL;
+        wxCriticalSection m_lock;
+        ChunkMap m_chunks;
+        ChunkList m_available;
+        size_t m_emptyCount;
+    public:
+        Chunks() :
+        m_emptyCount(0) {}
+        
+        // The chunks are deliberately not deleted since static objects might still be using them.
+        
+        // Prepends count free blocks to the given list.
+        void take(Block*& list, const size_t count) {
+            wxCriticalSectionLocker lock(m_lock);
             
-            unsigned char* block = m_blocks + m_firstFreeBlock * sizeof(T);
-            m_firstFreeBlock = *block;
-            m_numFreeBlocks--;
-            return reinterpret_cast<T*>(block);
+            size_t taken = 0;
+            while (taken < count) {
+                if (m_available.empty())
+                    createChunk();
+                
+                Chunk* chunk = m_available.back();
+                if (chunk->empty())
+                    --m_emptyCount;
+                
+                while (taken < count && chunk->freeCount > 0) {
+                    Block* block = chunk->freeBlocks;
+                    chunk->freeBlocks = block->next;
+                    --chunk->freeCount;
+                    
+                    block->next = list;
+                    list = block;
+                    ++taken;
+                }
+                
+                if (chunk->freeCount == 0) {
+                    chunk->available = false;
+                    m_available.pop_back();
+                }
+            }
         }
         
-        void deallocate(T* t) {
-            assert(m_numFreeBlocks < BlocksPerChunk - 1);
-            assert(contains(t));
+        // Returns the blocks of the given list to their chunks.
+        void give(Block* list) {
+            wxCriticalSectionLocker lock(m_lock);
             
-            unsigned char* block = reinterpret_cast<unsigned char*>(t);
-            assert(block >= m_blocks);
-            size_t offset = static_cast<size_t>(block - m_blocks);
-            assert(offset % sizeof(T) == 0);
+            while (list != NULL) {
+                Block* block = list;
+                list = list->next;
+                
+                Chunk* chunk = findChunk(block);
+                block->next = chunk->freeBlocks;
+                chunk->freeBlocks = block;
+                ++chunk->freeCount;
+                
+                if (!chunk->available) {
+                    chunk->available = true;
+                    m_available.push_back(chunk);
+                }
+                
+                if (chunk->empty()) {
+                    if (m_emptyCount < MaxEmptyChunks)
+                        ++m_emptyCount;
+                    else
+                        deleteChunk(chunk);
+                }
+            }
+        }
+    private:
+        void createChunk() {
+            Chunk* chunk = new Chunk();
+            chunk->available = true;
+            m_chunks.insert(std::make_pair(chunk->blocks, chunk));
+            m_available.push_back(chunk);
+            ++m_emptyCount;
+        }
+        
+        void deleteChunk(Chunk* chunk) {
+            m_chunks.erase(chunk->blocks);
             
-            size_t index = offset / sizeof(T);
-            assert(index < BlocksPerChunk);
+            typename ChunkList::iterator it = std::find(m_available.begin(), m_available.end(), chunk);
+            assert(it != m_available.end());
+            m_available.erase(it);
             
-            *block = m_firstFreeBlock;
-            m_firstFreeBlock = static_cast<unsigned char>(index);
-            m_numFreeBlocks++;
+            delete chunk;
         }
         
-        bool empty() const {
-            return m_numFreeBlocks == BlocksPerChunk - 1;
+        Chunk* findChunk(const Block* block) const {
+            typename ChunkMap::const_iterator it = m_chunks.upper_bound(block);
+            assert(it != m_chunks.begin());
+            --it;
+            
+            Chunk* chunk = it->second;
+            assert(chunk->contains(block));
+            return chunk;
         }
+    };
+    
+    class Cache : public AllocatorCache {
+    public:
+        Block* blocks;
+        size_t count;
+        
+        Cache() :
+        blocks(NULL),
+        count(0) {}
         
-        bool full() const {
-            return m_numFreeBlocks == 0;
+        Block* allocate() {
+            if (count == 0) {
+                chunks().take(blocks, BatchSize);
+                count = BatchSize;
+            }
+            
+            Block* block = blocks;
+            blocks = block->next;
+            --count;
+            return block;
+        }
+        
+        void deallocate(Block* block) {
+            block->next = blocks;
+            blocks = block;
+            ++count;
+            
+            if (count > 2 * BatchSize) {
+                Block* first = blocks;
+                Block* last = first;
+                for (size_t i = 1; i < BatchSize; ++i)
+                    last = last->next;
+                
+                blocks = last->next;
+                last->next = NULL;
+                count -= BatchSize;
+                chunks().give(first);
+            }
+        }
+    private:
+        void release() {
+            if (blocks != NULL)
+                chunks().give(blocks);
+            blocks = NULL;
+            count = 0;
+            threadCache() = NULL;
         }
     };
     
-    typedef std::vector<Chunk*> ChunkList;
-    typedef std::stack<T*> Pool;
-    
-    static Pool& pool() {
-        static Pool p;
-        return p;
-    }
+    // a static member rather than a function local static because the latter's initialization is not thread safe
+    // with all supported compilers, and the chunks are first used by worker threads
+    static Chunks s_chunks;
     
-    static ChunkList& fullChunks() {
-        static ChunkList chunks;
-        return chunks;
+    static Chunks& chunks() {
+        return s_chunks;
     }
     
-    static ChunkList& mixedChunks() {
-        static ChunkList chunks;
-        return chunks;
+    static Cache*& threadCache() {
+        static wxTLS_TYPE(Cache*) cache;
+        return wxTLS_VALUE(cache);
     }
     
-    static ChunkList emptyChunks() {
-        static ChunkList chunks;
-        return chunks;
+    static Cache& cache() {
+        Cache*& c = threadCache();
+        if (c == NULL)
+            c = new Cache();
+        return *c;
     }
 public:
 #ifdef TB_ENABLE_ALLOCATOR
     void* operator new(size_t size) {
         assert(size == sizeof(T));
-        
-        if (!pool().empty()) {
-            T* t = pool().top();
-            pool().pop();
-            return t;
-        }
-        
-        Chunk* chunk = NULL;
-        if (mixedChunks().empty()) {
-            if (!emptyChunks().empty()) {
-                chunk = emptyChunks().back();
-                emptyChunks().pop_back();
-            } else {
-                chunk = new Chunk();
-            }
-        } else {
-            chunk = mixedChunks().back();
-            mixedChunks().pop_back();
-        }
-        
-        assert(!chunk->full());
-        T* block = chunk->allocate();
-        
-        if (chunk->full())
-            fullChunks().push_back(chunk);
-            else
-                mixedChunks().push_back(chunk);
-                return block;
+        return cache().allocate();
     }
     
     void operator delete(void* block) {
-        T* t = reinterpret_cast<T*>(block);
-        
-        if (PoolSize > 0 && pool().size() < PoolSize) {
-            pool().push(t);
-            return;
-        }
-        
-        typename ChunkList::reverse_iterator fullIt, fullEnd, mixedIt, mixedEnd;
-        fullIt = fullChunks().rbegin();
-        fullEnd = fullChunks().rend();
-        mixedIt = mixedChunks().rbegin();
-        mixedEnd = mixedChunks().rend();
-        
-        Chunk* chunk = NULL;
-        while (fullIt < fullEnd || mixedIt < mixedEnd) {
-            if (fullIt < fullEnd) {
-                Chunk* fullChunk = *fullIt;
-                if (fullChunk->contains(t)) {
-                    chunk = fullChunk;
-                    break;
-                }
-                ++fullIt;
-            }
-            if (mixedIt < mixedEnd) {
-                Chunk* mixedChunk = *mixedIt;
-                if (mixedChunk->contains(t)) {
-                    chunk = mixedChunk;
-                    break;
-                }
-                ++mixedIt;
-            }
-        }
-        
-        assert(chunk != NULL);
-        
-        if (chunk->full()) {
-            fullChunks().erase((fullIt + 1).base());
-            mixedChunks().push_back(chunk);
-        }
-        
-        chunk->deallocate(t);
-        
-        if (chunk->empty()) {
-            mixedChunks().erase((mixedIt + 1).base());
-            if (emptyChunks().size() < 2)
-                emptyChunks().push_back(chunk);
-                else
-                    delete chunk;
-        }
+        if (block != NULL)
+            cache().deallocate(static_cast<Block*>(block));
     }
 #endif
 };
 
+template <class T, size_t BlocksPerChunk>
+typename Allocator<T, BlocksPerChunk>::Chunks Allocator<T, BlocksPerChunk>::s_chunks;
+
 #endif
@@ -24,22 +24,82 @@
 #include "Logger.h"
 #include "Assets/EntityModel.h"
 #include "IO/EntityModelLoader.h"
+#include "IO/ImageLoader.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 
+#include <algorithm>
+#include <cassert>
+
 namespace TrenchBroom {
     namespace Assets {
+        class EntityModelManager::LoadModelTask : public ThreadPool::Task {
+        private:
+            const EntityModelManager& m_manager;
+            const IO::EntityModelLoader* m_loader;
+            IO::Path m_path;
+            EntityModel* m_model;
+            String m_error;
+        public:
+            LoadModelTask(const EntityModelManager& manager, const IO::EntityModelLoader* loader, const IO::Path& path) :
+            m_manager(manager),
+            m_loader(loader),
+            m_path(path),
+            m_model(NULL) {}
+            
+            ~LoadModelTask() {
+                delete m_model;
+            }
+            
+            const IO::Path& path() const {
+                return m_path;
+            }
+            
+            EntityModel* releaseModel() {
+                EntityModel* model = m_model;
+                m_model = NULL;
+                return model;
+            }
+            
+            const String& error() const {
+                return m_error;
+            }
+        private:
+            void doRun() {
+                if (!m_manager.cancelled()) {
+                    try {
+                        m_model = m_loader->loadEntityModel(m_path);
+                    } catch (const std::exception& e) {
+                        m_error = e.what();
+                    } catch (...) {
+                        m_error = "Unknown error";
+                    }
+                }
+                // the manager waits for every task to report back, so nothing may escape before this call
+                m_manager.loadTaskDone(this);
+            }
+        };
+        
         EntityModelManager::EntityModelManager(Logger* logger, int minFilter, int magFilter) :
         m_logger(logger),
         m_loader(NULL),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_loadPool(),
+        m_loadTasksDone(m_mutex),
+        m_runningLoadTasks(0),
+        m_cancelled(false) {
+            // the models are loaded on worker threads, and some of them load images
+            IO::ImageLoader::initialize();
+        }
         
         EntityModelManager::~EntityModelManager() {
             clear();
         }
         
         void EntityModelManager::clear() {
+            cancelLoading();
+            
             MapUtils::clearAndDelete(m_renderers);
             MapUtils::clearAndDelete(m_models);
             m_rendererMismatches.clear();
@@ -71,25 +131,11 @@ namespace TrenchBroom {
             if (it != m_models.end())
                 return it->second;
             
-            if (m_modelMismatches.count(path) > 0)
+            if (m_modelMismatches.count(path) > 0 || m_pendingModels.count(path) > 0)
                 return NULL;
             
-            try {
-                EntityModel* model = loadModel(path);
-                assert(model != NULL);
-                m_models[path] = model;
-                m_unpreparedModels.push_back(model);
-                
-                if (m_logger != NULL)
-                    m_logger->debug("Loaded entity model %s", path.asString().c_str());
-
-                return model;
-            } catch (const GameException& e) {
-                m_modelMismatches.insert(path);
-                if (m_logger != NULL)
-                    m_logger->debug(e.what());
-                throw;
-            }
+            loadModel(path);
+            return NULL;
         }
         
         Renderer::TexturedIndexRangeRenderer* EntityModelManager::renderer(const Assets::ModelSpecification& spec) const {
@@ -120,15 +166,96 @@ namespace TrenchBroom {
             return renderer;
         }
         
-        EntityModel* EntityModelManager::loadModel(const IO::Path& path) const {
+        bool EntityModelManager::commitLoadedModels() {
+            LoadModelTaskList tasks;
+            {
+                wxMutexLocker lock(m_mutex);
+                tasks.swap(m_loadedModels);
+            }
+            
+            bool modelsLoaded = false;
+            LoadModelTaskList::const_iterator it, end;
+            for (it = tasks.begin(), end = tasks.end(); it != end; ++it) {
+                LoadModelTask* task = *it;
+                const IO::Path& path = task->path();
+                m_pendingModels.erase(path);
+                
+                EntityModel* model = task->releaseModel();
+                if (model != NULL) {
+                    m_models[path] = model;
+                    m_unpreparedModels.push_back(model);
+                    modelsLoaded = true;
+                    
+                    if (m_logger != NULL)
+                        m_logger->debug("Loaded entity model %s", path.asString().c_str());
+                } else {
+                    m_modelMismatches.insert(path);
+                    if (m_logger != NULL)
+                        m_logger->error(task->error());
+                }
+            }
+            
+            VectorUtils::clearAndDelete(tasks);
+            return modelsLoaded;
+        }
+        
+        bool EntityModelManager::hasPendingModels() const {
+            return !m_pendingModels.empty() || !m_unpreparedModels.empty() || !m_unpreparedRenderers.empty();
+        }
+
+        void EntityModelManager::waitUntilLoaded() const {
+            wxMutexLocker lock(m_mutex);
+            while (m_runningLoadTasks > 0)
+                m_loadTasksDone.Wait();
+        }
+
+        void EntityModelManager::loadModel(const IO::Path& path) const {
             assert(m_loader != NULL);
-            return m_loader->loadEntityModel(path);
+            m_pendingModels.insert(path);
+            {
+                wxMutexLocker lock(m_mutex);
+                ++m_runningLoadTasks;
+            }
+            
+            // the task is deleted when the loaded model is committed
+            m_loadPool.enqueue(new LoadModelTask(*this, m_loader, path));
+        }
+        
+        void EntityModelManager::cancelLoading() {
+            {
+                wxMutexLocker lock(m_mutex);
+                m_cancelled = true;
+            }
+            waitUntilLoaded();
+            
+            wxMutexLocker lock(m_mutex);
+            VectorUtils::clearAndDelete(m_loadedModels);
+            m_pendingModels.clear();
+            m_cancelled = false;
+        }
+        
+        bool EntityModelManager::cancelled() const {
+            wxMutexLocker lock(m_mutex);
+            return m_cancelled;
+        }
+        
+        void EntityModelManager::loadTaskDone(LoadModelTask* task) const {
+            wxMutexLocker lock(m_mutex);
+            m_loadedModels.push_back(task);
+            
+            assert(m_runningLoadTasks > 0);
+            if (--m_runningLoadTasks == 0)
+                m_loadTasksDone.Broadcast();
         }
 
         void EntityModelManager::prepare(Renderer::Vbo& vbo) {
             resetTextureMode();
-            prepareModels();
-            prepareRenderers(vbo);
+            
+            // renderers are only prepared once the models they were built from have been prepared
+            size_t budget = PrepareBudget;
+            budget -= prepareModels(budget);
+            if (m_unpreparedModels.empty())
+                prepareRenderers(vbo, budget);
         }
 
         void EntityModelManager::resetTextureMode() {
@@ -136,28 +263,31 @@ namespace TrenchBroom {
                 ModelCache::const_iterator it, end;
                 for (it = m_models.begin(), end = m_models.end(); it != end; ++it) {
                     EntityModel* model = it->second;
-                    model->setTextureMode(m_minFilter, m_magFilter);
+                    if (model->prepared())
+                        model->setTextureMode(m_minFilter, m_magFilter);
                 }
                 m_resetTextureMode = false;
             }
         }
         
-        void EntityModelManager::prepareModels() {
-            ModelList::const_iterator it, end;
-            for (it = m_unpreparedModels.begin(), end = m_unpreparedModels.end(); it != end; ++it) {
-                Assets::EntityModel* model = *it;
+        size_t EntityModelManager::prepareModels(const size_t budget) {
+            const size_t count = std::min(budget, m_unpreparedModels.size());
+            for (size_t i = 0; i < count; ++i) {
+                Assets::EntityModel* model = m_unpreparedModels[i];
                 model->prepare(m_minFilter, m_magFilter);
             }
-            m_unpreparedModels.clear();
+            m_unpreparedModels.erase(m_unpreparedModels.begin(), m_unpreparedModels.begin() + static_cast<ModelList::difference_type>(count));
+            return count;
         }
         
-        void EntityModelManager::prepareRenderers(Renderer::Vbo& vbo) {
-            RendererList::const_iterator it, end;
-            for (it = m_unpreparedRenderers.begin(), end = m_unpreparedRenderers.end(); it != end; ++it) {
-                Renderer::TexturedIndexRangeRenderer* renderer = *it;
+        size_t EntityModelManager::prepareRenderers(Renderer::Vbo& vbo, const size_t budget) {
+            const size_t count = std::min(budget, m_unpreparedRenderers.size());
+            for (size_t i = 0; i < count; ++i) {
+                Renderer::TexturedIndexRangeRenderer* renderer = m_unpreparedRenderers[i];
                 renderer->prepare(vbo);
             }
-            m_unpreparedRenderers.clear();
+            m_unpreparedRenderers.erase(m_unpreparedRenderers.begin(), m_unpreparedRenderers.begin() + static_cast<RendererList::difference_type>(count));
+            return count;
         }
     }
 }
@@ -20,6 +20,7 @@
 #ifndef TrenchBroom_EntityModelManager
 #define TrenchBroom_EntityModelManager
 
+#include "ThreadPool.h"
 #include "Assets/ModelDefinition.h"
 #include "IO/Path.h"
 #include "Model/ModelTypes.h"
@@ -28,6 +29,8 @@
 #include <set>
 #include <vector>
 
+#include <wx/thread.h>
+
 namespace TrenchBroom {
     class Logger;
     
@@ -43,16 +46,29 @@ namespace TrenchBroom {
     namespace Assets {
         class EntityModel;
         
+        /*
+         Models are loaded on worker threads. Requesting a model that has not been loaded yet queues it for loading
+         and returns NULL; further requests for the same model are not queued again. Loaded models become available
+         when they are committed on the main thread, and their textures and vertices are prepared over several
+         frames.
+         */
         class EntityModelManager {
         private:
+            class LoadModelTask;
+            
             typedef std::map<IO::Path, EntityModel*> ModelCache;
             typedef std::set<IO::Path> ModelMismatches;
+            typedef std::set<IO::Path> PendingModels;
             typedef std::vector<EntityModel*> ModelList;
+            typedef std::vector<LoadModelTask*> LoadModelTaskList;
             
             typedef std::map<Assets::ModelSpecification, Renderer::TexturedIndexRangeRenderer*> RendererCache;
             typedef std::set<Assets::ModelSpecification> RendererMismatches;
             typedef std::vector<Renderer::TexturedIndexRangeRenderer*> RendererList;
             
+            // the maximum number of models and renderers prepared per call to prepare
+            static const size_t PrepareBudget = 16;
+            
             Logger* m_logger;
             const IO::EntityModelLoader* m_loader;
 
@@ -62,11 +78,21 @@ namespace TrenchBroom {
 
             mutable ModelCache m_models;
             mutable ModelMismatches m_modelMismatches;
+            mutable PendingModels m_pendingModels;
             mutable RendererCache m_renderers;
             mutable RendererMismatches m_rendererMismatches;
 
             mutable ModelList m_unpreparedModels;
             mutable RendererList m_unpreparedRenderers;
+            
+            mutable ThreadPool m_loadPool;
+            
+            // guards the state below, which is shared with the worker threads
+            mutable wxMutex m_mutex;
+            mutable wxCondition m_loadTasksDone;
+            mutable size_t m_runningLoadTasks;
+            bool m_cancelled;
+            mutable LoadModelTaskList m_loadedModels;
         public:
             EntityModelManager(Logger* logger, int minFilter, int magFilter);
             ~EntityModelManager();
@@ -78,14 +104,22 @@ namespace TrenchBroom {
             
             EntityModel* model(const IO::Path& path) const;
             Renderer::TexturedIndexRangeRenderer* renderer(const Assets::ModelSpecification& spec) const;
+            
+            // Makes the models which were loaded since the last call available and returns whether there were any.
+            bool commitLoadedModels();
+            bool hasPendingModels() const;
+            void waitUntilLoaded() const;
         private:
-            EntityModel* loadModel(const IO::Path& path) const;
+            void loadModel(const IO::Path& path) const;
+            void cancelLoading();
+            bool cancelled() const;
+            void loadTaskDone(LoadModelTask* task) const;
         public:
             void prepare(Renderer::Vbo& vbo);
         private:
             void resetTextureMode();
-            void prepareModels();
-            void prepareRenderers(Renderer::Vbo& vbo);
+            size_t prepareModels(size_t budget);
+            size_t prepareRenderers(Renderer::Vbo& vbo, size_t budget);
         };
     }
 }
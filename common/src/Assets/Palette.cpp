@@ -26,8 +26,73 @@
 #include <cstring>
 #include <fstream>
 
+// SSE2 intrinsics are available on x86 with every supported compiler, but GCC and Clang only allow them if the target
+// supports SSE2, while MSVC always allows them and the CPU must be checked at runtime on 32 bit targets
+#if defined __SSE2__ || (defined _MSC_VER && (defined _M_X64 || defined _M_IX86))
+#define TB_PALETTE_SSE2 1
+#include <emmintrin.h>
+#if defined _MSC_VER && defined _M_IX86
+#include <intrin.h>
+#endif
+#endif
+
 namespace TrenchBroom {
     namespace Assets {
+#ifdef TB_PALETTE_SSE2
+        static bool cpuHasSse2() {
+#if defined _MSC_VER && defined _M_IX86
+            int info[4];
+            __cpuid(info, 1);
+            return (info[3] & (1 << 26)) != 0;
+#else
+            return true;
+#endif
+        }
+        
+        static const bool HasSse2 = cpuHasSse2();
+        
+        // Packs four 0x00BBGGRR colors into their twelve RGB bytes at the start of the register.
+        static __m128i packRgb(__m128i colors) {
+            const __m128i evenColors = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF);
+            const __m128i oddColors = _mm_set_epi32(0x00FFFFFF, 0, 0x00FFFFFF, 0);
+            colors = _mm_or_si128(_mm_and_si128(colors, evenColors), _mm_srli_epi64(_mm_and_si128(colors, oddColors), 8));
+            
+            // each 64 bit half now holds six bytes, which are joined by moving the upper half down by two bytes
+            const __m128i lowerHalf = _mm_set_epi32(0, 0, 0x0000FFFF, -1);
+            const __m128i upperHalf = _mm_set_epi32(0, -1, static_cast<int>(0xFFFF0000), 0);
+            return _mm_or_si128(_mm_and_si128(colors, lowerHalf), _mm_and_si128(_mm_srli_si128(colors, 2), upperHalf));
+        }
+        
+        static __m128i lookupColors(const unsigned int* packedColors, const unsigned char* indices, size_t* histogram) {
+            ++histogram[indices[0]];
+            ++histogram[indices[1]];
+            ++histogram[indices[2]];
+            ++histogram[indices[3]];
+            return _mm_set_epi32(static_cast<int>(packedColors[indices[3]]),
+                                 static_cast<int>(packedColors[indices[2]]),
+                                 static_cast<int>(packedColors[indices[1]]),
+                                 static_cast<int>(packedColors[indices[0]]));
+        }
+        
+        // Converts the pixels in groups of sixteen, which fill exactly three registers of RGB bytes, and returns the
+        // number of converted pixels.
+        static size_t indexedToRgbSse2(const unsigned int* packedColors, const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbImage, size_t* histogram) {
+            size_t i = 0;
+            for (; i + 16 <= pixelCount; i += 16) {
+                const __m128i rgb0 = packRgb(lookupColors(packedColors, indexedImage + i, histogram));
+                const __m128i rgb1 = packRgb(lookupColors(packedColors, indexedImage + i + 4, histogram));
+                const __m128i rgb2 = packRgb(lookupColors(packedColors, indexedImage + i + 8, histogram));
+                const __m128i rgb3 = packRgb(lookupColors(packedColors, indexedImage + i + 12, histogram));
+                
+                __m128i* out = reinterpret_cast<__m128i*>(rgbImage + i * 3);
+                _mm_storeu_si128(out,     _mm_or_si128(rgb0, _mm_slli_si128(rgb1, 12)));
+                _mm_storeu_si128(out + 1, _mm_or_si128(_mm_srli_si128(rgb1, 4), _mm_slli_si128(rgb2, 8)));
+                _mm_storeu_si128(out + 2, _mm_or_si128(_mm_srli_si128(rgb2, 8), _mm_slli_si128(rgb3, 4)));
+            }
+            return i;
+        }
+#endif
+
         Palette::Palette(const IO::Path& path) {
             if (StringUtils::caseInsensitiveEqual(path.extension(), "lmp"))
                 loadLmpPalette(path);
@@ -35,6 +100,7 @@ namespace TrenchBroom {
                 loadPcxPalette(path);
             else
                 throw FileSystemException("Unknown palette format " + path.asString());
+            packColors();
         }
 
         Palette::Palette(const Palette& other) :
@@ -42,18 +108,84 @@ namespace TrenchBroom {
         m_size(other.m_size) {
             m_data = new unsigned char[m_size];
             memcpy(m_data, other.m_data, m_size);
+            std::copy(other.m_packedColors, other.m_packedColors + 256, m_packedColors);
         }
 
         void Palette::operator=(Palette other) {
             using std::swap;
             swap(m_data, other.m_data);
             swap(m_size, other.m_size);
+            std::swap_ranges(m_packedColors, m_packedColors + 256, other.m_packedColors);
         }
 
         Palette::~Palette() {
             delete[] m_data;
         }
 
+        size_t Palette::hash() const {
+            // FNV-1a
+            size_t result = 2166136261u;
+            for (size_t i = 0; i < m_size; ++i) {
+                result ^= static_cast<size_t>(m_data[i]);
+                result *= 16777619u;
+            }
+            return result;
+        }
+        
+        void Palette::indexedToRgb(const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbImage, Color& averageColor) const {
+            // the average color is computed from a histogram of the indices instead of summing up every pixel
+            size_t histogram[256];
+            std::fill(histogram, histogram + 256, 0u);
+            
+            size_t i = 0;
+#ifdef TB_PALETTE_SSE2
+            if (HasSse2)
+                i = indexedToRgbSse2(m_packedColors, indexedImage, pixelCount, rgbImage, histogram);
+#endif
+            
+            // the remaining pixels, or all of them if SSE2 is not available
+            for (; i < pixelCount; ++i) {
+                const size_t index = static_cast<size_t>(indexedImage[i]);
+                assert(index * 3 + 2 < m_size);
+                
+                const unsigned char* color = m_data + index * 3;
+                unsigned char* pixel = rgbImage + i * 3;
+                pixel[0] = color[0];
+                pixel[1] = color[1];
+                pixel[2] = color[2];
+                ++histogram[index];
+            }
+            
+            // the sums are integers, so they are exact and do not depend on the order of summation
+            double avg[3];
+            avg[0] = avg[1] = avg[2] = 0.0;
+            
+            const size_t colorCount = std::min(static_cast<size_t>(256), m_size / 3);
+            for (size_t i = 0; i < colorCount; ++i) {
+                if (histogram[i] > 0) {
+                    const double count = static_cast<double>(histogram[i]);
+                    for (size_t j = 0; j < 3; ++j)
+                        avg[j] += count * static_cast<double>(m_data[i * 3 + j]);
+                }
+            }
+            
+            for (size_t i = 0; i < 3; ++i)
+                averageColor[i] = static_cast<float>(avg[i] / pixelCount / 0xFF);
+            averageColor[3] = 1.0f;
+        }
+
+        void Palette::packColors() {
+            // indices beyond the end of a short palette are invalid, they map to black
+            std::fill(m_packedColors, m_packedColors + 256, 0u);
+            const size_t colorCount = std::min(static_cast<size_t>(256), m_size / 3);
+            for (size_t i = 0; i < colorCount; ++i) {
+                const unsigned char* color = m_data + i * 3;
+                m_packedColors[i] = (static_cast<unsigned int>(color[0]) |
+                                     static_cast<unsigned int>(color[1]) << 8 |
+                                     static_cast<unsigned int>(color[2]) << 16);
+            }
+        }
+
         void Palette::loadLmpPalette(const IO::Path& path) {
             std::ifstream stream(path.asString().c_str(), std::ios::binary | std::ios::in);
             if (!stream.is_open())
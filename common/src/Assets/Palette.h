@@ -33,39 +33,33 @@ namespace TrenchBroom {
         private:
             unsigned char* m_data;
             size_t m_size;
+            // the colors as packed 0x00BBGGRR values for the SSE2 kernel
+            unsigned int m_packedColors[256];
         public:
             Palette(const IO::Path& path);
             Palette(const Palette& other);
             ~Palette();
             
             void operator=(Palette other);
+            
+            size_t hash() const;
 
-            template <typename IndexT, typename ColorT>
-            void indexedToRgb(const Buffer<IndexT>& indexedImage, const size_t pixelCount, Buffer<ColorT>& rgbImage, Color& averageColor) const {
+            template <typename IndexT>
+            void indexedToRgb(const Buffer<IndexT>& indexedImage, const size_t pixelCount, Buffer<unsigned char>& rgbImage, Color& averageColor) const {
                 indexedToRgb(&indexedImage[0], pixelCount, rgbImage, averageColor);
             }
             
-            template <typename IndexT, typename ColorT>
-            void indexedToRgb(const IndexT* indexedImage, const size_t pixelCount, Buffer<ColorT>& rgbImage, Color& averageColor) const {
-                double avg[3];
-                avg[0] = avg[1] = avg[2] = 0.0;
-                for (size_t i = 0; i < pixelCount; ++i) {
-                    const size_t index = static_cast<size_t>(static_cast<unsigned char>(indexedImage[i]));
-                    assert(index < m_size);
-                    for (size_t j = 0; j < 3; ++j) {
-                        const unsigned char c = m_data[index * 3 + j];
-                        rgbImage[i * 3 + j] = c;
-                        avg[j] += static_cast<double>(c);
-                    }
-                }
-                
-                for (size_t i = 0; i < 3; ++i)
-                    averageColor[i] = static_cast<float>(avg[i] / pixelCount / 0xFF);
-                averageColor[3] = 1.0f;
+            template <typename IndexT>
+            void indexedToRgb(const IndexT* indexedImage, const size_t pixelCount, Buffer<unsigned char>& rgbImage, Color& averageColor) const {
+                assert(rgbImage.size() >= 3 * pixelCount);
+                indexedToRgb(reinterpret_cast<const unsigned char*>(indexedImage), pixelCount, rgbImage.ptr(), averageColor);
             }
+            
+            void indexedToRgb(const unsigned char* indexedImage, size_t pixelCount, unsigned char* rgbImage, Color& averageColor) const;
         private:
             void loadLmpPalette(const IO::Path& path);
             void loadPcxPalette(const IO::Path& path);
+            void packColors();
         };
     }
 }
@@ -99,16 +99,16 @@ namespace TrenchBroom {
         }
         
         size_t Texture::usageCount() const {
-            return m_usageCount;
+            return static_cast<size_t>(m_usageCount);
         }
         
         void Texture::incUsageCount() {
-            ++m_usageCount;
+            wxAtomicInc(m_usageCount);
         }
         
         void Texture::decUsageCount() {
             assert(m_usageCount > 0);
-            --m_usageCount;
+            wxAtomicDec(m_usageCount);
         }
         
         bool Texture::overridden() const {
@@ -172,8 +172,8 @@ namespace TrenchBroom {
             deactivate();
         }
 
+        // placeholder textures are not prepared until their data has been decoded, binding them unbinds any texture
         void Texture::activate() const {
-            assert(isPrepared());
             glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
         }
         
@@ -184,5 +184,11 @@ namespace TrenchBroom {
         void Texture::setCollection(TextureCollection* collection) {
             m_collection = collection;
         }
+        
+        void Texture::setBuffers(const Color& averageColor, const TextureBuffer::List& buffers) {
+            assert(!isPrepared());
+            m_averageColor = averageColor;
+            m_buffers = buffers;
+        }
     }
 }
@@ -28,6 +28,8 @@
 #include <cassert>
 #include <vector>
 
+#include <wx/atomic.h>
+
 namespace TrenchBroom {
     namespace Assets {
         class TextureCollection;
@@ -44,7 +46,8 @@ namespace TrenchBroom {
             size_t m_height;
             Color m_averageColor;
 
-            size_t m_usageCount;
+            // faces may be created and deleted on worker threads
+            wxAtomicInt m_usageCount;
             bool m_overridden;
             
             mutable GLuint m_textureId;
@@ -75,6 +78,7 @@ namespace TrenchBroom {
             void deactivate() const;
         private:
             void setCollection(TextureCollection* collection);
+            void setBuffers(const Color& averageColor, const TextureBuffer::List& buffers);
             friend class TextureCollection;
         };
     }
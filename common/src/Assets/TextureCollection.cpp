@@ -22,16 +22,59 @@
 #include "CollectionUtils.h"
 #include "Assets/Texture.h"
 
+#include <algorithm>
+#include <cassert>
+
 namespace TrenchBroom {
     namespace Assets {
+        TextureCollection::LoadTask::LoadTask() :
+        m_collection(NULL) {}
+        
+        TextureCollection::LoadTask::~LoadTask() {}
+        
+        bool TextureCollection::LoadTask::cancelled() const {
+            assert(m_collection != NULL);
+            return m_collection->cancelled();
+        }
+
+        void TextureCollection::LoadTask::textureLoaded(const size_t index, const Color& averageColor, const TextureBuffer::List& buffers) {
+            assert(m_collection != NULL);
+            m_collection->textureLoaded(index, averageColor, buffers);
+        }
+
+        void TextureCollection::LoadTask::doRun() {
+            assert(m_collection != NULL);
+            try {
+                doLoad();
+            } catch (...) {
+                // textures that could not be decoded remain placeholders
+            }
+            m_collection->loadTaskDone();
+        }
+
+        TextureCollection::LoadedTexture::LoadedTexture(const size_t i_index, const Color& i_averageColor, const TextureBuffer::List& i_buffers) :
+        index(i_index),
+        averageColor(i_averageColor),
+        buffers(i_buffers) {}
+
         TextureCollection::TextureCollection(const String& name) :
         m_loaded(false),
-        m_name(name) {}
+        m_name(name),
+        m_prepareIndex(0),
+        m_loadingStarted(false),
+        m_loadTasksDone(m_mutex),
+        m_pendingLoadTasks(0),
+        m_cancelled(false) {}
 
         TextureCollection::TextureCollection(const String& name, const TextureList& textures) :
         m_loaded(true),
         m_name(name),
-        m_textures(textures.size()) {
+        m_textures(textures.size()),
+        m_prepareIndex(0),
+        m_loadingStarted(false),
+        m_loadTasksDone(m_mutex),
+        m_pendingLoadTasks(0),
+        m_cancelled(false) {
             for (size_t i = 0; i < textures.size(); ++i) {
                 Texture* texture = textures[i];
                 texture->setCollection(this);
@@ -39,7 +82,37 @@ namespace TrenchBroom {
             }
         }
 
+        TextureCollection::TextureCollection(const String& name, const TextureList& textures, const LoadTaskList& loadTasks) :
+        m_loaded(true),
+        m_name(name),
+        m_textures(textures.size()),
+        m_prepareIndex(0),
+        m_loadTasks(loadTasks),
+        m_loadingStarted(false),
+        m_loadTasksDone(m_mutex),
+        m_pendingLoadTasks(0),
+        m_cancelled(false) {
+            for (size_t i = 0; i < textures.size(); ++i) {
+                Texture* texture = textures[i];
+                texture->setCollection(this);
+                m_textures[i] = texture;
+            }
+            
+            LoadTaskList::const_iterator it, end;
+            for (it = m_loadTasks.begin(), end = m_loadTasks.end(); it != end; ++it) {
+                LoadTask* task = *it;
+                task->m_collection = this;
+            }
+        }
+
         TextureCollection::~TextureCollection() {
+            {
+                wxMutexLocker lock(m_mutex);
+                m_cancelled = true;
+            }
+            waitUntilLoaded();
+            VectorUtils::clearAndDelete(m_loadTasks);
+            
             VectorUtils::clearAndDelete(m_textures);
             if (!m_textureIds.empty()) {
                 glAssert(glDeleteTextures(static_cast<GLsizei>(m_textureIds.size()),
@@ -60,25 +133,105 @@ namespace TrenchBroom {
             return m_textures;
         }
 
-        void TextureCollection::prepare(const int minFilter, const int magFilter) {
-            assert(m_textureIds.empty());
+        void TextureCollection::startLoading(ThreadPool& pool) {
+            assert(!m_loadingStarted);
+            m_loadingStarted = true;
+            if (m_loadTasks.empty())
+                return;
             
-            const size_t textureCount = m_textures.size();
-            m_textureIds.resize(textureCount);
-            glAssert(glGenTextures(static_cast<GLsizei>(textureCount),
-                                   static_cast<GLuint*>(&m_textureIds.front())));
+            {
+                wxMutexLocker lock(m_mutex);
+                m_pendingLoadTasks = m_loadTasks.size();
+            }
+            
+            ThreadPool::TaskList tasks(m_loadTasks.begin(), m_loadTasks.end());
+            pool.enqueue(tasks);
+        }
+        
+        void TextureCollection::waitUntilLoaded() {
+            wxMutexLocker lock(m_mutex);
+            while (m_pendingLoadTasks > 0)
+                m_loadTasksDone.Wait();
+        }
 
-            for (size_t i = 0; i < textureCount; ++i) {
-                Texture* texture = m_textures[i];
-                texture->prepare(m_textureIds[i], minFilter, magFilter);
+        bool TextureCollection::prepared() const {
+            if (m_prepareIndex < m_textures.size())
+                return false;
+            
+            wxMutexLocker lock(m_mutex);
+            return m_pendingLoadTasks == 0 && m_loadedTextures.empty();
+        }
+
+        void TextureCollection::prepare(const int minFilter, const int magFilter) {
+            waitUntilLoaded();
+            prepare(minFilter, magFilter, m_textures.size());
+        }
+
+        size_t TextureCollection::prepare(const int minFilter, const int magFilter, const size_t budget) {
+            const size_t textureCount = m_textures.size();
+            if (m_textureIds.empty() && textureCount > 0) {
+                m_textureIds.resize(textureCount);
+                glAssert(glGenTextures(static_cast<GLsizei>(textureCount),
+                                       static_cast<GLuint*>(&m_textureIds.front())));
             }
+            
+            size_t count = 0;
+            
+            // textures which were created with their data, placeholders are skipped
+            while (count < budget && m_prepareIndex < textureCount) {
+                Texture* texture = m_textures[m_prepareIndex];
+                if (!texture->m_buffers.empty()) {
+                    texture->prepare(m_textureIds[m_prepareIndex], minFilter, magFilter);
+                    ++count;
+                }
+                ++m_prepareIndex;
+            }
+            
+            // placeholders whose data has been decoded in the meantime
+            LoadedTextureQueue loadedTextures;
+            {
+                wxMutexLocker lock(m_mutex);
+                const size_t loadedCount = std::min(budget - count, m_loadedTextures.size());
+                loadedTextures.insert(loadedTextures.end(), m_loadedTextures.begin(), m_loadedTextures.begin() + loadedCount);
+                m_loadedTextures.erase(m_loadedTextures.begin(), m_loadedTextures.begin() + loadedCount);
+            }
+            
+            LoadedTextureQueue::const_iterator it, end;
+            for (it = loadedTextures.begin(), end = loadedTextures.end(); it != end; ++it) {
+                const LoadedTexture& loaded = *it;
+                Texture* texture = m_textures[loaded.index];
+                texture->setBuffers(loaded.averageColor, loaded.buffers);
+                texture->prepare(m_textureIds[loaded.index], minFilter, magFilter);
+                ++count;
+            }
+            
+            return count;
         }
 
         void TextureCollection::setTextureMode(const int minFilter, const int magFilter) {
             for (size_t i = 0; i < m_textures.size(); ++i) {
                 Texture* texture = m_textures[i];
-                texture->setMode(minFilter, magFilter);
+                if (texture->isPrepared())
+                    texture->setMode(minFilter, magFilter);
             }
         }
+        
+        bool TextureCollection::cancelled() const {
+            wxMutexLocker lock(m_mutex);
+            return m_cancelled;
+        }
+
+        void TextureCollection::textureLoaded(const size_t index, const Color& averageColor, const TextureBuffer::List& buffers) {
+            assert(index < m_textures.size());
+            wxMutexLocker lock(m_mutex);
+            m_loadedTextures.push_back(LoadedTexture(index, averageColor, buffers));
+        }
+
+        void TextureCollection::loadTaskDone() {
+            wxMutexLocker lock(m_mutex);
+            assert(m_pendingLoadTasks > 0);
+            if (--m_pendingLoadTasks == 0)
+                m_loadTasksDone.Broadcast();
+        }
     }
 }
@@ -20,33 +20,92 @@
 #ifndef TrenchBroom_TextureCollection
 #define TrenchBroom_TextureCollection
 
+#include "Color.h"
 #include "StringUtils.h"
+#include "ThreadPool.h"
 #include "Assets/AssetTypes.h"
+#include "Assets/Texture.h"
 #include "Renderer/GL.h"
 
+#include <deque>
 #include <vector>
 
+#include <wx/thread.h>
+
 namespace TrenchBroom {
     namespace Assets {
         class TextureCollection {
+        public:
+            // Decodes the data of some placeholder textures of a collection on a worker thread.
+            class LoadTask : public ThreadPool::Task {
+            private:
+                TextureCollection* m_collection;
+                friend class TextureCollection;
+            public:
+                LoadTask();
+                virtual ~LoadTask();
+            protected:
+                bool cancelled() const;
+                void textureLoaded(size_t index, const Color& averageColor, const TextureBuffer::List& buffers);
+            private:
+                void doRun();
+                virtual void doLoad() = 0;
+            };
+            
+            typedef std::vector<LoadTask*> LoadTaskList;
         private:
             typedef std::vector<GLuint> TextureIdList;
             
+            struct LoadedTexture {
+                size_t index;
+                Color averageColor;
+                TextureBuffer::List buffers;
+                
+                LoadedTexture(size_t i_index, const Color& i_averageColor, const TextureBuffer::List& i_buffers);
+            };
+            typedef std::deque<LoadedTexture> LoadedTextureQueue;
+            
             bool m_loaded;
             String m_name;
             TextureList m_textures;
             TextureIdList m_textureIds;
+            size_t m_prepareIndex;
+            
+            LoadTaskList m_loadTasks;
+            bool m_loadingStarted;
+            
+            // guards the state below, which is shared with the worker threads
+            mutable wxMutex m_mutex;
+            wxCondition m_loadTasksDone;
+            size_t m_pendingLoadTasks;
+            bool m_cancelled;
+            LoadedTextureQueue m_loadedTextures;
         public:
             TextureCollection(const String& name);
             TextureCollection(const String& name, const TextureList& textures);
+            // The collection takes ownership of the given tasks, which fill in the data of its placeholder textures.
+            TextureCollection(const String& name, const TextureList& textures, const LoadTaskList& loadTasks);
             virtual ~TextureCollection();
 
             bool loaded() const;
             const String& name() const;
             const TextureList& textures() const;
 
+            void startLoading(ThreadPool& pool);
+            void waitUntilLoaded();
+            
+            bool prepared() const;
             void prepare(int minFilter, int magFilter);
+            // Uploads at most the given number of textures and returns the number of textures that were uploaded.
+            size_t prepare(int minFilter, int magFilter, size_t budget);
             void setTextureMode(int minFilter, int magFilter);
+        private:
+            bool cancelled() const;
+            void textureLoaded(size_t index, const Color& averageColor, const TextureBuffer::List& buffers);
+            void loadTaskDone();
+            
+            TextureCollection(const TextureCollection& other);
+            TextureCollection& operator=(const TextureCollection& other);
         };
     }
 }
@@ -51,7 +51,8 @@ namespace TrenchBroom {
         m_loader(NULL),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_loadPool() {}
         
         TextureManager::~TextureManager() {
             clear();
@@ -170,6 +171,10 @@ namespace TrenchBroom {
             MapUtils::clearAndDelete(m_toRemove);
         }
         
+        bool TextureManager::hasPendingChanges() const {
+            return m_resetTextureMode || !m_toPrepare.empty() || !m_toRemove.empty();
+        }
+        
         Texture* TextureManager::texture(const String& name) const {
             TextureMap::const_iterator it = m_texturesByName.find(StringUtils::toLower(name));
             if (it == m_texturesByName.end())
@@ -207,10 +212,11 @@ namespace TrenchBroom {
             const String& name = spec.name();
             if (collectionsByName.find(spec.name()) == collectionsByName.end()) {
                 TextureCollection* collection = loadTextureCollection(spec);
+                collection->startLoading(m_loadPool);
                 collections.push_back(collection);
                 collectionsByName.insert(std::make_pair(name, collection));
                 
-                m_toPrepare.insert(TextureCollectionMapEntry(name, collection));
+                m_toPrepare[name] = collection;
                 m_toRemove.erase(name);
                 
                 if (m_logger != NULL)
@@ -251,15 +257,24 @@ namespace TrenchBroom {
         }
         
         void TextureManager::prepare() {
-            TextureCollectionMap::const_iterator it, end;
-            for (it = m_toPrepare.begin(), end = m_toPrepare.end(); it != end; ++it) {
+            size_t budget = PrepareBudget;
+            
+            TextureCollectionMap::iterator it = m_toPrepare.begin();
+            while (it != m_toPrepare.end() && budget > 0) {
                 TextureCollection* collection = it->second;
-                collection->prepare(m_minFilter, m_magFilter);
+                budget -= collection->prepare(m_minFilter, m_magFilter, budget);
+                if (collection->prepared())
+                    m_toPrepare.erase(it++);
+                else
+                    ++it;
             }
-            m_toPrepare.clear();
         }
         
         void TextureManager::clearBuiltinTextureCollections() {
+            TextureCollectionMap::const_iterator it, end;
+            for (it = m_builtinCollectionsByName.begin(), end = m_builtinCollectionsByName.end(); it != end; ++it)
+                m_toPrepare.erase(it->first);
+            
             m_toRemove.insert(m_builtinCollectionsByName.begin(), m_builtinCollectionsByName.end());
             m_builtinCollections.clear();
             m_builtinCollectionsByName.clear();
@@ -269,6 +284,10 @@ namespace TrenchBroom {
         }
         
         void TextureManager::clearExternalTextureCollections() {
+            TextureCollectionMap::const_iterator it, end;
+            for (it = m_externalCollectionsByName.begin(), end = m_externalCollectionsByName.end(); it != end; ++it)
+                m_toPrepare.erase(it->first);
+            
             m_toRemove.insert(m_externalCollectionsByName.begin(), m_externalCollectionsByName.end());
             m_externalCollections.clear();
             m_externalCollectionsByName.clear();
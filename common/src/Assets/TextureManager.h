@@ -20,6 +20,7 @@
 #ifndef TrenchBroom_TextureManager
 #define TrenchBroom_TextureManager
 
+#include "ThreadPool.h"
 #include "Assets/AssetTypes.h"
 #include "IO/Path.h"
 #include "Model/ModelTypes.h"
@@ -51,6 +52,9 @@ namespace TrenchBroom {
             typedef std::pair<String, TextureCollection*> TextureCollectionMapEntry;
             typedef std::map<String, Texture*> TextureMap;
             
+            // the maximum number of textures uploaded per call to commitChanges
+            static const size_t PrepareBudget = 64;
+            
             Logger* m_logger;
             const IO::TextureLoader* m_loader;
             
@@ -72,6 +76,8 @@ namespace TrenchBroom {
             int m_minFilter;
             int m_magFilter;
             bool m_resetTextureMode;
+            
+            ThreadPool m_loadPool;
         public:
             TextureManager(Logger* logger, int minFilter, int magFilter);
             ~TextureManager();
@@ -87,6 +93,7 @@ namespace TrenchBroom {
             void setTextureMode(int minFilter, int magFilter);
             void setLoader(const IO::TextureLoader* loader);
             void commitChanges();
+            bool hasPendingChanges() const;
             
             Texture* texture(const String& name) const;
             const TextureList& textures(const SortOrder sortOrder) const;
@@ -243,6 +243,21 @@ public:
         
     }
     
+    // true unless this box lies entirely above one of the given planes, so the plane normals must point out of the
+    // volume bounded by the planes
+    bool intersects(const typename Plane<T,S>::List& planes) const {
+        for (size_t i = 0; i < planes.size(); ++i) {
+            // the corner of this box which is furthest below the plane
+            const Plane<T,S>& plane = planes[i];
+            Vec<T,S> corner;
+            for (size_t j = 0; j < S; ++j)
+                corner[j] = plane.normal[j] >= static_cast<T>(0.0) ? min[j] : max[j];
+            if (plane.pointDistance(corner) > static_cast<T>(0.0))
+                return false;
+        }
+        return true;
+    }
+    
     T intersectWithRay(const Ray<T,S>& ray, Vec<T,S>* sideNormal = NULL) const {
         const bool inside = contains(ray.origin);
         
@@ -0,0 +1,133 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ArchiveFileSystem.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace IO {
+        ArchiveFileSystem::Entry::Entry(const String& i_directory, const String& i_name, const size_t i_id, const bool i_file) :
+        directory(i_directory),
+        name(i_name),
+        id(i_id),
+        file(i_file) {}
+        
+        bool ArchiveFileSystem::Entry::operator<(const Entry& rhs) const {
+            const int cmp = directory.compare(rhs.directory);
+            if (cmp < 0)
+                return true;
+            if (cmp > 0)
+                return false;
+            return name < rhs.name;
+        }
+
+        ArchiveFileSystem::ArchiveFileSystem(const Path& path, MappedFile::Ptr file) :
+        m_path(path),
+        m_file(file) {}
+        
+        ArchiveFileSystem::~ArchiveFileSystem() {}
+
+        void ArchiveFileSystem::addFile(const Path& path, const size_t id) {
+            const String fileKey = key(path);
+            FileIndex::iterator it = m_files.find(fileKey);
+            if (it != m_files.end()) {
+                m_entries[it->second].id = id;
+            } else {
+                const Path directory = path.deleteLastComponent();
+                m_files.insert(std::make_pair(fileKey, m_entries.size()));
+                m_entries.push_back(Entry(key(directory), path.lastComponent().asString(), id, true));
+                addDirectory(directory);
+            }
+        }
+        
+        void ArchiveFileSystem::addDirectory(const Path& path) {
+            if (path.isEmpty())
+                return;
+            
+            const String directoryKey = key(path);
+            if (!m_directories.insert(std::make_pair(directoryKey, EntryRange(0, 0))).second)
+                return;
+            
+            const Path parent = path.deleteLastComponent();
+            m_entries.push_back(Entry(key(parent), path.lastComponent().asString(), 0, false));
+            addDirectory(parent);
+        }
+        
+        void ArchiveFileSystem::buildIndex() {
+            std::sort(m_entries.begin(), m_entries.end());
+            
+            m_files.clear();
+            m_directories[""] = EntryRange(0, 0);
+            
+            size_t first = 0;
+            for (size_t i = 0; i < m_entries.size(); ++i) {
+                const Entry& entry = m_entries[i];
+                if (entry.file)
+                    m_files[entry.directory.empty() ? entry.name : entry.directory + "/" + entry.name] = i;
+                if (i + 1 == m_entries.size() || m_entries[i + 1].directory != entry.directory) {
+                    m_directories[entry.directory] = EntryRange(first, i + 1);
+                    first = i + 1;
+                }
+            }
+        }
+        
+        bool ArchiveFileSystem::findFile(const Path& path, size_t& id) const {
+            FileIndex::const_iterator it = m_files.find(key(path.makeLowerCase()));
+            if (it == m_files.end())
+                return false;
+            id = m_entries[it->second].id;
+            return true;
+        }
+
+        String ArchiveFileSystem::key(const Path& path) {
+            return path.asString('/');
+        }
+        
+        bool ArchiveFileSystem::doDirectoryExists(const Path& path) const {
+            return m_directories.count(key(path.makeLowerCase())) > 0;
+        }
+        
+        bool ArchiveFileSystem::doFileExists(const Path& path) const {
+            return m_files.count(key(path.makeLowerCase())) > 0;
+        }
+        
+        Path::List ArchiveFileSystem::doGetDirectoryContents(const Path& path) const {
+            DirectoryIndex::const_iterator it = m_directories.find(key(path.makeLowerCase()));
+            if (it == m_directories.end())
+                throw FileSystemException("Path does not exist: '" + (m_path + path).asString() + "'");
+            
+            const EntryRange& range = it->second;
+            Path::List contents;
+            contents.reserve(range.second - range.first);
+            for (size_t i = range.first; i < range.second; ++i)
+                contents.push_back(Path(m_entries[i].name));
+            return contents;
+        }
+        
+        const MappedFile::Ptr ArchiveFileSystem::doOpenFile(const Path& path) const {
+            size_t id;
+            if (!findFile(path, id))
+                throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
+            return doOpenEntry(id);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_ArchiveFileSystem
+#define TrenchBroom_ArchiveFileSystem
+
+#include "StringUtils.h"
+#include "UnorderedMap.h"
+#include "IO/FileSystem.h"
+#include "IO/Path.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /*
+         Base class for read only file systems backed by a single archive file. The directory of the archive is kept
+         in a single array of entries sorted by parent directory and name, so that the contents of a directory are a
+         contiguous range. Files and directories are found by their lower case path in two hash maps. Subclasses read
+         the archive directory, register each file with an id of their choosing and open the file for that id.
+         */
+        class ArchiveFileSystem : public FileSystem {
+        private:
+            struct Entry {
+                String directory;
+                String name;
+                size_t id;
+                bool file;
+                
+                Entry(const String& i_directory, const String& i_name, size_t i_id, bool i_file);
+                bool operator<(const Entry& rhs) const;
+            };
+            
+            typedef std::vector<Entry> EntryList;
+            typedef std::pair<size_t, size_t> EntryRange;
+            typedef std::tr1::unordered_map<String, size_t> FileIndex;
+            typedef std::tr1::unordered_map<String, EntryRange> DirectoryIndex;
+            
+            EntryList m_entries;
+            FileIndex m_files;
+            DirectoryIndex m_directories;
+        protected:
+            Path m_path;
+            MappedFile::Ptr m_file;
+        public:
+            ArchiveFileSystem(const Path& path, MappedFile::Ptr file);
+            virtual ~ArchiveFileSystem();
+        protected:
+            // a later file with the same path replaces the earlier one
+            void addFile(const Path& path, size_t id);
+            void addDirectory(const Path& path);
+            void buildIndex();
+            
+            bool findFile(const Path& path, size_t& id) const;
+        private:
+            static String key(const Path& path);
+            
+            bool doDirectoryExists(const Path& path) const;
+            bool doFileExists(const Path& path) const;
+            
+            Path::List doGetDirectoryContents(const Path& path) const;
+            const MappedFile::Ptr doOpenFile(const Path& path) const;
+            
+            virtual const MappedFile::Ptr doOpenEntry(size_t id) const = 0;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_ArchiveFileSystem) */
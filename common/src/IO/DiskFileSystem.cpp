@@ -146,6 +146,15 @@ namespace TrenchBroom {
 #endif
             }
             
+            time_t modificationTime(const Path& path) {
+                if (!path.isAbsolute())
+                    throw FileSystemException("Cannot handle relative path: '" + path.asString() + "'");
+                const time_t time = ::wxFileModificationTime(path.asString());
+                if (time == static_cast<time_t>(-1))
+                    throw FileSystemException("Cannot get modification time of file: '" + path.asString() + "'");
+                return time;
+            }
+            
             Path getCurrentWorkingDir() {
                 return Path(::wxGetCwd().ToStdString());
             }
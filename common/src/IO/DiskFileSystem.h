@@ -24,6 +24,8 @@
 #include "IO/FileSystem.h"
 #include "IO/Path.h"
 
+#include <ctime>
+
 namespace TrenchBroom {
     namespace IO {
         namespace Disk {
@@ -36,6 +38,7 @@ namespace TrenchBroom {
             
             Path::List getDirectoryContents(const Path& path);
             MappedFile::Ptr openFile(const Path& path);
+            time_t modificationTime(const Path& path);
             Path getCurrentWorkingDir();
             
             IO::Path resolvePath(const Path::List& searchPaths, const Path& path);
@@ -98,6 +98,12 @@ namespace TrenchBroom {
             }
         }
         
+        void FileSystem::preloadFiles(const Path::List& paths) const {
+            doPreloadFiles(paths);
+        }
+
+        void FileSystem::doPreloadFiles(const Path::List& paths) const {}
+        
         WritableFileSystem::~WritableFileSystem() {}
         
         void WritableFileSystem::createDirectory(const Path& path) {
@@ -72,6 +72,10 @@ namespace TrenchBroom {
             
             Path::List getDirectoryContents(const Path& path) const;
             const MappedFile::Ptr openFile(const Path& path) const;
+            
+            // Gives the file system a chance to prepare the given files before they are opened, e.g. to decompress
+            // them in parallel. Paths which do not denote files are ignored.
+            void preloadFiles(const Path::List& paths) const;
         private:
             template <class Matcher>
             void doFindItems(const Path& searchPath, const Matcher& matcher, const bool recurse, Path::List& result) const {
@@ -93,6 +97,7 @@ namespace TrenchBroom {
             virtual Path::List doGetDirectoryContents(const Path& path) const = 0;
 
             virtual const MappedFile::Ptr doOpenFile(const Path& path) const = 0;
+            virtual void doPreloadFiles(const Path::List& paths) const;
         };
         
         class WritableFileSystem {
@@ -23,9 +23,36 @@
 #include "StringUtils.h"
 #include "DiskFileSystem.h"
 #include "PakFileSystem.h"
+#include "ZipFileSystem.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
 
 namespace TrenchBroom {
     namespace IO {
+        // Splits the name of a pak file into its prefix and the number at its end, e.g. "pak10" into "pak" and 10.
+        static void splitPakName(const Path& path, String& prefix, size_t& number) {
+            const String name = StringUtils::toLower(path.deleteExtension().asString());
+            const size_t digits = name.find_last_not_of("0123456789") + 1;
+            prefix = name.substr(0, digits);
+            number = digits < name.size() ? static_cast<size_t>(std::atol(name.c_str() + digits)) : 0;
+        }
+        
+        // Quake and Quake 2 load pak files in the order of their numbers, so pak2 comes before pak10.
+        static bool comparePakPaths(const Path& lhs, const Path& rhs) {
+            String lhsPrefix, rhsPrefix;
+            size_t lhsNumber, rhsNumber;
+            splitPakName(lhs, lhsPrefix, lhsNumber);
+            splitPakName(rhs, rhsPrefix, rhsNumber);
+            
+            if (lhsPrefix != rhsPrefix)
+                return lhsPrefix < rhsPrefix;
+            if (lhsNumber != rhsNumber)
+                return lhsNumber < rhsNumber;
+            return lhs < rhs;
+        }
+        
         GameFileSystem::GameFileSystem(const String& pakExtension, const Path& gamePath, const Path& searchPath, const Path::List& additionalSearchPaths) {
             if (!gamePath.isEmpty()) {
                 addFileSystem(pakExtension, gamePath + searchPath);
@@ -39,13 +66,25 @@ namespace TrenchBroom {
         void GameFileSystem::addFileSystem(const String& pakExtension, const Path& path) {
             if (Disk::directoryExists(path)) {
                 FSPtr diskFS(new DiskFileSystem(path));
-                if (StringUtils::caseInsensitiveEqual(pakExtension, "pak")) {
-                    const Path::List paks = diskFS->findItems(Path(""), FileSystem::ExtensionMatcher(pakExtension));
+                const bool pak = StringUtils::caseInsensitiveEqual(pakExtension, "pak");
+                const bool zip = (StringUtils::caseInsensitiveEqual(pakExtension, "pk3") ||
+                                  StringUtils::caseInsensitiveEqual(pakExtension, "zip"));
+                if (pak || zip) {
+                    Path::List paks = diskFS->findItems(Path(""), FileSystem::ExtensionMatcher(pakExtension));
+                    // idTech3 engines load pk3 files in alphabetical order
+                    if (pak)
+                        std::sort(paks.begin(), paks.end(), comparePakPaths);
+                    else
+                        std::sort(paks.begin(), paks.end());
+                    
                     Path::List::const_iterator it, end;
                     for (it = paks.begin(), end = paks.end(); it != end; ++it) {
                         MappedFile::Ptr file = diskFS->openFile(*it);
                         assert(file != NULL);
-                        m_fileSystems.push_back(FSPtr(new PakFileSystem(path, file)));
+                        if (pak)
+                            m_fileSystems.push_back(FSPtr(new PakFileSystem(path + *it, file)));
+                        else
+                            m_fileSystems.push_back(FSPtr(new ZipFileSystem(path + *it, file)));
                     }
                 } else {
                     throw FileSystemException("Unknown file extension: '" + pakExtension + "'");
@@ -101,5 +140,28 @@ namespace TrenchBroom {
             }
             return MappedFile::Ptr();
         }
+        
+        void GameFileSystem::doPreloadFiles(const Path::List& paths) const {
+            // each file is preloaded by the file system it would be opened from
+            typedef std::map<FileSystem*, Path::List> PathMap;
+            PathMap pathMap;
+            
+            Path::List::const_iterator pIt, pEnd;
+            for (pIt = paths.begin(), pEnd = paths.end(); pIt != pEnd; ++pIt) {
+                const Path& path = *pIt;
+                FileSystemList::const_reverse_iterator fIt, fEnd;
+                for (fIt = m_fileSystems.rbegin(), fEnd = m_fileSystems.rend(); fIt != fEnd; ++fIt) {
+                    const FSPtr fileSystem = *fIt;
+                    if (fileSystem->fileExists(path)) {
+                        pathMap[fileSystem.get()].push_back(path);
+                        break;
+                    }
+                }
+            }
+            
+            PathMap::const_iterator mIt, mEnd;
+            for (mIt = pathMap.begin(), mEnd = pathMap.end(); mIt != mEnd; ++mIt)
+                mIt->first->preloadFiles(mIt->second);
+        }
     }
 }
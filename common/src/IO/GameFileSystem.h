@@ -46,6 +46,7 @@ namespace TrenchBroom {
             
             Path::List doGetDirectoryContents(const Path& path) const;
             const MappedFile::Ptr doOpenFile(const Path& path) const;
+            void doPreloadFiles(const Path::List& paths) const;
         };
     }
 }
@@ -25,6 +25,10 @@
 
 namespace TrenchBroom {
     namespace IO {
+        void ImageLoader::initialize() {
+            ImageLoaderImpl::initialize();
+        }
+        
         ImageLoader::ImageLoader(const Format format, const Path& path) :
         m_impl(new ImageLoaderImpl(format, path)) {}
         
@@ -41,6 +41,10 @@ namespace TrenchBroom {
             // we're using the PIMPL idiom here to insulate the clients from the FreeImage headers
             ImageLoaderImpl* m_impl;
         public:
+            // Initializes the image library. Must be called on the main thread before images are loaded on worker
+            // threads, since the initialization is not thread safe.
+            static void initialize();
+            
             ImageLoader(const Format format, const Path& path);
             ImageLoader(const Format format, const char* begin, const char* end);
             ~ImageLoader();
@@ -63,8 +63,9 @@ namespace TrenchBroom {
             const Buffer<unsigned char>& palette() const;
             const Buffer<unsigned char>& indices() const;
             const Buffer<unsigned char>& pixels(const ImageLoader::PixelFormat format) const;
+            
+            static void initialize();
         private:
-            void initialize();
             void initializeIndexedPixels(const size_t pSize) const;
             void initializePixels(const size_t pSize) const;
             static FREE_IMAGE_FORMAT translateFormat(const ImageLoader::Format format);
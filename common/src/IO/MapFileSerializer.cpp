@@ -19,187 +19,115 @@
 
 #include "MapFileSerializer.h"
 #include "Exceptions.h"
+#include "StringUtils.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/Path.h"
 #include "Model/BrushFace.h"
 
+#include <cstring>
+
 namespace TrenchBroom {
     namespace IO {
         class StandardFileSerializer : public MapFileSerializer {
         private:
             bool m_longFormat;
-            String FaceFormat;
         public:
             StandardFileSerializer(FILE* stream, const bool longFormat) :
             MapFileSerializer(stream),
-            m_longFormat(longFormat) {
-                StringStream str;
-                str <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "%s %.6g %.6g %.6g %.6g %.6g";
-                if (m_longFormat)
-                    str << " %d %d %.6g";
-                FaceFormat = str.str();
-            }
+            m_longFormat(longFormat) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) {
+            size_t doWriteBrushFace(Model::BrushFace* face) {
                 const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
-                const Model::BrushFace::Points& points = face->points();
+                
+                writeFacePoints(face);
+                write(textureName);
+                write(" ");
+                write(face->xOffset(), TexturePrecision);
+                write(" ");
+                write(face->yOffset(), TexturePrecision);
+                write(" ");
+                write(face->rotation(), TexturePrecision);
+                write(" ");
+                write(face->xScale(), TexturePrecision);
+                write(" ");
+                write(face->yScale(), TexturePrecision);
                 
                 if (m_longFormat) {
-                    std::fprintf(stream, FaceFormat.c_str(),
-                                 points[0].x(),
-                                 points[0].y(),
-                                 points[0].z(),
-                                 points[1].x(),
-                                 points[1].y(),
-                                 points[1].z(),
-                                 points[2].x(),
-                                 points[2].y(),
-                                 points[2].z(),
-                                 textureName.c_str(),
-                                 face->xOffset(),
-                                 face->yOffset(),
-                                 face->rotation(),
-                                 face->xScale(),
-                                 face->yScale(),
-                                 face->surfaceContents(),
-                                 face->surfaceFlags(),
-                                 face->surfaceValue());
-                } else {
-                    std::fprintf(stream, FaceFormat.c_str(),
-                                 points[0].x(),
-                                 points[0].y(),
-                                 points[0].z(),
-                                 points[1].x(),
-                                 points[1].y(),
-                                 points[1].z(),
-                                 points[2].x(),
-                                 points[2].y(),
-                                 points[2].z(),
-                                 textureName.c_str(),
-                                 face->xOffset(),
-                                 face->yOffset(),
-                                 face->rotation(),
-                                 face->xScale(),
-                                 face->yScale());
+                    write(" ");
+                    write(face->surfaceContents());
+                    write(" ");
+                    write(face->surfaceFlags());
+                    write(" ");
+                    write(face->surfaceValue(), TexturePrecision);
                 }
-                std::fprintf(stream, "\n");
+                write("\n");
                 return 1;
             }
         };
         
         class Hexen2FileSerializer : public MapFileSerializer {
-        private:
-            String FaceFormat;
         public:
             Hexen2FileSerializer(FILE* stream) :
-            MapFileSerializer(stream) {
-                StringStream str;
-                str <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "%s %.6g %.6g %.6g %.6g %.6g 0\n"; // the extra value is written here
-                
-                FaceFormat = str.str();
-            }
+            MapFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) {
+            size_t doWriteBrushFace(Model::BrushFace* face) {
                 const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
-                const Model::BrushFace::Points& points = face->points();
                 
-                std::fprintf(stream, FaceFormat.c_str(),
-                             points[0].x(),
-                             points[0].y(),
-                             points[0].z(),
-                             points[1].x(),
-                             points[1].y(),
-                             points[1].z(),
-                             points[2].x(),
-                             points[2].y(),
-                             points[2].z(),
-                             textureName.c_str(),
-                             face->xOffset(),
-                             face->yOffset(),
-                             face->rotation(),
-                             face->xScale(),
-                             face->yScale());
+                writeFacePoints(face);
+                write(textureName);
+                write(" ");
+                write(face->xOffset(), TexturePrecision);
+                write(" ");
+                write(face->yOffset(), TexturePrecision);
+                write(" ");
+                write(face->rotation(), TexturePrecision);
+                write(" ");
+                write(face->xScale(), TexturePrecision);
+                write(" ");
+                write(face->yScale(), TexturePrecision);
+                write(" 0\n"); // the extra value is written here
                 return 1;
             }
         };
         
         class ValveFileSerializer : public MapFileSerializer {
-        private:
-            String FaceFormat;
         public:
             ValveFileSerializer(FILE* stream) :
-            MapFileSerializer(stream) {
-                StringStream str;
-                str <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "%s " <<
-                "[ %.6g %.6g %.6g %.6g ] " <<
-                "[ %.6g %.6g %.6g %.6g ] " <<
-                "%.6g %.6g %.6g\n";
-                
-                FaceFormat = str.str();
-            }
+            MapFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) {
+            size_t doWriteBrushFace(Model::BrushFace* face) {
                 const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
                 const Vec3 xAxis = face->textureXAxis();
                 const Vec3 yAxis = face->textureYAxis();
-                const Model::BrushFace::Points& points = face->points();
                 
-                std::fprintf(stream, FaceFormat.c_str(),
-                             points[0].x(),
-                             points[0].y(),
-                             points[0].z(),
-                             points[1].x(),
-                             points[1].y(),
-                             points[1].z(),
-                             points[2].x(),
-                             points[2].y(),
-                             points[2].z(),
-                             
-                             textureName.c_str(),
-                             
-                             xAxis.x(),
-                             xAxis.y(),
-                             xAxis.z(),
-                             face->xOffset(),
-                             
-                             yAxis.x(),
-                             yAxis.y(),
-                             yAxis.z(),
-                             face->yOffset(),
-                             
-                             face->rotation(),
-                             face->xScale(),
-                             face->yScale());
+                writeFacePoints(face);
+                write(textureName);
+                
+                write(" [ ");
+                write(xAxis.x(), TexturePrecision);
+                write(" ");
+                write(xAxis.y(), TexturePrecision);
+                write(" ");
+                write(xAxis.z(), TexturePrecision);
+                write(" ");
+                write(face->xOffset(), TexturePrecision);
+                
+                write(" ] [ ");
+                write(yAxis.x(), TexturePrecision);
+                write(" ");
+                write(yAxis.y(), TexturePrecision);
+                write(" ");
+                write(yAxis.z(), TexturePrecision);
+                write(" ");
+                write(face->yOffset(), TexturePrecision);
+                
+                write(" ] ");
+                write(face->rotation(), TexturePrecision);
+                write(" ");
+                write(face->xScale(), TexturePrecision);
+                write(" ");
+                write(face->yScale(), TexturePrecision);
+                write("\n");
                 return 1;
             }
         };
@@ -222,39 +150,94 @@ namespace TrenchBroom {
         
         MapFileSerializer::MapFileSerializer(FILE* stream) :
         m_line(1),
-        m_stream(stream) {}
+        m_stream(stream) {
+            m_buffer.reserve(BufferSize + 1024);
+        }
+        
+        MapFileSerializer::~MapFileSerializer() {
+            flush();
+        }
+        
+        void MapFileSerializer::write(const char* str) {
+            m_buffer.insert(m_buffer.end(), str, str + std::strlen(str));
+        }
+        
+        void MapFileSerializer::write(const String& str) {
+            m_buffer.insert(m_buffer.end(), str.begin(), str.end());
+        }
+        
+        void MapFileSerializer::write(const int value) {
+            // %d never needs more characters than this
+            char str[16];
+            const size_t length = static_cast<size_t>(std::sprintf(str, "%d", value));
+            m_buffer.insert(m_buffer.end(), str, str + length);
+        }
+        
+        void MapFileSerializer::write(const double value, const int precision) {
+            char str[StringUtils::FormatFloatBufferSize];
+            const size_t length = StringUtils::formatFloat(str, value, precision);
+            m_buffer.insert(m_buffer.end(), str, str + length);
+        }
+        
+        void MapFileSerializer::writeFacePoints(const Model::BrushFace* face) {
+            const Model::BrushFace::Points& points = face->points();
+            for (size_t i = 0; i < 3; ++i) {
+                write("( ");
+                write(points[i].x(), FloatPrecision);
+                write(" ");
+                write(points[i].y(), FloatPrecision);
+                write(" ");
+                write(points[i].z(), FloatPrecision);
+                write(" ) ");
+            }
+        }
+        
+        void MapFileSerializer::flush() {
+            if (!m_buffer.empty()) {
+                std::fwrite(&m_buffer[0], 1, m_buffer.size(), m_stream);
+                m_buffer.clear();
+            }
+        }
         
         void MapFileSerializer::doBeginEntity(const Model::Node* node) {
             m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
+            write("{\n");
             ++m_line;
         }
         
         void MapFileSerializer::doEndEntity(Model::Node* node) {
-            std::fprintf(m_stream, "}\n");
+            write("}\n");
             ++m_line;
             setFilePosition(node);
+            if (m_buffer.size() >= BufferSize)
+                flush();
         }
         
         void MapFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) { 
-            std::fprintf(m_stream, "\"%s\" \"%s\"\n", attribute.name().c_str(), attribute.value().c_str());
+            write("\"");
+            write(attribute.name());
+            write("\" \"");
+            write(attribute.value());
+            write("\"\n");
             ++m_line;
         }
         
         void MapFileSerializer::doBeginBrush(const Model::Brush* brush) {
             m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
+            write("{\n");
             ++m_line;
         }
         
         void MapFileSerializer::doEndBrush(Model::Brush* brush) {
-            std::fprintf(m_stream, "}\n");
+            write("}\n");
             ++m_line;
             setFilePosition(brush);
+            if (m_buffer.size() >= BufferSize)
+                flush();
         }
         
         void MapFileSerializer::doBrushFace(Model::BrushFace* face) {
-            const size_t lines = doWriteBrushFace(m_stream, face);
+            const size_t lines = doWriteBrushFace(face);
             face->setFilePosition(m_line, lines);
             m_line += lines;
         }
@@ -26,6 +26,7 @@
 #include "Model/Node.h"
 
 #include <cstdio>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -34,13 +35,30 @@ namespace TrenchBroom {
         class MapFileSerializer : public NodeSerializer {
         private:
             typedef std::vector<size_t> LineStack;
+            typedef std::vector<char> Buffer;
+            static const size_t BufferSize = 64 * 1024;
+        protected:
+            static const int TexturePrecision = 6;
+        private:
+            
             LineStack m_startLineStack;
             size_t m_line;
             FILE* m_stream;
+            Buffer m_buffer;
         public:
             static Ptr create(Model::MapFormat::Type format, FILE* stream);
+            virtual ~MapFileSerializer();
         protected:
             MapFileSerializer(FILE* file);
+            
+            // everything is formatted into a buffer which is written to the stream in large chunks
+            void write(const char* str);
+            void write(const String& str);
+            void write(int value);
+            void write(double value, int precision);
+            void writeFacePoints(const Model::BrushFace* face);
+        private:
+            void flush();
         private:
             void doBeginEntity(const Model::Node* node);
             void doEndEntity(Model::Node* node);
@@ -52,7 +70,7 @@ namespace TrenchBroom {
             void setFilePosition(Model::Node* node);
             size_t startLine();
         private:
-            virtual size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) = 0;
+            virtual size_t doWriteBrushFace(Model::BrushFace* face) = 0;
         };
     }
 }
@@ -71,5 +71,13 @@ namespace TrenchBroom {
         void MapParser::brushFace(size_t line, const Vec3& point1, const Vec3& point2, const Vec3& point3, const Model::BrushFaceAttributes& attribs, const Vec3& texAxisX, const Vec3& texAxisY) {
             onBrushFace(line, point1, point2, point3, attribs, texAxisX, texAxisY);
         }
+
+        bool MapParser::preparsedBrushes(const char* position, const char*& end, size_t& endLine) {
+            return onPreparsedBrushes(position, end, endLine);
+        }
+        
+        bool MapParser::onPreparsedBrushes(const char* position, const char*& end, size_t& endLine) {
+            return false;
+        }
     }
 }
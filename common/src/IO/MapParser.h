@@ -75,6 +75,7 @@ namespace TrenchBroom {
             void beginBrush(size_t line);
             void endBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes);
             void brushFace(size_t line, const Vec3& point1, const Vec3& point2, const Vec3& point3, const Model::BrushFaceAttributes& attribs, const Vec3& texAxisX, const Vec3& texAxisY);
+            bool preparsedBrushes(const char* position, const char*& end, size_t& endLine);
         private: // subclassing interface for users of the parser
             virtual void onFormatSet(Model::MapFormat::Type format) = 0;
             virtual void onBeginEntity(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes) = 0;
@@ -82,6 +83,10 @@ namespace TrenchBroom {
             virtual void onBeginBrush(size_t line) = 0;
             virtual void onEndBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes) = 0;
             virtual void onBrushFace(size_t line, const Vec3& point1, const Vec3& point2, const Vec3& point3, const Model::BrushFaceAttributes& attribs, const Vec3& texAxisX, const Vec3& texAxisY) = 0;
+            
+            // if the brushes starting at the given position were already parsed elsewhere, report them and return
+            // the beginning of the line following the last of them in end and endLine
+            virtual bool onPreparsedBrushes(const char* position, const char*& end, size_t& endLine);
         };
     }
 }
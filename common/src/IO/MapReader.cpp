@@ -21,6 +21,7 @@
 
 #include "CollectionUtils.h"
 #include "Logger.h"
+#include "ThreadPool.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/Entity.h"
@@ -29,8 +30,342 @@
 #include "Model/Layer.h"
 #include "Model/ModelFactory.h"
 
+#include <algorithm>
+
+#include <wx/string.h>
+
 namespace TrenchBroom {
     namespace IO {
+        class MapReader::BrushRun : public Logger, public ThreadPool::Task {
+        public:
+            struct Event {
+                typedef enum {
+                    Type_Brush,
+                    Type_Log,
+                    Type_ParserError,
+                    Type_GeometryError
+                } Type;
+                
+                Type type;
+                size_t line;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+                Model::Brush* brush;
+                LogLevel level;
+                String message;
+                
+                Event(const Type i_type) :
+                type(i_type),
+                line(0),
+                lineCount(0),
+                brush(NULL),
+                level(LogLevel_Debug) {}
+            };
+            
+            typedef std::vector<Event> EventList;
+        private:
+            const char* m_begin;
+            const char* m_position;
+            size_t m_line;
+            const char* m_end;
+            size_t m_endLine;
+            
+            Model::MapFormat::Type m_format;
+            BBox3 m_worldBounds;
+            const Model::ModelFactory* m_factory;
+            EventList m_events;
+        public:
+            BrushRun(const char* begin, const char* position, const size_t line) :
+            m_begin(begin),
+            m_position(position),
+            m_line(line),
+            m_end(NULL),
+            m_endLine(0),
+            m_format(Model::MapFormat::Unknown),
+            m_factory(NULL) {}
+            
+            ~BrushRun() {
+                EventList::const_iterator it, end;
+                for (it = m_events.begin(), end = m_events.end(); it != end; ++it)
+                    delete it->brush;
+            }
+            
+            const char* position() const {
+                return m_position;
+            }
+            
+            const char* end() const {
+                return m_end;
+            }
+            
+            size_t endLine() const {
+                return m_endLine;
+            }
+            
+            size_t size() const {
+                assert(m_end != NULL);
+                return static_cast<size_t>(m_end - m_begin);
+            }
+            
+            void extend(const char* end, const size_t endLine) {
+                assert(end > m_begin);
+                m_end = end;
+                m_endLine = endLine;
+            }
+            
+            void prepare(const Model::MapFormat::Type format, const BBox3& worldBounds, const Model::ModelFactory* factory) {
+                assert(factory != NULL);
+                m_format = format;
+                m_worldBounds = worldBounds;
+                m_factory = factory;
+            }
+            
+            EventList& events() {
+                return m_events;
+            }
+            
+            void brush(Model::Brush* brush, const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes) {
+                Event event(Event::Type_Brush);
+                event.brush = brush;
+                event.line = startLine;
+                event.lineCount = lineCount;
+                event.extraAttributes = extraAttributes;
+                m_events.push_back(event);
+            }
+            
+            void parseError(const Event::Type type, const String& message) {
+                Event event(type);
+                event.message = message;
+                m_events.push_back(event);
+            }
+        private:
+            void doRun();
+            
+            void doLog(const LogLevel level, const String& message) {
+                Event event(Event::Type_Log);
+                event.level = level;
+                event.message = message;
+                m_events.push_back(event);
+            }
+            
+            void doLog(const LogLevel level, const wxString& message) {
+                doLog(level, message.ToStdString());
+            }
+        };
+        
+        class MapReader::BrushRunParser : public StandardMapParser {
+        private:
+            BrushRun& m_run;
+            const BBox3& m_worldBounds;
+            const Model::ModelFactory* m_factory;
+            Model::BrushFaceList m_faces;
+        public:
+            BrushRunParser(BrushRun& run, const char* begin, const char* end, const size_t firstLine, const BBox3& worldBounds, const Model::ModelFactory* factory) :
+            StandardMapParser(begin, end, &run, firstLine),
+            m_run(run),
+            m_worldBounds(worldBounds),
+            m_factory(factory) {}
+            
+            ~BrushRunParser() {
+                VectorUtils::clearAndDelete(m_faces);
+            }
+            
+            void parse(const Model::MapFormat::Type format) {
+                parseBrushes(format);
+            }
+        private:
+            void onFormatSet(const Model::MapFormat::Type format) {}
+            void onBeginEntity(const size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes) {}
+            void onEndEntity(const size_t startLine, const size_t lineCount) {}
+            
+            void onBeginBrush(const size_t line) {
+                assert(m_faces.empty());
+            }
+            
+            // same as MapReader::createBrush
+            void onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes) {
+                try {
+                    Model::BrushFace::sortFaces(m_faces);
+                    Model::Brush* brush = m_factory->createBrush(m_worldBounds, m_faces);
+                    m_faces.clear();
+                    m_run.brush(brush, startLine, lineCount, extraAttributes);
+                } catch (GeometryException& e) {
+                    m_run.error("Error parsing brush at line %u: %s", static_cast<unsigned int>(startLine), e.what());
+                    m_faces.clear(); // the faces will have been deleted by the brush's constructor
+                }
+            }
+            
+            void onBrushFace(const size_t line, const Vec3& point1, const Vec3& point2, const Vec3& point3, const Model::BrushFaceAttributes& attribs, const Vec3& texAxisX, const Vec3& texAxisY) {
+                m_faces.push_back(m_factory->createFace(point1, point2, point3, attribs, texAxisX, texAxisY));
+            }
+        };
+        
+        void MapReader::BrushRun::doRun() {
+            try {
+                BrushRunParser parser(*this, m_begin, m_end, m_line, m_worldBounds, m_factory);
+                parser.parse(m_format);
+            } catch (const ParserException& e) {
+                parseError(Event::Type_ParserError, e.what());
+            } catch (const GeometryException& e) {
+                parseError(Event::Type_GeometryError, e.what());
+            } catch (const std::exception& e) {
+                // the thread pool swallows any exception, so every error must be recorded here
+                parseError(Event::Type_ParserError, e.what());
+            } catch (...) {
+                parseError(Event::Type_ParserError, "Unknown error");
+            }
+        }
+        
+        /*
+         Finds runs of consecutive brushes within the entities of a map file without tokenizing it. This relies on the
+         line structure of map files as they are written by editors: braces are on lines of their own, entity
+         attributes and brush faces take up one line each (with the exception of quoted values that contain line
+         breaks). If the file does not adhere to this, the scan fails and the map is parsed sequentially.
+         */
+        class MapReader::BrushRunScanner {
+        private:
+            const char* m_end;
+            const char* m_cur;
+            size_t m_line;
+            
+            size_t m_targetSize;
+            BrushRunList& m_runs;
+            bool m_success;
+        public:
+            BrushRunScanner(const char* begin, const char* end, const size_t targetSize, BrushRunList& runs) :
+            m_end(end),
+            m_cur(begin),
+            m_line(1),
+            m_targetSize(targetSize),
+            m_runs(runs),
+            m_success(false) {
+                assert(m_runs.empty());
+                m_success = scan();
+                if (!m_success)
+                    VectorUtils::clearAndDelete(m_runs);
+            }
+            
+            bool success() const {
+                return m_success;
+            }
+        private:
+            bool scan() {
+                size_t depth = 0;
+                BrushRun* run = NULL;
+                const char* brushBegin = NULL;
+                const char* brushPosition = NULL;
+                size_t brushLine = 0;
+                
+                while (m_cur < m_end) {
+                    const char* lineBegin = m_cur;
+                    const size_t line = m_line;
+                    
+                    while (m_cur < m_end && (*m_cur == ' ' || *m_cur == '\t' || *m_cur == '\r'))
+                        ++m_cur;
+                    if (m_cur == m_end)
+                        break;
+                    
+                    switch (*m_cur) {
+                        case '\n':
+                            ++m_cur;
+                            ++m_line;
+                            break;
+                        case '/':
+                            if (m_cur + 1 == m_end || *(m_cur + 1) != '/')
+                                return false;
+                            // comments on the entity level can carry extra attributes for the entity
+                            if (depth == 1)
+                                run = NULL;
+                            skipLine();
+                            break;
+                        case '(':
+                            if (depth != 2)
+                                return false;
+                            skipLine();
+                            break;
+                        case '"':
+                            if (depth != 1 || !skipQuotedStrings())
+                                return false;
+                            run = NULL;
+                            break;
+                        case '{':
+                            if (depth == 2)
+                                return false;
+                            if (depth == 1) {
+                                brushBegin = lineBegin;
+                                brushPosition = m_cur;
+                                brushLine = line;
+                            }
+                            ++depth;
+                            ++m_cur;
+                            if (!skipBlank())
+                                return false;
+                            break;
+                        case '}':
+                            if (depth == 0)
+                                return false;
+                            ++m_cur;
+                            if (!skipBlank())
+                                return false;
+                            if (depth == 2) {
+                                if (run == NULL || run->size() >= m_targetSize) {
+                                    run = new BrushRun(brushBegin, brushPosition, brushLine);
+                                    m_runs.push_back(run);
+                                }
+                                run->extend(m_cur, m_line);
+                            } else {
+                                run = NULL;
+                            }
+                            --depth;
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+                return depth == 0;
+            }
+            
+            void skipLine() {
+                while (m_cur < m_end && *m_cur != '\n')
+                    ++m_cur;
+                if (m_cur < m_end) {
+                    ++m_cur;
+                    ++m_line;
+                }
+            }
+            
+            bool skipBlank() {
+                while (m_cur < m_end && *m_cur != '\n') {
+                    if (*m_cur != ' ' && *m_cur != '\t' && *m_cur != '\r')
+                        return false;
+                    ++m_cur;
+                }
+                if (m_cur < m_end) {
+                    ++m_cur;
+                    ++m_line;
+                }
+                return true;
+            }
+            
+            bool skipQuotedStrings() {
+                bool quoted = false;
+                while (m_cur < m_end && (quoted || *m_cur != '\n')) {
+                    if (*m_cur == '"')
+                        quoted = !quoted;
+                    else if (*m_cur == '\n')
+                        ++m_line;
+                    ++m_cur;
+                }
+                if (quoted)
+                    return false;
+                if (m_cur < m_end) {
+                    ++m_cur;
+                    ++m_line;
+                }
+                return true;
+            }
+        };
+
         MapReader::ParentInfo MapReader::ParentInfo::layer(const Model::IdType layerId) {
             return ParentInfo(Type_Layer, layerId);
         }
@@ -57,22 +392,37 @@ namespace TrenchBroom {
 
         MapReader::MapReader(const char* begin, const char* end, Logger* logger) :
         StandardMapParser(begin, end, logger),
+        m_begin(begin),
+        m_end(end),
+        m_threadCount(1),
         m_factory(NULL),
         m_brushParent(NULL),
-        m_currentNode(NULL) {}
+        m_currentNode(NULL),
+        m_nextBrushRun(0) {}
         
         MapReader::MapReader(const String& str, Logger* logger) :
         StandardMapParser(str, logger),
+        m_begin(str.c_str()),
+        m_end(str.c_str() + str.size()),
+        m_threadCount(1),
         m_factory(NULL),
         m_brushParent(NULL),
-        m_currentNode(NULL) {}
+        m_currentNode(NULL),
+        m_nextBrushRun(0) {}
         
         MapReader::~MapReader() {
             VectorUtils::clearAndDelete(m_faces);
+            VectorUtils::clearAndDelete(m_brushRuns);
+        }
+
+        void MapReader::setThreadCount(const size_t threadCount) {
+            m_threadCount = threadCount;
         }
 
         void MapReader::readEntities(Model::MapFormat::Type format, const BBox3& worldBounds) {
             m_worldBounds = worldBounds;
+            if (m_threadCount > 1)
+                scanBrushRuns();
             parseEntities(format);
             resolveNodes();
         }
@@ -87,9 +437,62 @@ namespace TrenchBroom {
             parseBrushFaces(format);
         }
 
+        void MapReader::scanBrushRuns() {
+            // create a few runs per thread so that the workers stay busy even if the runs differ in cost
+            const size_t length = static_cast<size_t>(m_end - m_begin);
+            const size_t targetSize = std::max(length / (4 * m_threadCount), static_cast<size_t>(1));
+            
+            VectorUtils::clearAndDelete(m_brushRuns);
+            m_nextBrushRun = 0;
+            
+            const BrushRunScanner scanner(m_begin, m_end, targetSize, m_brushRuns);
+            if (!scanner.success() && logger() != NULL)
+                logger()->debug("Could not split map file into brush runs, parsing sequentially");
+        }
+        
+        void MapReader::parseBrushRuns(const Model::MapFormat::Type format) {
+            ThreadPool::TaskList tasks;
+            tasks.reserve(m_brushRuns.size());
+            
+            BrushRunList::const_iterator it, end;
+            for (it = m_brushRuns.begin(), end = m_brushRuns.end(); it != end; ++it) {
+                BrushRun* run = *it;
+                run->prepare(format, m_worldBounds, m_factory);
+                tasks.push_back(run);
+            }
+            
+            ThreadPool pool(std::min(m_threadCount, m_brushRuns.size()));
+            pool.run(tasks);
+        }
+        
+        void MapReader::replayBrushRun(BrushRun& run) {
+            BrushRun::EventList& events = run.events();
+            BrushRun::EventList::iterator it, end;
+            for (it = events.begin(), end = events.end(); it != end; ++it) {
+                BrushRun::Event& event = *it;
+                switch (event.type) {
+                    case BrushRun::Event::Type_Brush:
+                        addBrush(event.brush, event.line, event.lineCount, event.extraAttributes);
+                        event.brush = NULL;
+                        break;
+                    case BrushRun::Event::Type_Log:
+                        if (logger() != NULL)
+                            logger()->log(event.level, event.message);
+                        break;
+                    case BrushRun::Event::Type_ParserError:
+                        throw ParserException(event.message);
+                    case BrushRun::Event::Type_GeometryError:
+                        throw GeometryException(event.message);
+                    switchDefault();
+                }
+            }
+        }
+
         void MapReader::onFormatSet(const Model::MapFormat::Type format) {
             m_factory = initialize(format, m_worldBounds);
             assert(m_factory != NULL);
+            if (!m_brushRuns.empty())
+                parseBrushRuns(format);
         }
         
         void MapReader::onBeginEntity(const size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes) {
@@ -132,6 +535,19 @@ namespace TrenchBroom {
             onBrushFace(face);
         }
 
+        bool MapReader::onPreparsedBrushes(const char* position, const char*& end, size_t& endLine) {
+            while (m_nextBrushRun < m_brushRuns.size() && m_brushRuns[m_nextBrushRun]->position() < position)
+                ++m_nextBrushRun;
+            if (m_nextBrushRun == m_brushRuns.size() || m_brushRuns[m_nextBrushRun]->position() != position)
+                return false;
+            
+            BrushRun* run = m_brushRuns[m_nextBrushRun++];
+            replayBrushRun(*run);
+            end = run->end();
+            endLine = run->endLine();
+            return true;
+        }
+
         void MapReader::createLayer(const size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes) {
             const String& name = findAttribute(attributes, Model::AttributeNames::LayerName);
             if (StringUtils::isBlank(name)) {
@@ -228,18 +644,21 @@ namespace TrenchBroom {
                 Model::BrushFace::sortFaces(m_faces);
                 
                 Model::Brush* brush = m_factory->createBrush(m_worldBounds, m_faces);
-                setFilePosition(brush, startLine, lineCount);
-                setExtraAttributes(brush, extraAttributes);
-                
-                onBrush(m_brushParent, brush);
                 m_faces.clear();
+                addBrush(brush, startLine, lineCount, extraAttributes);
             } catch (GeometryException& e) {
                 if (logger() != NULL)
-                    logger()->error("Error parsing brush at line %u: %s", startLine, e.what());
+                    logger()->error("Error parsing brush at line %u: %s", static_cast<unsigned int>(startLine), e.what());
                 m_faces.clear(); // the faces will have been deleted by the brush's constructor
             }
 
         }
+        
+        void MapReader::addBrush(Model::Brush* brush, const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes) {
+            setFilePosition(brush, startLine, lineCount);
+            setExtraAttributes(brush, extraAttributes);
+            onBrush(m_brushParent, brush);
+        }
 
         MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const Model::EntityAttribute::List& attributes) {
             const String& layerIdStr = findAttribute(attributes, Model::AttributeNames::Layer);
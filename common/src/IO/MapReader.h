@@ -25,6 +25,8 @@
 #include "IO/StandardMapParser.h"
 #include "Model/ModelTypes.h"
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         class ModelFactory;
@@ -67,6 +69,15 @@ namespace TrenchBroom {
             typedef std::pair<Model::Node*, ParentInfo> NodeParentPair;
             typedef std::vector<NodeParentPair> NodeParentList;
             
+            class BrushRun;
+            class BrushRunParser;
+            class BrushRunScanner;
+            typedef std::vector<BrushRun*> BrushRunList;
+            
+            const char* m_begin;
+            const char* m_end;
+            size_t m_threadCount;
+            
             BBox3 m_worldBounds;
             Model::ModelFactory* m_factory;
             
@@ -77,6 +88,9 @@ namespace TrenchBroom {
             LayerMap m_layers;
             GroupMap m_groups;
             NodeParentList m_unresolvedNodes;
+            
+            BrushRunList m_brushRuns;
+            size_t m_nextBrushRun;
         protected:
             MapReader(const char* begin, const char* end, Logger* logger = NULL);
             MapReader(const String& str, Logger* logger = NULL);
@@ -86,6 +100,13 @@ namespace TrenchBroom {
             void readBrushFaces(Model::MapFormat::Type format, const BBox3& worldBounds);
         public:
             virtual ~MapReader();
+            
+            // if more than one thread is given, brushes are parsed on a thread pool when reading entities
+            void setThreadCount(size_t threadCount);
+        private:
+            void scanBrushRuns();
+            void parseBrushRuns(Model::MapFormat::Type format);
+            void replayBrushRun(BrushRun& run);
         private: // implement MapParser interface
             void onFormatSet(Model::MapFormat::Type format);
             void onBeginEntity(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes);
@@ -93,11 +114,13 @@ namespace TrenchBroom {
             void onBeginBrush(size_t line);
             void onEndBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes);
             void onBrushFace(size_t line, const Vec3& point1, const Vec3& point2, const Vec3& point3, const Model::BrushFaceAttributes& attribs, const Vec3& texAxisX, const Vec3& texAxisY);
+            bool onPreparsedBrushes(const char* position, const char*& end, size_t& endLine);
         private: // helper methods
             void createLayer(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes);
             void createGroup(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes);
             void createEntity(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes);
             void createBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes);
+            void addBrush(Model::Brush* brush, size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes);
 
             ParentInfo::Type storeNode(Model::Node* node, const Model::EntityAttribute::List& attributes);
             void stripParentAttributes(Model::AttributableNode* attributable, ParentInfo::Type parentType);
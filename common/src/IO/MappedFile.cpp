@@ -69,6 +69,12 @@ namespace TrenchBroom {
         MappedFileView::MappedFileView(const char* begin, const char* end) {
             init(begin, end);
         }
+        
+        MappedFileBuffer::MappedFileBuffer(std::vector<char>& buffer) {
+            m_buffer.swap(buffer);
+            if (!m_buffer.empty())
+                init(&m_buffer.front(), &m_buffer.front() + m_buffer.size());
+        }
 
 #ifdef _WIN32
         WinMappedFile::WinMappedFile(const Path& path, std::ios_base::openmode mode) :
@@ -58,6 +58,14 @@ namespace TrenchBroom {
         public:
             MappedFileView(const char* begin, const char* end);
         };
+        
+        class MappedFileBuffer : public MappedFile {
+        private:
+            std::vector<char> m_buffer;
+        public:
+            // takes the contents of the given buffer, leaving it empty
+            MappedFileBuffer(std::vector<char>& buffer);
+        };
 
 #ifdef _WIN32
         class WinMappedFile : public MappedFile {
@@ -20,52 +20,30 @@
 #ifndef TrenchBroom_PakFileSystem
 #define TrenchBroom_PakFileSystem
 
-#include "StringUtils.h"
-#include "IO/FileSystem.h"
+#include "IO/ArchiveFileSystem.h"
 #include "IO/Path.h"
 
-#include <map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        class PakFileSystem : public FileSystem {
+        class PakFileSystem : public ArchiveFileSystem {
         private:
-            class Directory {
-            private:
-                typedef std::map<String, Directory> DirMap;
-                typedef std::map<String, MappedFile::Ptr> FileMap;
+            struct PakEntry {
+                size_t address;
+                size_t length;
                 
-                Path m_path;
-                DirMap m_directories;
-                FileMap m_files;
-            public:
-                Directory(const Path& path);
-                
-                void addFile(const Path& path, MappedFile::Ptr file);
-                
-                bool directoryExists(const Path& path) const;
-                bool fileExists(const Path& path) const;
-
-                const Directory& findDirectory(const Path& path) const;
-                const MappedFile::Ptr findFile(const Path& path) const;
-                Path::List contents() const;
-            private:
-                Directory& findOrCreateDirectory(const Path& path);
+                PakEntry(size_t i_address, size_t i_length);
             };
             
-            Path m_path;
-            MappedFile::Ptr m_file;
-            Directory m_root;
+            typedef std::vector<PakEntry> PakEntryList;
+            PakEntryList m_pakEntries;
         public:
             PakFileSystem(const Path& path, MappedFile::Ptr file);
         private:
             void readDirectory();
             
-            bool doDirectoryExists(const Path& path) const;
-            bool doFileExists(const Path& path) const;
-            
-            Path::List doGetDirectoryContents(const Path& path) const;
-            const MappedFile::Ptr doOpenFile(const Path& path) const;
+            const MappedFile::Ptr doOpenEntry(size_t id) const;
         };
     }
 }
@@ -27,8 +27,8 @@ namespace TrenchBroom {
     namespace IO {
         const String QuakeMapTokenizer::NumberDelim = Whitespace + ")";
 
-        QuakeMapTokenizer::QuakeMapTokenizer(const char* begin, const char* end) :
-        Tokenizer(begin, end),
+        QuakeMapTokenizer::QuakeMapTokenizer(const char* begin, const char* end, const size_t firstLine) :
+        Tokenizer(begin, end, firstLine),
         m_skipEol(true) {}
         
         QuakeMapTokenizer::QuakeMapTokenizer(const String& str) :
@@ -109,8 +109,8 @@ namespace TrenchBroom {
             return Token(QuakeMapToken::Eof, NULL, NULL, length(), line(), column());
         }
 
-        StandardMapParser::StandardMapParser(const char* begin, const char* end, Logger* logger) :
-        m_tokenizer(QuakeMapTokenizer(begin, end)),
+        StandardMapParser::StandardMapParser(const char* begin, const char* end, Logger* logger, const size_t firstLine) :
+        m_tokenizer(QuakeMapTokenizer(begin, end, firstLine)),
         m_logger(logger),
         m_format(Model::MapFormat::Unknown) {}
         
@@ -145,7 +145,7 @@ namespace TrenchBroom {
                 }
                 
                 // texture names can contain braces etc, so we just read everything until the next opening bracket or number
-                m_tokenizer.readRemainder(QuakeMapToken::OBracket | QuakeMapToken::Integer | QuakeMapToken::Decimal);
+                m_tokenizer.readRemainderToken(QuakeMapToken::OBracket | QuakeMapToken::Integer | QuakeMapToken::Decimal);
                 expect(QuakeMapToken::Integer | QuakeMapToken::Decimal | QuakeMapToken::OBracket, token = m_tokenizer.nextToken());
                 if (token.type() == QuakeMapToken::OBracket)
                     format = Model::MapFormat::Valve;
@@ -258,12 +258,14 @@ namespace TrenchBroom {
                         parseEntityAttribute(attributes);
                         break;
                     case QuakeMapToken::OBrace:
-                        m_tokenizer.pushToken(token);
                         if (!beginEntityCalled) {
                             beginEntity(startLine, attributes, extraAttributes);
                             beginEntityCalled = true;
                         }
-                        parseBrush();
+                        if (!skipPreparsedBrushes(token)) {
+                            m_tokenizer.pushToken(token);
+                            parseBrush();
+                        }
                         break;
                     case QuakeMapToken::CBrace:
                         if (!beginEntityCalled)
@@ -330,6 +332,15 @@ namespace TrenchBroom {
             }
         }
         
+        bool StandardMapParser::skipPreparsedBrushes(const Token& token) {
+            const char* end = NULL;
+            size_t endLine = 0;
+            if (!preparsedBrushes(token.begin(), end, endLine))
+                return false;
+            m_tokenizer.seek(end, endLine);
+            return true;
+        }
+        
         void StandardMapParser::parseFace() {
             Vec3 texAxisX, texAxisY;
             
@@ -53,7 +53,7 @@ namespace TrenchBroom {
             static const String NumberDelim;
             bool m_skipEol;
         public:
-            QuakeMapTokenizer(const char* begin, const char* end);
+            QuakeMapTokenizer(const char* begin, const char* end, size_t firstLine = 1);
             QuakeMapTokenizer(const String& str);
             
             void setSkipEol(bool skipEol);
@@ -69,7 +69,7 @@ namespace TrenchBroom {
             Logger* m_logger;
             Model::MapFormat::Type m_format;
         public:
-            StandardMapParser(const char* begin, const char* end, Logger* logger = NULL);
+            StandardMapParser(const char* begin, const char* end, Logger* logger = NULL, size_t firstLine = 1);
             StandardMapParser(const String& str, Logger* logger = NULL);
             
             virtual ~StandardMapParser();
@@ -91,6 +91,7 @@ namespace TrenchBroom {
             void parseEntity();
             void parseEntityAttribute(Model::EntityAttribute::List& attributes);
             void parseBrush();
+            bool skipPreparsedBrushes(const Token& token);
             void parseFace();
 
             Vec3 parseVector();
@@ -22,6 +22,8 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/Path.h"
 
+#include <wx/stdpaths.h>
+
 #if defined __APPLE__
 #include "CoreFoundation/CoreFoundation.h"
 #elif defined _WIN32
@@ -105,6 +107,10 @@ namespace TrenchBroom {
             }
 #endif
             
+            Path userDataDirectory() {
+                return Path(wxStandardPaths::Get().GetUserLocalDataDir().ToStdString());
+            }
+            
 #if defined __APPLE__
             Path findFontFile(const String& fontName) {
                 const Path fontDirectoryPaths[2] = {
@@ -0,0 +1,319 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Exceptions.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/IOUtils.h"
+#include "IO/MappedFile.h"
+#include "IO/SystemPaths.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const char CacheFileMagic[4] = { 'T', 'B', 'T', 'C' };
+        static const String CacheFileExtension = "tbtc";
+        // name length, width, height, average color and buffer count
+        static const size_t MinEntrySize = 4 + 4 + 4 + 4 * sizeof(float) + 4;
+        static const size_t MipLevelCount = 4;
+        
+        class CacheFileReader {
+        private:
+            const char* m_cursor;
+            const char* m_end;
+        public:
+            CacheFileReader(const char* begin, const char* end) :
+            m_cursor(begin),
+            m_end(end) {}
+            
+            template <typename T>
+            T read() {
+                require(sizeof(T));
+                return IO::read<T>(m_cursor);
+            }
+            
+            String readString() {
+                const size_t length = static_cast<size_t>(read<uint32_t>());
+                require(length);
+                const String result(m_cursor, length);
+                m_cursor += length;
+                return result;
+            }
+            
+            void readBytes(unsigned char* buffer, const size_t count) {
+                require(count);
+                memcpy(buffer, m_cursor, count);
+                m_cursor += count;
+            }
+            
+            size_t remaining() const {
+                return static_cast<size_t>(m_end - m_cursor);
+            }
+        private:
+            void require(const size_t count) const {
+                if (static_cast<size_t>(m_end - m_cursor) < count)
+                    throw AssetException("Texture cache file is truncated");
+            }
+        };
+        
+        template <typename T>
+        static void writeValue(std::ostream& stream, const T value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        
+        static void writeString(std::ostream& stream, const String& str) {
+            writeValue(stream, static_cast<uint32_t>(str.size()));
+            stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+        }
+
+        TextureCache::Entry::Entry() :
+        width(0),
+        height(0) {}
+
+        TextureCache::Entry::Entry(const String& i_name, const size_t i_width, const size_t i_height, const Color& i_averageColor, const Assets::TextureBuffer::List& i_buffers) :
+        name(i_name),
+        width(i_width),
+        height(i_height),
+        averageColor(i_averageColor),
+        buffers(i_buffers) {}
+
+        TextureCache& TextureCache::instance() {
+            static TextureCache instance(SystemPaths::userDataDirectory() + Path("TextureCache"));
+            return instance;
+        }
+        
+        TextureCache::TextureCache(const Path& directory, const size_t sizeLimit) :
+        m_directory(directory),
+        m_sizeLimit(sizeLimit),
+        m_size(0),
+        m_sizeKnown(false) {}
+
+        const Path& TextureCache::directory() const {
+            return m_directory;
+        }
+
+        size_t TextureCache::sizeLimit() const {
+            return m_sizeLimit;
+        }
+        
+        void TextureCache::setSizeLimit(const size_t sizeLimit) {
+            wxCriticalSectionLocker lock(m_lock);
+            m_sizeLimit = sizeLimit;
+            evict();
+        }
+
+        bool TextureCache::read(const Path& sourcePath, const size_t paletteHash, EntryList& entries) {
+            wxCriticalSectionLocker lock(m_lock);
+            try {
+                const Path cachePath = m_directory + cacheFileName(sourcePath);
+                if (!Disk::fileExists(cachePath))
+                    return false;
+                
+                const MappedFile::Ptr file = Disk::openFile(cachePath);
+                CacheFileReader reader(file->begin(), file->end());
+                
+                char magic[4];
+                for (size_t i = 0; i < 4; ++i)
+                    magic[i] = reader.read<char>();
+                if (memcmp(magic, CacheFileMagic, 4) != 0 ||
+                    reader.read<uint32_t>() != Version ||
+                    reader.readString() != sourcePath.asString() ||
+                    reader.read<int64_t>() != static_cast<int64_t>(Disk::modificationTime(sourcePath)) ||
+                    reader.read<uint64_t>() != static_cast<uint64_t>(paletteHash))
+                    return false;
+                
+                // all counts and sizes are checked against the remaining data before anything is allocated
+                const size_t entryCount = static_cast<size_t>(reader.read<uint32_t>());
+                if (entryCount > reader.remaining() / MinEntrySize)
+                    return false;
+                
+                EntryList result(entryCount);
+                for (size_t i = 0; i < result.size(); ++i) {
+                    Entry& entry = result[i];
+                    entry.name = reader.readString();
+                    entry.width = static_cast<size_t>(reader.read<uint32_t>());
+                    entry.height = static_cast<size_t>(reader.read<uint32_t>());
+                    for (size_t j = 0; j < 4; ++j)
+                        entry.averageColor[j] = reader.read<float>();
+                    
+                    if (entry.width == 0 || entry.height == 0 ||
+                        entry.width > reader.remaining() / entry.height / 3)
+                        return false;
+                    if (static_cast<size_t>(reader.read<uint32_t>()) != MipLevelCount)
+                        return false;
+                    
+                    entry.buffers.resize(MipLevelCount);
+                    for (size_t j = 0; j < MipLevelCount; ++j) {
+                        const size_t expectedSize = (3 * entry.width * entry.height) >> (2 * j);
+                        const size_t size = static_cast<size_t>(reader.read<uint32_t>());
+                        if (size != expectedSize)
+                            return false;
+                        entry.buffers[j] = Assets::TextureBuffer(size);
+                        if (size > 0)
+                            reader.readBytes(entry.buffers[j].ptr(), size);
+                    }
+                }
+                
+                using std::swap;
+                swap(entries, result);
+                return true;
+            } catch (const Exception&) {
+                return false;
+            }
+        }
+        
+        void TextureCache::write(const Path& sourcePath, const size_t paletteHash, const EntryList& entries) {
+            wxCriticalSectionLocker lock(m_lock);
+            try {
+                if (!m_sizeKnown) {
+                    m_size = computeSize();
+                    m_sizeKnown = true;
+                }
+                
+                doWrite(sourcePath, paletteHash, entries);
+                if (m_size > m_sizeLimit)
+                    evict();
+            } catch (const Exception&) {
+                // the running size may be off now, so it is recomputed on the next write
+                m_sizeKnown = false;
+            }
+        }
+        
+        Path TextureCache::cacheFileName(const Path& sourcePath) const {
+            // FNV-1a
+            const String& str = sourcePath.asString();
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < str.size(); ++i) {
+                hash ^= static_cast<uint32_t>(static_cast<unsigned char>(str[i]));
+                hash *= 16777619u;
+            }
+            
+            StringStream name;
+            name << std::hex << std::setw(8) << std::setfill('0') << hash << "." << CacheFileExtension;
+            return Path(name.str());
+        }
+
+        void TextureCache::doWrite(const Path& sourcePath, const size_t paletteHash, const EntryList& entries) {
+            WritableDiskFileSystem fs(m_directory, true);
+            
+            // write to a temporary file first so that readers never see a partially written cache file
+            const Path fileName = cacheFileName(sourcePath);
+            const Path tempFileName = fileName.addExtension("tmp");
+            size_t newSize = 0;
+            {
+                std::ofstream stream((m_directory + tempFileName).asString().c_str(), std::ios::out | std::ios::binary);
+                if (!stream.is_open())
+                    throw FileSystemException("Cannot open texture cache file for writing: '" + tempFileName.asString() + "'");
+                
+                stream.write(CacheFileMagic, 4);
+                writeValue(stream, static_cast<uint32_t>(Version));
+                writeString(stream, sourcePath.asString());
+                writeValue(stream, static_cast<int64_t>(Disk::modificationTime(sourcePath)));
+                writeValue(stream, static_cast<uint64_t>(paletteHash));
+                
+                writeValue(stream, static_cast<uint32_t>(entries.size()));
+                EntryList::const_iterator it, end;
+                for (it = entries.begin(), end = entries.end(); it != end; ++it) {
+                    const Entry& entry = *it;
+                    writeString(stream, entry.name);
+                    writeValue(stream, static_cast<uint32_t>(entry.width));
+                    writeValue(stream, static_cast<uint32_t>(entry.height));
+                    for (size_t i = 0; i < 4; ++i)
+                        writeValue(stream, entry.averageColor[i]);
+                    
+                    writeValue(stream, static_cast<uint32_t>(entry.buffers.size()));
+                    for (size_t i = 0; i < entry.buffers.size(); ++i) {
+                        const Assets::TextureBuffer& buffer = entry.buffers[i];
+                        writeValue(stream, static_cast<uint32_t>(buffer.size()));
+                        stream.write(reinterpret_cast<const char*>(buffer.ptr()), static_cast<std::streamsize>(buffer.size()));
+                    }
+                }
+                
+                if (!stream.good())
+                    throw FileSystemException("Cannot write texture cache file: '" + tempFileName.asString() + "'");
+                newSize = static_cast<size_t>(stream.tellp());
+            }
+            
+            const size_t oldSize = fs.fileExists(fileName) ? fs.openFile(fileName)->size() : 0;
+            fs.moveFile(tempFileName, fileName, true);
+            m_size = m_size - std::min(m_size, oldSize) + newSize;
+        }
+
+        struct CacheFile {
+            Path path;
+            time_t modificationTime;
+            size_t size;
+            
+            CacheFile(const Path& i_path, const time_t i_modificationTime, const size_t i_size) :
+            path(i_path),
+            modificationTime(i_modificationTime),
+            size(i_size) {}
+            
+            bool operator<(const CacheFile& other) const {
+                return modificationTime < other.modificationTime;
+            }
+        };
+
+        size_t TextureCache::computeSize() const {
+            if (!Disk::directoryExists(m_directory))
+                return 0;
+            
+            const DiskFileSystem fs(m_directory);
+            const Path::List paths = fs.findItems(Path(""), FileSystem::ExtensionMatcher(CacheFileExtension));
+            
+            size_t totalSize = 0;
+            Path::List::const_iterator it, end;
+            for (it = paths.begin(), end = paths.end(); it != end; ++it)
+                totalSize += fs.openFile(*it)->size();
+            return totalSize;
+        }
+
+        // Deletes the least recently written cache files until the cache fits into its size limit.
+        void TextureCache::evict() {
+            WritableDiskFileSystem fs(m_directory, true);
+            const Path::List paths = fs.findItems(Path(""), FileSystem::ExtensionMatcher(CacheFileExtension));
+            
+            std::vector<CacheFile> files;
+            size_t totalSize = 0;
+            
+            Path::List::const_iterator it, end;
+            for (it = paths.begin(), end = paths.end(); it != end; ++it) {
+                const Path& path = *it;
+                const size_t size = fs.openFile(path)->size();
+                files.push_back(CacheFile(path, Disk::modificationTime(m_directory + path), size));
+                totalSize += size;
+            }
+            
+            std::sort(files.begin(), files.end());
+            for (size_t i = 0; i < files.size() && totalSize > m_sizeLimit; ++i) {
+                const CacheFile& file = files[i];
+                fs.deleteFile(file.path);
+                totalSize -= file.size;
+            }
+            
+            m_size = totalSize;
+            m_sizeKnown = true;
+        }
+    }
+}
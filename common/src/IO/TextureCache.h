@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_TextureCache
+#define TrenchBroom_TextureCache
+
+#include "Color.h"
+#include "StringUtils.h"
+#include "Assets/Texture.h"
+#include "IO/Path.h"
+
+#include <vector>
+
+#include <wx/thread.h>
+
+namespace TrenchBroom {
+    namespace IO {
+        // Stores the decoded mip chains of texture collections on disk so that they need not be decoded again. A
+        // cache file is only used if the modification time of its source file and the palette still match.
+        class TextureCache {
+        public:
+            struct Entry {
+                String name;
+                size_t width;
+                size_t height;
+                Color averageColor;
+                Assets::TextureBuffer::List buffers;
+                
+                Entry();
+                Entry(const String& i_name, size_t i_width, size_t i_height, const Color& i_averageColor, const Assets::TextureBuffer::List& i_buffers);
+            };
+            typedef std::vector<Entry> EntryList;
+            
+            static const size_t DefaultSizeLimit = 256 * 1024 * 1024;
+        private:
+            static const unsigned int Version = 1;
+            
+            Path m_directory;
+            size_t m_sizeLimit;
+            // the total size of the cache files, computed once and then kept up to date by write
+            size_t m_size;
+            bool m_sizeKnown;
+            wxCriticalSection m_lock;
+        public:
+            static TextureCache& instance();
+            
+            TextureCache(const Path& directory, size_t sizeLimit = DefaultSizeLimit);
+            
+            const Path& directory() const;
+            size_t sizeLimit() const;
+            void setSizeLimit(size_t sizeLimit);
+            
+            // Returns false if there is no valid cache file for the given source file and palette.
+            bool read(const Path& sourcePath, size_t paletteHash, EntryList& entries);
+            // Failures are ignored since the cache can always be rebuilt from the source file.
+            void write(const Path& sourcePath, size_t paletteHash, const EntryList& entries);
+        private:
+            Path cacheFileName(const Path& sourcePath) const;
+            void doWrite(const Path& sourcePath, size_t paletteHash, const EntryList& entries);
+            size_t computeSize() const;
+            void evict();
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureCache) */
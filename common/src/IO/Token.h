@@ -90,25 +90,78 @@ namespace TrenchBroom {
             
             template <typename T>
             T toFloat() const {
-                static const size_t BufferSize = 256;
-                static char buffer[BufferSize];
-                assert(length() < BufferSize);
-                
-                memcpy(buffer, m_begin, length());
-                buffer[length()] = 0;
-                const T f = static_cast<T>(std::atof(buffer));
-                return f;
+                double d;
+                if (!parseSimpleDecimal(d)) {
+                    static const size_t BufferSize = 256;
+                    char buffer[BufferSize];
+                    assert(length() < BufferSize);
+                    
+                    memcpy(buffer, m_begin, length());
+                    buffer[length()] = 0;
+                    d = std::atof(buffer);
+                }
+                return static_cast<T>(d);
             }
             
             template <typename T>
             T toInteger() const {
-                static char buffer[64];
-                assert(length() < 64);
+                // same as std::atoi, but without copying the token into a terminated buffer
+                const char* c = m_begin;
+                while (c < m_end && (*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r'))
+                    ++c;
+                
+                bool negative = false;
+                if (c < m_end && (*c == '+' || *c == '-'))
+                    negative = *c++ == '-';
+                
+                long i = 0;
+                while (c < m_end && *c >= '0' && *c <= '9')
+                    i = 10 * i + (*c++ - '0');
+                return static_cast<T>(negative ? -i : i);
+            }
+        private:
+            // Parses numbers of the form [+-]digits[.digits] in place. Since both the mantissa and the power of ten
+            // are exactly representable, the result is correctly rounded and thus equal to that of std::atof. Returns
+            // false for all other numbers.
+            bool parseSimpleDecimal(double& result) const {
+                static const double Powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+                static const size_t MaxDigits = 15;
+                
+                const char* c = m_begin;
+                bool negative = false;
+                if (c < m_end && (*c == '+' || *c == '-'))
+                    negative = *c++ == '-';
+                
+                double mantissa = 0.0;
+                size_t digits = 0;
+                size_t decimals = 0;
+                bool anyDigit = false;
+                bool dot = false;
+                for (; c < m_end; ++c) {
+                    if (*c >= '0' && *c <= '9') {
+                        anyDigit = true;
+                        if (digits > 0 || *c != '0')
+                            ++digits;
+                        if (dot)
+                            ++decimals;
+                        if (digits > MaxDigits || decimals > 22)
+                            return false;
+                        mantissa = 10.0 * mantissa + static_cast<double>(*c - '0');
+                    } else if (*c == '.' && !dot) {
+                        dot = true;
+                    } else {
+                        return false;
+                    }
+                }
+                
+                if (!anyDigit)
+                    return false;
                 
-                memcpy(buffer, m_begin, length());
-                buffer[length()] = 0;
-                const T i = static_cast<T>(std::atoi(buffer));
-                return i;
+                result = mantissa / Powers[decimals];
+                if (negative)
+                    result = -result;
+                return true;
             }
         };
     }
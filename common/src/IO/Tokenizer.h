@@ -24,7 +24,6 @@
 #include "Token.h"
 
 #include <cassert>
-#include <stack>
 
 namespace TrenchBroom {
     namespace IO {
@@ -33,7 +32,8 @@ namespace TrenchBroom {
         public:
             typedef TokenTemplate<TokenType> Token;
         private:
-            typedef std::stack<Token> TokenStack;
+            // tokens are pushed back onto a small fixed buffer to avoid allocations when peeking
+            static const size_t MaxPushedTokens = 4;
             
             struct State {
                 const char* cur;
@@ -41,35 +41,41 @@ namespace TrenchBroom {
                 size_t column;
                 size_t lastColumn;
                 
-                State(const char* i_cur) :
+                State(const char* i_cur, const size_t i_line = 1) :
                 cur(i_cur),
-                line(1),
+                line(i_line),
                 column(1),
                 lastColumn(0) {}
             };
             
             const char* m_begin;
             const char* m_end;
+            size_t m_firstLine;
             State m_state;
             
-            TokenStack m_tokenStack;
+            Token m_pushedTokens[MaxPushedTokens];
+            size_t m_pushedTokenCount;
         public:
             static const String Whitespace;
         public:
-            Tokenizer(const char* begin, const char* end) :
+            Tokenizer(const char* begin, const char* end, const size_t firstLine = 1) :
             m_begin(begin),
             m_end(end),
-            m_state(State(m_begin)) {}
+            m_firstLine(firstLine),
+            m_state(State(m_begin, m_firstLine)),
+            m_pushedTokenCount(0) {}
             
             Tokenizer(const String& str) :
             m_begin(str.c_str()),
             m_end(str.c_str() + str.size()),
-            m_state(State(m_begin)) {}
+            m_firstLine(1),
+            m_state(State(m_begin, m_firstLine)),
+            m_pushedTokenCount(0) {}
             
             virtual ~Tokenizer() {}
             
             Token nextToken() {
-                return !m_tokenStack.empty() ? popToken() : emitToken();
+                return m_pushedTokenCount > 0 ? popToken() : emitToken();
             }
             
             Token peekToken() {
@@ -79,23 +85,28 @@ namespace TrenchBroom {
             }
             
             void pushToken(const Token& token) {
-                m_tokenStack.push(token);
+                if (m_pushedTokenCount == MaxPushedTokens)
+                    throw ParserException(token.line(), token.column(), "Too many pushed back tokens");
+                m_pushedTokens[m_pushedTokenCount++] = token;
             }
             
             Token popToken() {
-                assert(!m_tokenStack.empty());
-                Token token = m_tokenStack.top();
-                m_tokenStack.pop();
-                return token;
+                assert(m_pushedTokenCount > 0);
+                return m_pushedTokens[--m_pushedTokenCount];
             }
             
             String readRemainder(const TokenType delimiterType) {
+                return readRemainderToken(delimiterType).data();
+            }
+            
+            // Same as readRemainder, but returns the text as an untyped token that points into the buffer.
+            Token readRemainderToken(const TokenType delimiterType) {
                 if (eof())
-                    return "";
+                    return Token(0, m_end, m_end, length(), line(), column());
                 
                 Token token = peekToken();
-                const char* startPos = token.begin();
-                const char* endPos = startPos;
+                const Token first = token;
+                const char* endPos = first.begin();
                 token = nextToken();
                 while ((token.type() & delimiterType) == 0 && !eof()) {
                     endPos = token.end();
@@ -103,19 +114,34 @@ namespace TrenchBroom {
                 }
                 
                 pushToken(token);
-                return String(startPos, static_cast<size_t>(endPos - startPos));
+                return Token(0, first.begin(), endPos, first.position(), first.line(), first.column());
             }
             
             String readAnyString(const String& delims) {
+                return readAnyStringToken(delims).data();
+            }
+            
+            // Same as readAnyString, but returns the text as an untyped token that points into the buffer.
+            Token readAnyStringToken(const String& delims) {
                 while (isWhitespace(curChar()))
                     advance();
                 const char* startPos = curPos();
+                const size_t startLine = line();
+                const size_t startColumn = column();
                 const char* endPos = (curChar() == '"' ? readQuotedString() : readString(delims));
-                return String(startPos, static_cast<size_t>(endPos - startPos));
+                return Token(0, startPos, endPos, offset(startPos), startLine, startColumn);
             }
             
             void reset() {
-                m_state = State(m_begin);
+                m_state = State(m_begin, m_firstLine);
+            }
+            
+            // Continues tokenizing at the given position, which must be at the beginning of the given line.
+            void seek(const char* position, const size_t line) {
+                assert(position >= m_begin && position <= m_end);
+                assert(position == m_begin || position == m_end || *(position - 1) == '\n');
+                m_state = State(position, line);
+                m_pushedTokenCount = 0;
             }
 
             double progress() const {
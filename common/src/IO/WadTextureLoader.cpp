@@ -23,6 +23,8 @@
 #include "CollectionUtils.h"
 #include "Color.h"
 #include "Exceptions.h"
+#include "SharedPointer.h"
+#include "ThreadPool.h"
 #include "Renderer/GL.h"
 #include "IO/Wad.h"
 #include "Assets/Palette.h"
@@ -30,50 +32,165 @@
 #include "Assets/TextureCollection.h"
 #include "Assets/TextureCollectionSpec.h"
 
+#include <algorithm>
+#include <cassert>
 #include <iterator>
 
+#include <wx/thread.h>
+
 namespace TrenchBroom {
     namespace IO {
-        WadTextureLoader::WadTextureLoader(const Assets::Palette& palette) :
-        m_palette(palette) {}
+        // Collects the decoded textures of a wad file and writes them to the texture cache once all of them have
+        // been decoded.
+        class WadTextureLoader::CacheWriter {
+        private:
+            TextureCache& m_cache;
+            Path m_path;
+            size_t m_paletteHash;
+            
+            wxMutex m_mutex;
+            TextureCache::EntryList m_entries;
+            size_t m_remaining;
+        public:
+            CacheWriter(TextureCache& cache, const Path& path, const size_t paletteHash, const size_t textureCount) :
+            m_cache(cache),
+            m_path(path),
+            m_paletteHash(paletteHash),
+            m_entries(textureCount),
+            m_remaining(textureCount) {}
+            
+            void textureLoaded(const size_t index, const TextureCache::Entry& entry) {
+                bool done = false;
+                {
+                    wxMutexLocker lock(m_mutex);
+                    assert(index < m_entries.size());
+                    assert(m_remaining > 0);
+                    m_entries[index] = entry;
+                    done = --m_remaining == 0;
+                }
+                
+                if (done)
+                    m_cache.write(m_path, m_paletteHash, m_entries);
+            }
+        };
+        
+        // Decodes a range of the mip entries of a wad file into the collection's placeholder textures.
+        class WadTextureLoader::LoadTask : public Assets::TextureCollection::LoadTask {
+        private:
+            Wad m_wad;
+            WadEntryList m_entries;
+            size_t m_firstIndex;
+            Assets::Palette m_palette;
+            CacheWriterPtr m_cacheWriter;
+        public:
+            LoadTask(const Wad& wad, const WadEntryList& entries, const size_t firstIndex, const Assets::Palette& palette, CacheWriterPtr cacheWriter) :
+            m_wad(wad),
+            m_entries(entries),
+            m_firstIndex(firstIndex),
+            m_palette(palette),
+            m_cacheWriter(cacheWriter) {}
+        private:
+            void doLoad() {
+                Color averageColor;
+                Assets::TextureBuffer::List buffers(4);
+                
+                for (size_t i = 0; i < m_entries.size() && !cancelled(); ++i) {
+                    const WadEntry& entry = m_entries[i];
+                    try {
+                        const MipSize mipSize = m_wad.mipSize(entry);
+                        Assets::setMipBufferSize(buffers, mipSize.width, mipSize.height);
+                        WadTextureLoader::loadMips(m_wad, entry, m_palette, buffers, averageColor);
+                        textureLoaded(m_firstIndex + i, averageColor, buffers);
+                        
+                        if (m_cacheWriter != NULL)
+                            m_cacheWriter->textureLoaded(m_firstIndex + i, TextureCache::Entry(entry.name(), mipSize.width, mipSize.height, averageColor, buffers));
+                    } catch (...) {
+                        // the texture remains a placeholder
+                    }
+                }
+            }
+        };
+        
+        WadTextureLoader::WadTextureLoader(const Assets::Palette& palette, TextureCache* cache) :
+        m_palette(palette),
+        m_cache(cache) {}
         
         Assets::TextureCollection* WadTextureLoader::doLoadTextureCollection(const Assets::TextureCollectionSpec& spec) const {
-            Wad wad(spec.path());
+            if (m_cache != NULL) {
+                TextureCache::EntryList entries;
+                if (m_cache->read(spec.path(), m_palette.hash(), entries))
+                    return createCollection(spec, entries);
+            }
+            
+            const Wad wad(spec.path());
             const WadEntryList mipEntries = wad.entriesWithType(WadEntryType::WEMip);
             const size_t textureCount = mipEntries.size();
             
             Assets::TextureList textures;
             textures.reserve(textureCount);
+            Assets::TextureCollection::LoadTaskList tasks;
             
             try {
+                // only the mip headers are read here, the pixel data is decoded by the load tasks
                 for (size_t i = 0; i < textureCount; ++i) {
                     const WadEntry& entry = mipEntries[i];
-                    Assets::Texture* texture = loadTexture(wad, entry);
-                    textures.push_back(texture);
+                    const MipSize mipSize = wad.mipSize(entry);
+                    textures.push_back(new Assets::Texture(entry.name(), mipSize.width, mipSize.height));
+                }
+                
+                CacheWriterPtr cacheWriter;
+                if (m_cache != NULL && textureCount > 0)
+                    cacheWriter = CacheWriterPtr(new CacheWriter(*m_cache, spec.path(), m_palette.hash(), textureCount));
+                
+                const size_t taskCount = std::min(textureCount, 4 * ThreadPool::defaultThreadCount());
+                for (size_t i = 0; i < taskCount; ++i) {
+                    const size_t first = i * textureCount / taskCount;
+                    const size_t last = (i + 1) * textureCount / taskCount;
+                    const WadEntryList entries(mipEntries.begin() + first, mipEntries.begin() + last);
+                    tasks.push_back(new LoadTask(wad, entries, first, m_palette, cacheWriter));
                 }
-                return new Assets::TextureCollection(spec.name(), textures);
+                
+                return new Assets::TextureCollection(spec.name(), textures, tasks);
             } catch (...) {
+                VectorUtils::clearAndDelete(tasks);
                 VectorUtils::clearAndDelete(textures);
                 throw;
             }
         }
+        
+        Assets::TextureCollection* WadTextureLoader::createCollection(const Assets::TextureCollectionSpec& spec, const TextureCache::EntryList& entries) const {
+            Assets::TextureList textures;
+            textures.reserve(entries.size());
+            
+            TextureCache::EntryList::const_iterator it, end;
+            for (it = entries.begin(), end = entries.end(); it != end; ++it) {
+                const TextureCache::Entry& entry = *it;
+                textures.push_back(new Assets::Texture(entry.name, entry.width, entry.height, entry.averageColor, entry.buffers));
+            }
+            
+            return new Assets::TextureCollection(spec.name(), textures);
+        }
 
-        Assets::Texture* WadTextureLoader::loadTexture(const Wad& wad, const WadEntry& entry) const {
-            static Color tempColor, averageColor;
-            static Assets::TextureBuffer::List buffers(4);
+        Assets::Texture* WadTextureLoader::loadTexture(const Wad& wad, const WadEntry& entry, const Assets::Palette& palette) {
+            Color averageColor;
+            Assets::TextureBuffer::List buffers(4);
 
             const MipSize mipSize = wad.mipSize(entry);
             Assets::setMipBufferSize(buffers, mipSize.width, mipSize.height);
+            loadMips(wad, entry, palette, buffers, averageColor);
             
+            return new Assets::Texture(entry.name(), mipSize.width, mipSize.height, averageColor, buffers);
+        }
+
+        void WadTextureLoader::loadMips(const Wad& wad, const WadEntry& entry, const Assets::Palette& palette, Assets::TextureBuffer::List& buffers, Color& averageColor) {
+            Color tempColor;
             for (size_t j = 0; j < 4; ++j) {
                 const MipData mipData = wad.mipData(entry, j);
                 const size_t size = static_cast<size_t>(std::distance(mipData.begin, mipData.end));
-                m_palette.indexedToRgb(mipData.begin, size, buffers[j], tempColor);
+                palette.indexedToRgb(mipData.begin, size, buffers[j], tempColor);
                 if (j == 0)
                     averageColor = tempColor;
             }
-            
-            return new Assets::Texture(entry.name(), mipSize.width, mipSize.height, averageColor, buffers);
         }
     }
 }
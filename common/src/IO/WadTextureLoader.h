@@ -20,8 +20,12 @@
 #ifndef TrenchBroom_WadTextureLoader
 #define TrenchBroom_WadTextureLoader
 
+#include "Color.h"
 #include "IO/TextureLoader.h"
 #include "Assets/AssetTypes.h"
+#include "SharedPointer.h"
+#include "Assets/Texture.h"
+#include "IO/TextureCache.h"
 
 namespace TrenchBroom {
     namespace IO {
@@ -31,14 +35,24 @@ namespace TrenchBroom {
         
         class WadTextureLoader : public TextureLoader {
         private:
+            class CacheWriter;
+            typedef std::tr1::shared_ptr<CacheWriter> CacheWriterPtr;
+            
+            class LoadTask;
+            friend class LoadTask;
+            
             const Assets::Palette& m_palette;
+            TextureCache* m_cache;
         public:
-            WadTextureLoader(const Assets::Palette& palette);
-        private:
-            static const size_t InitialBufferSize = 3 * 512 * 512;
+            // If a cache is given, decoded collections are read from and written to it.
+            WadTextureLoader(const Assets::Palette& palette, TextureCache* cache = NULL);
             
+            // Decodes the given texture on the calling thread.
+            static Assets::Texture* loadTexture(const Wad& wad, const WadEntry& entry, const Assets::Palette& palette);
+        private:
             Assets::TextureCollection* doLoadTextureCollection(const Assets::TextureCollectionSpec& spec) const;
-            Assets::Texture* loadTexture(const Wad& wad, const WadEntry& entry) const;
+            Assets::TextureCollection* createCollection(const Assets::TextureCollectionSpec& spec, const TextureCache::EntryList& entries) const;
+            static void loadMips(const Wad& wad, const WadEntry& entry, const Assets::Palette& palette, Assets::TextureBuffer::List& buffers, Color& averageColor);
         };
     }
 }
@@ -42,6 +42,7 @@ namespace TrenchBroom {
         Assets::TextureCollection* WalTextureLoader::doLoadTextureCollection(const Assets::TextureCollectionSpec& spec) const {
             Path::List texturePaths = m_fs.findItems(spec.path(), FileSystem::ExtensionMatcher("wal"));
             std::sort(texturePaths.begin(), texturePaths.end());
+            m_fs.preloadFiles(texturePaths);
             
             Assets::TextureList textures;
             textures.reserve(texturePaths.size());
@@ -0,0 +1,294 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ZipFileSystem.h"
+
+#include "CollectionUtils.h"
+#include "Exceptions.h"
+#include "StringUtils.h"
+#include "ThreadPool.h"
+#include "IO/IOUtils.h"
+
+#include <wx/mstream.h>
+#include <wx/zstream.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace ZipLayout {
+            static const unsigned int LocalHeaderSignature     = 0x04034b50;
+            static const unsigned int CentralHeaderSignature   = 0x02014b50;
+            static const unsigned int EndOfDirectorySignature  = 0x06054b50;
+            static const size_t LocalHeaderLength              = 0x1E;
+            static const size_t CentralHeaderLength            = 0x2E;
+            static const size_t EndOfDirectoryLength           = 0x16;
+            static const size_t MaxCommentLength               = 0xFFFF;
+            static const unsigned int EncryptedFlag            = 0x1;
+            static const unsigned int MethodStored             = 0;
+            static const unsigned int MethodDeflated           = 8;
+            static const size_t MaxDeflateRatio                = 1032;
+        }
+        
+        class ZipFileSystem::PreloadTask : public ThreadPool::Task {
+        private:
+            const ZipFileSystem* m_fileSystem;
+            std::vector<size_t>::const_iterator m_begin;
+            std::vector<size_t>::const_iterator m_end;
+        public:
+            PreloadTask(const ZipFileSystem* fileSystem, std::vector<size_t>::const_iterator begin, std::vector<size_t>::const_iterator end) :
+            m_fileSystem(fileSystem),
+            m_begin(begin),
+            m_end(end) {}
+        private:
+            void doRun() {
+                std::vector<size_t>::const_iterator it;
+                for (it = m_begin; it != m_end; ++it) {
+                    const size_t id = *it;
+                    if (m_fileSystem->findCachedEntry(id) != NULL)
+                        continue;
+                    try {
+                        m_fileSystem->cacheEntry(id, m_fileSystem->readEntry(id));
+                    } catch (const FileSystemException&) {
+                        // the error is reported again when the file is opened
+                    }
+                }
+            }
+        };
+
+        const size_t ZipFileSystem::DefaultCacheLimit = 64 * 1024 * 1024;
+
+        ZipFileSystem::ZipEntry::ZipEntry(const size_t i_headerAddress, const size_t i_compressedLength, const size_t i_length, const unsigned int i_method, const bool i_encrypted) :
+        headerAddress(i_headerAddress),
+        compressedLength(i_compressedLength),
+        length(i_length),
+        method(i_method),
+        encrypted(i_encrypted) {}
+
+        ZipFileSystem::ZipFileSystem(const Path& path, MappedFile::Ptr file, const size_t cacheLimit) :
+        ArchiveFileSystem(path, file),
+        m_cacheLimit(cacheLimit),
+        m_cacheSize(0) {
+            readDirectory();
+        }
+        
+        size_t ZipFileSystem::cacheSize() const {
+            wxCriticalSectionLocker lock(m_cacheLock);
+            return m_cacheSize;
+        }
+        
+        size_t ZipFileSystem::cacheLimit() const {
+            wxCriticalSectionLocker lock(m_cacheLock);
+            return m_cacheLimit;
+        }
+        
+        void ZipFileSystem::setCacheLimit(const size_t cacheLimit) {
+            wxCriticalSectionLocker lock(m_cacheLock);
+            m_cacheLimit = cacheLimit;
+            evictEntries();
+        }
+
+        void ZipFileSystem::readDirectory() {
+            const char* const endOfDirectory = findEndOfCentralDirectory();
+            if (endOfDirectory == NULL)
+                throw FileSystemException("Cannot find central directory of zip file '" + m_path.asString() + "'");
+            
+            const size_t entryCount = readSize<uint16_t>(endOfDirectory + 10);
+            const size_t directorySize = readSize<uint32_t>(endOfDirectory + 12);
+            const size_t directoryAddress = readSize<uint32_t>(endOfDirectory + 16);
+            if (directoryAddress + directorySize > m_file->size())
+                throw FileSystemException("Invalid central directory in zip file '" + m_path.asString() + "'");
+            
+            const char* cursor = m_file->begin() + directoryAddress;
+            const char* const directoryEnd = cursor + directorySize;
+            
+            m_zipEntries.reserve(entryCount);
+            for (size_t i = 0; i < entryCount; ++i) {
+                const char* const header = cursor;
+                if (header + ZipLayout::CentralHeaderLength > directoryEnd ||
+                    readUnsignedInt<uint32_t>(header) != ZipLayout::CentralHeaderSignature)
+                    throw FileSystemException("Invalid central directory in zip file '" + m_path.asString() + "'");
+                
+                const unsigned int flags = readUnsignedInt<uint16_t>(header + 8);
+                const unsigned int method = readUnsignedInt<uint16_t>(header + 10);
+                const size_t compressedLength = readSize<uint32_t>(header + 20);
+                const size_t length = readSize<uint32_t>(header + 24);
+                const size_t nameLength = readSize<uint16_t>(header + 28);
+                const size_t extraLength = readSize<uint16_t>(header + 30);
+                const size_t commentLength = readSize<uint16_t>(header + 32);
+                const size_t headerAddress = readSize<uint32_t>(header + 42);
+                
+                cursor += ZipLayout::CentralHeaderLength + nameLength + extraLength + commentLength;
+                if (cursor > directoryEnd)
+                    throw FileSystemException("Invalid central directory in zip file '" + m_path.asString() + "'");
+                
+                const String entryName(header + ZipLayout::CentralHeaderLength, nameLength);
+                const Path entryPath(StringUtils::toLower(entryName));
+                if (entryPath.isEmpty())
+                    continue;
+                
+                if (entryName[entryName.size() - 1] == '/') {
+                    addDirectory(entryPath);
+                } else {
+                    addFile(entryPath, m_zipEntries.size());
+                    m_zipEntries.push_back(ZipEntry(headerAddress, compressedLength, length, method, (flags & ZipLayout::EncryptedFlag) != 0));
+                }
+            }
+            
+            buildIndex();
+        }
+        
+        const char* ZipFileSystem::findEndOfCentralDirectory() const {
+            if (m_file->size() < ZipLayout::EndOfDirectoryLength)
+                return NULL;
+            
+            // the end of central directory record is followed by a comment of variable length
+            const size_t last = m_file->size() - ZipLayout::EndOfDirectoryLength;
+            const size_t first = last > ZipLayout::MaxCommentLength ? last - ZipLayout::MaxCommentLength : 0;
+            for (size_t offset = last + 1; offset > first; --offset) {
+                const char* const address = m_file->begin() + offset - 1;
+                if (readUnsignedInt<uint32_t>(address) == ZipLayout::EndOfDirectorySignature)
+                    return address;
+            }
+            return NULL;
+        }
+        
+        MappedFile::Ptr ZipFileSystem::readEntry(const size_t id) const {
+            const ZipEntry& entry = m_zipEntries[id];
+            if (entry.encrypted)
+                throw FileSystemException("Encrypted files are not supported in zip file '" + m_path.asString() + "'");
+            if (entry.method != ZipLayout::MethodStored && entry.method != ZipLayout::MethodDeflated)
+                throw FileSystemException("Unsupported compression method in zip file '" + m_path.asString() + "'");
+            
+            const char* const header = m_file->begin() + entry.headerAddress;
+            if (entry.headerAddress + ZipLayout::LocalHeaderLength > m_file->size() ||
+                readUnsignedInt<uint32_t>(header) != ZipLayout::LocalHeaderSignature)
+                throw FileSystemException("Invalid local file header in zip file '" + m_path.asString() + "'");
+            
+            const size_t nameLength = readSize<uint16_t>(header + 26);
+            const size_t extraLength = readSize<uint16_t>(header + 28);
+            const size_t dataAddress = entry.headerAddress + ZipLayout::LocalHeaderLength + nameLength + extraLength;
+            if (dataAddress + entry.compressedLength > m_file->size())
+                throw FileSystemException("Invalid local file header in zip file '" + m_path.asString() + "'");
+            
+            const char* const data = m_file->begin() + dataAddress;
+            if (entry.method == ZipLayout::MethodStored) {
+                // a stored entry is returned as a view of its data, which was only checked for its compressed length
+                if (entry.length != entry.compressedLength)
+                    throw FileSystemException("Invalid stored file length in zip file '" + m_path.asString() + "'");
+                return MappedFile::Ptr(new MappedFileView(data, data + entry.length));
+            }
+            
+            // deflate cannot compress data by more than its maximum ratio, so a larger length comes from a corrupt header
+            if (entry.length / ZipLayout::MaxDeflateRatio > entry.compressedLength)
+                throw FileSystemException("Invalid file length in zip file '" + m_path.asString() + "'");
+            
+            std::vector<char> buffer(entry.length);
+            if (!buffer.empty()) {
+                wxMemoryInputStream compressedStream(data, entry.compressedLength);
+                wxZlibInputStream inflateStream(compressedStream, wxZLIB_NO_HEADER);
+                inflateStream.Read(&buffer.front(), buffer.size());
+                if (inflateStream.LastRead() != buffer.size())
+                    throw FileSystemException("Cannot inflate file in zip file '" + m_path.asString() + "'");
+            }
+            return MappedFile::Ptr(new MappedFileBuffer(buffer));
+        }
+        
+        MappedFile::Ptr ZipFileSystem::findCachedEntry(const size_t id) const {
+            wxCriticalSectionLocker lock(m_cacheLock);
+            Cache::iterator it = m_cache.find(id);
+            if (it == m_cache.end())
+                return MappedFile::Ptr();
+            
+            CacheEntry& cacheEntry = it->second;
+            m_cacheOrder.splice(m_cacheOrder.begin(), m_cacheOrder, cacheEntry.position);
+            return cacheEntry.file;
+        }
+        
+        void ZipFileSystem::cacheEntry(const size_t id, MappedFile::Ptr file) const {
+            wxCriticalSectionLocker lock(m_cacheLock);
+            if (m_cache.count(id) > 0)
+                return;
+            
+            m_cacheOrder.push_front(id);
+            CacheEntry& cacheEntry = m_cache[id];
+            cacheEntry.file = file;
+            cacheEntry.position = m_cacheOrder.begin();
+            m_cacheSize += file->size();
+            evictEntries();
+        }
+        
+        void ZipFileSystem::evictEntries() const {
+            while (m_cacheSize > m_cacheLimit && !m_cacheOrder.empty()) {
+                Cache::iterator it = m_cache.find(m_cacheOrder.back());
+                assert(it != m_cache.end());
+                
+                m_cacheSize -= it->second.file->size();
+                m_cache.erase(it);
+                m_cacheOrder.pop_back();
+            }
+        }
+
+        void ZipFileSystem::doPreloadFiles(const Path::List& paths) const {
+            std::vector<size_t> ids;
+            ids.reserve(paths.size());
+            
+            Path::List::const_iterator it, end;
+            for (it = paths.begin(), end = paths.end(); it != end; ++it) {
+                size_t id;
+                if (findFile(*it, id) && m_zipEntries[id].method == ZipLayout::MethodDeflated)
+                    ids.push_back(id);
+            }
+            
+            if (ids.empty())
+                return;
+            
+            VectorUtils::sortAndRemoveDuplicates(ids);
+            
+            ThreadPool threadPool(std::min(ThreadPool::defaultThreadCount(), ids.size()));
+            const size_t taskCount = std::min(ids.size(), 4 * std::max(threadPool.threadCount(), static_cast<size_t>(1)));
+            std::vector<PreloadTask> tasks;
+            tasks.reserve(taskCount);
+            
+            ThreadPool::TaskList taskList;
+            for (size_t i = 0; i < taskCount; ++i) {
+                const size_t first = i * ids.size() / taskCount;
+                const size_t last = (i + 1) * ids.size() / taskCount;
+                tasks.push_back(PreloadTask(this,
+                                            ids.begin() + static_cast<std::vector<size_t>::difference_type>(first),
+                                            ids.begin() + static_cast<std::vector<size_t>::difference_type>(last)));
+                taskList.push_back(&tasks.back());
+            }
+            threadPool.run(taskList);
+        }
+        
+        const MappedFile::Ptr ZipFileSystem::doOpenEntry(const size_t id) const {
+            if (m_zipEntries[id].method != ZipLayout::MethodDeflated)
+                return readEntry(id);
+            
+            MappedFile::Ptr file = findCachedEntry(id);
+            if (file == NULL) {
+                file = readEntry(id);
+                cacheEntry(id, file);
+            }
+            return file;
+        }
+    }
+}
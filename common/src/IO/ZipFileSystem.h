@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_ZipFileSystem
+#define TrenchBroom_ZipFileSystem
+
+#include "IO/ArchiveFileSystem.h"
+#include "IO/Path.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <wx/thread.h>
+
+namespace TrenchBroom {
+    namespace IO {
+        /*
+         A file system backed by a zip archive such as a pk3 file. Stored entries are returned as views onto the
+         mapped archive. Deflated entries are inflated when they are opened and kept in a cache which evicts the
+         least recently opened entries once its size exceeds the cache limit.
+         */
+        class ZipFileSystem : public ArchiveFileSystem {
+        public:
+            static const size_t DefaultCacheLimit;
+        private:
+            struct ZipEntry {
+                size_t headerAddress;
+                size_t compressedLength;
+                size_t length;
+                unsigned int method;
+                bool encrypted;
+                
+                ZipEntry(size_t i_headerAddress, size_t i_compressedLength, size_t i_length, unsigned int i_method, bool i_encrypted);
+            };
+            
+            typedef std::vector<ZipEntry> ZipEntryList;
+            typedef std::list<size_t> CacheOrder;
+            
+            struct CacheEntry {
+                MappedFile::Ptr file;
+                CacheOrder::iterator position;
+            };
+            
+            typedef std::map<size_t, CacheEntry> Cache;
+            
+            class PreloadTask;
+            
+            ZipEntryList m_zipEntries;
+            size_t m_cacheLimit;
+            
+            mutable wxCriticalSection m_cacheLock;
+            mutable Cache m_cache;
+            mutable CacheOrder m_cacheOrder;
+            mutable size_t m_cacheSize;
+        public:
+            ZipFileSystem(const Path& path, MappedFile::Ptr file, size_t cacheLimit = DefaultCacheLimit);
+            
+            size_t cacheSize() const;
+            size_t cacheLimit() const;
+            void setCacheLimit(size_t cacheLimit);
+        private:
+            void readDirectory();
+            const char* findEndOfCentralDirectory() const;
+            
+            MappedFile::Ptr readEntry(size_t id) const;
+            MappedFile::Ptr findCachedEntry(size_t id) const;
+            void cacheEntry(size_t id, MappedFile::Ptr file) const;
+            void evictEntries() const;
+            
+            void doPreloadFiles(const Path::List& paths) const;
+            const MappedFile::Ptr doOpenEntry(size_t id) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_ZipFileSystem) */
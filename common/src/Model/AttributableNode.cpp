@@ -348,32 +348,38 @@ namespace TrenchBroom {
         
         AttributeNameList AttributableNode::findMissingLinkTargets() const {
             AttributeNameList result;
-            findMissingTargets(AttributeNames::Target, result);
+            findMissingTargets(AttributeNames::Target, m_linkTargets, result);
             return result;
         }
         
         AttributeNameList AttributableNode::findMissingKillTargets() const {
             AttributeNameList result;
-            findMissingTargets(AttributeNames::Killtarget, result);
+            findMissingTargets(AttributeNames::Killtarget, m_killTargets, result);
             return result;
         }
 
-        void AttributableNode::findMissingTargets(const AttributeName& prefix, AttributeNameList& result) const {
+        // The link targets are kept up to date whenever a target or targetname attribute changes, so they can be
+        // checked instead of looking up every target name in the attribute index.
+        void AttributableNode::findMissingTargets(const AttributeName& prefix, const AttributableNodeList& targets, AttributeNameList& result) const {
             const EntityAttribute::List attributes = m_attributes.numberedAttributes(prefix);
             EntityAttribute::List::const_iterator aIt, aEnd;
             for (aIt = attributes.begin(), aEnd = attributes.end(); aIt != aEnd; ++aIt) {
                 const EntityAttribute& attribute = *aIt;
                 const AttributeValue& targetname = attribute.value();
-                if (targetname.empty()) {
+                if (targetname.empty() || !hasTargetWithTargetname(targets, targetname))
                     result.push_back(attribute.name());
-                } else {
-                    AttributableNodeList linkTargets;
-                    findAttributableNodesWithAttribute(AttributeNames::Targetname, targetname, linkTargets);
-                    if (linkTargets.empty())
-                        result.push_back(attribute.name());
-                }
             }
         }
+        
+        bool AttributableNode::hasTargetWithTargetname(const AttributableNodeList& targets, const AttributeValue& targetname) const {
+            AttributableNodeList::const_iterator it, end;
+            for (it = targets.begin(), end = targets.end(); it != end; ++it) {
+                const AttributableNode* target = *it;
+                if (target->hasAttribute(AttributeNames::Targetname, targetname))
+                    return true;
+            }
+            return false;
+        }
 
         void AttributableNode::addLinks(const AttributeName& name, const AttributeValue& value) {
             if (isNumberedAttribute(AttributeNames::Target, name)) {
@@ -131,7 +131,8 @@ namespace TrenchBroom {
             AttributeNameList findMissingLinkTargets() const;
             AttributeNameList findMissingKillTargets() const;
         private: // link management internals
-            void findMissingTargets(const AttributeName& prefix, AttributeNameList& result) const;
+            void findMissingTargets(const AttributeName& prefix, const AttributableNodeList& targets, AttributeNameList& result) const;
+            bool hasTargetWithTargetname(const AttributableNodeList& targets, const AttributeValue& targetname) const;
             
             void addLinks(const AttributeName& name, const AttributeValue& value);
             void removeLinks(const AttributeName& name, const AttributeValue& value);
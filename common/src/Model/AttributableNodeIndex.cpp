@@ -20,9 +20,12 @@
 #include "AttributableNodeIndex.h"
 
 #include "CollectionUtils.h"
+#include "Exceptions.h"
 #include "Macros.h"
 #include "Model/AttributableNode.h"
+#include "Model/EntityAttributes.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace TrenchBroom {
@@ -43,16 +46,24 @@ namespace TrenchBroom {
             return AttributableNodeIndexQuery(Type_Any);
         }
         
-        AttributableNodeSet AttributableNodeIndexQuery::execute(const AttributableNodeStringIndex& index) const {
+        AttributableNodeIndexQuery::Type AttributableNodeIndexQuery::type() const {
+            return m_type;
+        }
+        
+        const String& AttributableNodeIndexQuery::pattern() const {
+            return m_pattern;
+        }
+
+        bool AttributableNodeIndexQuery::execute(const AttributeName& name) const {
             switch (m_type) {
                 case Type_Exact:
-                    return index.queryExactMatches(m_pattern);
+                    return name == m_pattern;
                 case Type_Prefix:
-                    return index.queryPrefixMatches(m_pattern);
+                    return name.compare(0, m_pattern.size(), m_pattern) == 0;
                 case Type_Numbered:
-                    return index.queryNumberedMatches(m_pattern);
+                    return isNumberedAttribute(m_pattern, name);
                 case Type_Any:
-                    return EmptyAttributableNodeSet;
+                    return true;
                 switchDefault()
             }
         }
@@ -75,6 +86,20 @@ namespace TrenchBroom {
         m_type(type),
         m_pattern(pattern) {}
 
+        AttributableNodeIndex::Entry::Entry(const AttributeName* i_name, AttributableNode* i_node) :
+        name(i_name),
+        node(i_node) {}
+        
+        bool AttributableNodeIndex::Entry::operator<(const Entry& other) const {
+            // interned names are equal if and only if their pointers are equal
+            if (name != other.name) {
+                const int cmp = name->compare(*other.name);
+                if (cmp != 0)
+                    return cmp < 0;
+            }
+            return node < other.node;
+        }
+        
         void AttributableNodeIndex::addAttributableNode(AttributableNode* attributable) {
             const EntityAttribute::List& attributes = attributable->attributes();
             EntityAttribute::List::const_iterator it, end;
@@ -94,35 +119,57 @@ namespace TrenchBroom {
         }
 
         void AttributableNodeIndex::addAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
-            m_nameIndex.insert(name, attributable);
-            m_valueIndex.insert(value, attributable);
+            m_values[value].insert(Entry(internName(name), attributable));
         }
         
         void AttributableNodeIndex::removeAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
-            m_nameIndex.remove(name, attributable);
-            m_valueIndex.remove(value, attributable);
+            ValueMap::iterator valueIt = m_values.find(value);
+            NameSet::const_iterator nameIt = m_names.find(name);
+            if (valueIt == m_values.end() || nameIt == m_names.end())
+                throw Exception("Cannot remove attribute from index.");
+            
+            EntrySet& entries = valueIt->second;
+            EntrySet::iterator entryIt = entries.find(Entry(&*nameIt, attributable));
+            if (entryIt == entries.end())
+                throw Exception("Cannot remove attribute from index.");
+            
+            // only remove one occurrence, the node may have the same attribute several times
+            entries.erase(entryIt);
+            if (entries.empty())
+                m_values.erase(valueIt);
         }
 
         AttributableNodeList AttributableNodeIndex::findAttributableNodes(const AttributableNodeIndexQuery& nameQuery, const AttributeValue& value) const {
-            const AttributableNodeSet nameResult = nameQuery.execute(m_nameIndex);
-            const AttributableNodeSet valueResult = m_valueIndex.queryExactMatches(value);
-            
-            if (nameResult.empty() || valueResult.empty())
+            ValueMap::const_iterator valueIt = m_values.find(value);
+            if (valueIt == m_values.end())
                 return EmptyAttributableNodeList;
-
-            AttributableNodeList result;
-            SetUtils::intersection(nameResult, valueResult, result);
             
-            AttributableNodeList::iterator it = result.begin();
-            while (it != result.end()) {
-                const AttributableNode* node = *it;
-                if (!nameQuery.execute(node, value))
-                    it = result.erase(it);
-                else
-                    ++it;
+            const EntrySet& entries = valueIt->second;
+            
+            // all names that match an exact, prefix or numbered query start with the pattern
+            EntrySet::const_iterator it = entries.begin();
+            if (nameQuery.type() != AttributableNodeIndexQuery::Type_Any) {
+                const AttributeName& pattern = nameQuery.pattern();
+                it = entries.lower_bound(Entry(&pattern, NULL));
             }
             
+            AttributableNodeList result;
+            while (it != entries.end()) {
+                const Entry& entry = *it;
+                if (nameQuery.type() != AttributableNodeIndexQuery::Type_Any && entry.name->compare(0, nameQuery.pattern().size(), nameQuery.pattern()) != 0)
+                    break;
+                if (nameQuery.execute(*entry.name))
+                    result.push_back(entry.node);
+                ++it;
+            }
+            
+            // a node can match several names, e.g. target1 and target2
+            VectorUtils::sortAndRemoveDuplicates(result);
             return result;
         }
+
+        const AttributeName* AttributableNodeIndex::internName(const AttributeName& name) {
+            return &*m_names.insert(name).first;
+        }
     }
 }
@@ -21,16 +21,13 @@
 #define TrenchBroom_EntityAttributeIndex
 
 #include "StringUtils.h"
+#include "UnorderedMap.h"
 #include "Model/ModelTypes.h"
-#include "StringMap.h"
 
-#include <map>
+#include <set>
 
 namespace TrenchBroom {
     namespace Model {
-        typedef StringMultiMapValueContainer<AttributableNode*> AttributableNodeIndexValueContainer;
-        typedef StringMap<AttributableNode*, AttributableNodeIndexValueContainer> AttributableNodeStringIndex;
-        
         class AttributableNodeIndexQuery {
         public:
             typedef enum {
@@ -48,16 +45,39 @@ namespace TrenchBroom {
             static AttributableNodeIndexQuery numbered(const String& pattern);
             static AttributableNodeIndexQuery any();
 
-            AttributableNodeSet execute(const AttributableNodeStringIndex& index) const;
+            Type type() const;
+            const String& pattern() const;
+            
+            bool execute(const AttributeName& name) const;
             bool execute(const AttributableNode* node, const String& value) const;
         private:
             AttributableNodeIndexQuery(Type type, const String& pattern = "");
         };
         
+        /*
+         Maps attribute values to the nodes that have them. Since every query asks for an exact value, the values are
+         kept in a hash map. For each value, the index stores an ordered multiset of (name, node) entries, so that exact,
+         prefix and numbered name queries are a lower bound search followed by a linear scan, and adding or removing
+         an entry is logarithmic in the number of nodes with that value. Attribute names are interned because there are
+         only a few distinct names in a map. An entity may contain the same attribute line more than once, so the
+         entries are counted rather than unique.
+         */
         class AttributableNodeIndex {
         private:
-            AttributableNodeStringIndex m_nameIndex;
-            AttributableNodeStringIndex m_valueIndex;
+            struct Entry {
+                const AttributeName* name;
+                AttributableNode* node;
+                
+                Entry(const AttributeName* i_name, AttributableNode* i_node);
+                bool operator<(const Entry& other) const;
+            };
+            
+            typedef std::multiset<Entry> EntrySet;
+            typedef std::set<AttributeName> NameSet;
+            typedef std::tr1::unordered_map<AttributeValue, EntrySet> ValueMap;
+            
+            NameSet m_names;
+            ValueMap m_values;
         public:
             void addAttributableNode(AttributableNode* attributable);
             void removeAttributableNode(AttributableNode* attributable);
@@ -65,7 +85,10 @@ namespace TrenchBroom {
             void addAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
             void removeAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
             
-            AttributableNodeList findAttributableNodes(const AttributableNodeIndexQuery& keyQuery, const AttributeValue& value) const;
+            // The any query matches every node that has the given value in any of its attributes.
+            AttributableNodeList findAttributableNodes(const AttributableNodeIndexQuery& nameQuery, const AttributeValue& value) const;
+        private:
+            const AttributeName* internName(const AttributeName& name);
         };
     }
 }
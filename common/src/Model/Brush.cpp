@@ -20,9 +20,11 @@
 #include "Brush.h"
 
 #include "CollectionUtils.h"
+#include "ThreadPool.h"
 #include "Model/BrushContentTypeBuilder.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
+#include "Model/BrushGeometryCache.h"
 #include "Model/BrushSnapshot.h"
 #include "Model/Entity.h"
 #include "Model/FindContainerVisitor.h"
@@ -34,6 +36,9 @@
 #include "Model/PickResult.h"
 #include "Model/World.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace TrenchBroom {
     namespace Model {
         const Hit::HitType Brush::BrushHit = Hit::freeHitType();
@@ -129,6 +134,48 @@ namespace TrenchBroom {
             }
         };
 
+        class Brush::UpdateGeometryTask : public ThreadPool::Task {
+        private:
+            BrushList::const_iterator m_begin;
+            BrushList::const_iterator m_end;
+            BBox3 m_worldBounds;
+            const Mat4x4* m_transformation;
+            bool m_lockTextures;
+            bool m_findPlanePoints;
+            GeometryErrorList m_errors;
+        public:
+            UpdateGeometryTask(BrushList::const_iterator begin, BrushList::const_iterator end, const BBox3& worldBounds, const Mat4x4* transformation, const bool lockTextures, const bool findPlanePoints) :
+            m_begin(begin),
+            m_end(end),
+            m_worldBounds(worldBounds),
+            m_transformation(transformation),
+            m_lockTextures(lockTextures),
+            m_findPlanePoints(findPlanePoints) {}
+            
+            const GeometryErrorList& errors() const {
+                return m_errors;
+            }
+        private:
+            void doRun() {
+                BrushList::const_iterator it;
+                for (it = m_begin; it != m_end; ++it) {
+                    Brush* brush = *it;
+                    try {
+                        if (m_transformation != NULL)
+                            brush->transformFaces(*m_transformation, m_lockTextures);
+                        if (m_findPlanePoints)
+                            brush->findFaceIntegerPlanePoints();
+                        brush->buildGeometry(m_worldBounds);
+                    } catch (const std::exception& e) {
+                        // the thread pool swallows any exception, so every error must be recorded here
+                        m_errors.push_back(std::make_pair(brush, String(e.what())));
+                    } catch (...) {
+                        m_errors.push_back(std::make_pair(brush, String("Unknown error")));
+                    }
+                }
+            }
+        };
+        
         class Brush::CanMoveBoundaryCallback : public BrushGeometry::Callback {
         private:
             BrushFace* m_addedFace;
@@ -846,29 +893,126 @@ namespace TrenchBroom {
         }
 
         void Brush::rebuildGeometry(const BBox3& worldBounds) {
-            delete m_geometry;
-            m_geometry = new BrushGeometry(worldBounds.expanded(1.0));
-            
-            AddFacesToGeometry addFacesToGeometry(*m_geometry, m_faces);
-            updateFacesFromGeometry(worldBounds);
-            if (addFacesToGeometry.brushEmpty())
-                throw GeometryException("Brush is empty");
-            if (!addFacesToGeometry.brushValid())
-                throw GeometryException("Brush is invalid");
-            if (!fullySpecified())
-                throw GeometryException("Brush is not fully specified");
+            buildGeometry(worldBounds);
             nodeBoundsDidChange();
         }
-
+        
         void Brush::findIntegerPlanePoints(const BBox3& worldBounds) {
             const NotifyNodeChange nodeChange(this);
+            findFaceIntegerPlanePoints();
+            rebuildGeometry(worldBounds);
+        }
+        
+        Brush::GeometryErrorList Brush::rebuildGeometry(const BrushList& brushes, const BBox3& worldBounds, ThreadPool& threadPool) {
+            return updateGeometry(brushes, worldBounds, NULL, false, false, threadPool);
+        }
+        
+        Brush::GeometryErrorList Brush::findIntegerPlanePoints(const BrushList& brushes, const BBox3& worldBounds, ThreadPool& threadPool) {
+            return updateGeometry(brushes, worldBounds, NULL, false, true, threadPool);
+        }
+        
+        Brush::GeometryErrorList Brush::transformBrushes(const BrushList& brushes, const Mat4x4& transformation, const bool lockTextures, const BBox3& worldBounds, ThreadPool& threadPool) {
+            return updateGeometry(brushes, worldBounds, &transformation, lockTextures, false, threadPool);
+        }
+
+        Brush::GeometryErrorList Brush::updateGeometry(const BrushList& brushes, const BBox3& worldBounds, const Mat4x4* transformation, const bool lockTextures, const bool findPlanePoints, ThreadPool& threadPool) {
+            BrushList::const_iterator it, end;
+            for (it = brushes.begin(), end = brushes.end(); it != end; ++it) {
+                Brush* brush = *it;
+                brush->nodeWillChange();
+            }
+            
+            const size_t taskCount = std::min(brushes.size(), 4 * std::max(threadPool.threadCount(), static_cast<size_t>(1)));
+            std::vector<UpdateGeometryTask> tasks;
+            tasks.reserve(taskCount);
+            
+            ThreadPool::TaskList taskList;
+            for (size_t i = 0; i < taskCount; ++i) {
+                const size_t first = i * brushes.size() / taskCount;
+                const size_t last = (i + 1) * brushes.size() / taskCount;
+                tasks.push_back(UpdateGeometryTask(brushes.begin() + static_cast<BrushList::difference_type>(first),
+                                                   brushes.begin() + static_cast<BrushList::difference_type>(last),
+                                                   worldBounds, transformation, lockTextures, findPlanePoints));
+                taskList.push_back(&tasks.back());
+            }
+            threadPool.run(taskList);
+            
+            for (it = brushes.begin(), end = brushes.end(); it != end; ++it) {
+                Brush* brush = *it;
+                brush->nodeBoundsDidChange();
+                brush->nodeDidChange();
+            }
+            
+            GeometryErrorList errors;
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                const GeometryErrorList& taskErrors = tasks[i].errors();
+                errors.insert(errors.end(), taskErrors.begin(), taskErrors.end());
+            }
+            return errors;
+        }
+        
+        void Brush::buildGeometry(const BBox3& worldBounds) {
+            delete m_geometry;
+            m_geometry = NULL;
             
+            BrushGeometryCache& cache = BrushGeometryCache::instance();
+            const BrushGeometryCache::Key key(worldBounds, m_faces);
+            
+            BrushGeometryCache::FaceIndices faceIndices;
+            m_geometry = cache.find(key, faceIndices);
+            if (m_geometry != NULL) {
+                setFacesFromCachedGeometry(faceIndices);
+                updateFacesFromGeometry(worldBounds);
+            } else {
+                const BrushFaceList faces = m_faces;
+                m_geometry = new BrushGeometry(worldBounds.expanded(1.0));
+                
+                AddFacesToGeometry addFacesToGeometry(*m_geometry, m_faces);
+                updateFacesFromGeometry(worldBounds);
+                if (addFacesToGeometry.brushEmpty())
+                    throw GeometryException("Brush is empty");
+                if (!addFacesToGeometry.brushValid())
+                    throw GeometryException("Brush is invalid");
+                if (!fullySpecified())
+                    throw GeometryException("Brush is not fully specified");
+                cache.insert(key, faces, *m_geometry);
+            }
+        }
+        
+        void Brush::setFacesFromCachedGeometry(const std::vector<size_t>& faceIndices) {
+            assert(faceIndices.size() == m_geometry->faceCount());
+            
+            std::vector<bool> usedFaces(m_faces.size(), false);
+            
+            size_t index = 0;
+            BrushFaceGeometry* first = m_geometry->faces().front();
+            BrushFaceGeometry* current = first;
+            do {
+                BrushFace* face = m_faces[faceIndices[index]];
+                current->setPayload(face);
+                face->setGeometry(current);
+                usedFaces[faceIndices[index]] = true;
+                
+                current = current->next();
+                ++index;
+            } while (current != first);
+            
+            // these faces were dropped when the geometry was built
+            for (size_t i = 0; i < m_faces.size(); ++i) {
+                if (!usedFaces[i]) {
+                    BrushFace* face = m_faces[i];
+                    assert(!face->selected());
+                    delete face;
+                }
+            }
+        }
+
+        void Brush::findFaceIntegerPlanePoints() {
             BrushFaceList::const_iterator it, end;
             for (it = m_faces.begin(), end = m_faces.end(); it != end; ++it) {
                 BrushFace* brushFace = *it;
                 brushFace->findIntegerPlanePoints();
             }
-            rebuildGeometry(worldBounds);
         }
 
         bool Brush::checkGeometry() const {
@@ -1004,6 +1148,16 @@ namespace TrenchBroom {
             if (containsPoint(point))
                 result.push_back(this);
         }
+        
+        void Brush::doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result) {
+            if (bounds().intersects(frustum))
+                result.push_back(this);
+        }
+        
+        void Brush::doFindNodesIntersecting(const BBox3& bounds, NodeList& result) {
+            if (this->bounds().intersects(bounds))
+                result.push_back(this);
+        }
 
         FloatType Brush::doIntersectWithRay(const Ray3& ray) const {
             const BrushFaceHit hit = findFaceHit(ray);
@@ -1018,14 +1172,39 @@ namespace TrenchBroom {
             if (Math::isnan(bounds().intersectWithRay(ray)))
                 return BrushFaceHit();
             
+            // Since the brush is convex, the ray enters it through the face whose plane it enters last, unless it
+            // leaves the brush through another face's plane before that. This only requires one plane test per
+            // face instead of testing the ray against the face polygons.
+            BrushFace* entryFace = NULL;
+            FloatType entryDistance = -std::numeric_limits<FloatType>::max();
+            FloatType exitDistance = std::numeric_limits<FloatType>::max();
+            
             BrushFaceList::const_iterator it, end;
             for (it = m_faces.begin(), end = m_faces.end(); it != end; ++it) {
                 BrushFace* face = *it;
-                const FloatType distance = face->intersectWithRay(ray);
-                if (!Math::isnan(distance))
-                    return BrushFaceHit(face, distance);
+                const Plane3& boundary = face->boundary();
+                
+                const FloatType dot = boundary.normal.dot(ray.direction);
+                const FloatType originDistance = boundary.pointDistance(ray.origin);
+                if (Math::neg(dot)) {
+                    const FloatType distance = -originDistance / dot;
+                    if (distance > entryDistance) {
+                        entryFace = face;
+                        entryDistance = distance;
+                    }
+                } else if (Math::pos(dot)) {
+                    const FloatType distance = -originDistance / dot;
+                    if (distance < exitDistance)
+                        exitDistance = distance;
+                } else if (boundary.pointStatus(ray.origin) == Math::PointStatus::PSAbove) {
+                    // the ray is parallel to and outside of this face
+                    return BrushFaceHit();
+                }
             }
-            return BrushFaceHit();
+            
+            if (entryFace == NULL || Math::neg(entryDistance) || Math::gt(entryDistance, exitDistance))
+                return BrushFaceHit();
+            return BrushFaceHit(entryFace, entryDistance);
         }
 
         Node* Brush::doGetContainer() const {
@@ -1048,13 +1227,16 @@ namespace TrenchBroom {
         
         void Brush::doTransform(const Mat4x4& transformation, bool lockTextures, const BBox3& worldBounds) {
             const NotifyNodeChange nodeChange(this);
-
+            transformFaces(transformation, lockTextures);
+            rebuildGeometry(worldBounds);
+        }
+        
+        void Brush::transformFaces(const Mat4x4& transformation, const bool lockTextures) {
             BrushFaceList::const_iterator it, end;
             for (it = m_faces.begin(), end = m_faces.end(); it != end; ++it) {
                 BrushFace* face = *it;
                 face->transform(transformation, lockTextures);
             }
-            rebuildGeometry(worldBounds);
         }
         
         class Brush::Contains : public ConstNodeVisitor, public NodeQuery<bool> {
@@ -30,6 +30,8 @@
 #include "Model/Object.h"
 
 namespace TrenchBroom {
+    class ThreadPool;
+    
     namespace Model {
         struct BrushAlgorithmResult;
         class BrushContentTypeBuilder;
@@ -57,6 +59,7 @@ namespace TrenchBroom {
             class CanMoveBoundary;
             class MoveVerticesCallback;
             class QueryCallback;
+            class UpdateGeometryTask;
         public:
             typedef ConstProjectingSequence<BrushVertexList, ProjectToVertex> VertexList;
             typedef ConstProjectingSequence<BrushEdgeList, ProjectToEdge> EdgeList;
@@ -165,9 +168,26 @@ namespace TrenchBroom {
             void updateFacesFromGeometry(const BBox3& worldBounds);
             void updatePointsFromVertices(const BBox3& worldBounds);
         public: // brush geometry
+            typedef std::pair<Brush*, String> GeometryError;
+            typedef std::vector<GeometryError> GeometryErrorList;
+            
             void rebuildGeometry(const BBox3& worldBounds);
             void findIntegerPlanePoints(const BBox3& worldBounds);
+            
+            // Process the given brushes on the given thread pool. The brushes and their parents are notified on the
+            // calling thread before and after. Brushes whose geometry cannot be built do not stop the others from
+            // being processed, they are returned together with the error messages.
+            static GeometryErrorList rebuildGeometry(const BrushList& brushes, const BBox3& worldBounds, ThreadPool& threadPool);
+            static GeometryErrorList findIntegerPlanePoints(const BrushList& brushes, const BBox3& worldBounds, ThreadPool& threadPool);
+            static GeometryErrorList transformBrushes(const BrushList& brushes, const Mat4x4& transformation, bool lockTextures, const BBox3& worldBounds, ThreadPool& threadPool);
         private:
+            static GeometryErrorList updateGeometry(const BrushList& brushes, const BBox3& worldBounds, const Mat4x4* transformation, bool lockTextures, bool findPlanePoints, ThreadPool& threadPool);
+            
+            // these don't notify the parents
+            void buildGeometry(const BBox3& worldBounds);
+            void findFaceIntegerPlanePoints();
+            void transformFaces(const Mat4x4& transformation, bool lockTextures);
+            void setFacesFromCachedGeometry(const std::vector<size_t>& faceIndices);
             bool checkGeometry() const;
         public: // content type
             bool transparent() const;
@@ -199,6 +219,8 @@ namespace TrenchBroom {
         private: // implement Object interface
             void doPick(const Ray3& ray, PickResult& pickResult) const;
             void doFindNodesContaining(const Vec3& point, NodeList& result);
+            void doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result);
+            void doFindNodesIntersecting(const BBox3& bounds, NodeList& result);
             FloatType doIntersectWithRay(const Ray3& ray) const;
 
             struct BrushFaceHit {
@@ -47,11 +47,11 @@ namespace TrenchBroom {
         m_brush(NULL),
         m_lineNumber(0),
         m_lineCount(0),
-        m_selected(false),
         m_texCoordSystem(texCoordSystem),
         m_geometry(NULL),
         m_vertexIndex(0),
         m_cachedVertices(0),
+        m_selected(false),
         m_verticesValid(false),
         m_attribs(attribs) {
             assert(m_texCoordSystem != NULL);
@@ -126,6 +126,10 @@ namespace TrenchBroom {
             return new BrushFaceSnapshot(this, m_texCoordSystem);
         }
 
+        TexCoordSystem* BrushFace::cloneTexCoordSystem() const {
+            return m_texCoordSystem->clone();
+        }
+
         Brush* BrushFace::brush() const {
             return m_brush;
         }
@@ -524,6 +528,14 @@ namespace TrenchBroom {
             invalidateVertexCache();
         }
 
+        size_t BrushFace::lineNumber() const {
+            return m_lineNumber;
+        }
+        
+        size_t BrushFace::lineCount() const {
+            return m_lineCount;
+        }
+        
         void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
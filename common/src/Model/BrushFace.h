@@ -86,13 +86,15 @@ namespace TrenchBroom {
             Plane3 m_boundary;
             size_t m_lineNumber;
             size_t m_lineCount;
-            bool m_selected;
             
             TexCoordSystem* m_texCoordSystem;
             BrushFaceGeometry* m_geometry;
             
             mutable size_t m_vertexIndex;
             mutable Vertex::List m_cachedVertices;
+            
+            // the flags are declared next to each other to avoid padding
+            bool m_selected;
             mutable bool m_verticesValid;
         protected:
             BrushFaceAttributes m_attribs;
@@ -109,6 +111,7 @@ namespace TrenchBroom {
             BrushFace* clone() const;
             
             BrushFaceSnapshot* takeSnapshot();
+            TexCoordSystem* cloneTexCoordSystem() const;
 
             Brush* brush() const;
             void setBrush(Brush* brush);
@@ -184,6 +187,8 @@ namespace TrenchBroom {
             void setGeometry(BrushFaceGeometry* geometry);
             void invalidate();
             
+            size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(const size_t lineNumber, const size_t lineCount);
             
             bool selected() const;
@@ -20,10 +20,42 @@
 #include "BrushFaceAttributes.h"
 #include "Assets/Texture.h"
 
+#include <set>
+
+#include <wx/thread.h>
+
 namespace TrenchBroom {
     namespace Model {
+        class TextureNameTable {
+        private:
+            typedef std::set<String> NameSet;
+            
+            mutable wxCriticalSection m_lock;
+            NameSet m_names;
+        public:
+            // The returned pointer remains valid for the lifetime of the table since names are never removed.
+            const String* intern(const String& name) {
+                wxCriticalSectionLocker lock(m_lock);
+                return &*m_names.insert(name).first;
+            }
+            
+            size_t size() const {
+                wxCriticalSectionLocker lock(m_lock);
+                return m_names.size();
+            }
+        };
+        
+        static TextureNameTable& textureNameTable() {
+            static TextureNameTable table;
+            return table;
+        }
+        
+        // Faces are first created by the map parse worker threads, but the initialization of function local statics is
+        // not thread safe with all supported compilers, so the table is initialized at startup.
+        static TextureNameTable& EagerTextureNameTable = textureNameTable();
+        
         BrushFaceAttributes::BrushFaceAttributes(const String& textureName) :
-        m_textureName(textureName),
+        m_textureName(internTextureName(textureName)),
         m_texture(NULL),
         m_offset(Vec2f::Null),
         m_scale(Vec2f(1.0f, 1.0f)),
@@ -69,7 +101,7 @@ namespace TrenchBroom {
         }
 
         BrushFaceAttributes BrushFaceAttributes::takeSnapshot() const {
-            BrushFaceAttributes result(m_textureName);
+            BrushFaceAttributes result(*m_textureName);
             result.m_offset = m_offset;
             result.m_scale = m_scale;
             result.m_rotation = m_rotation;
@@ -80,7 +112,7 @@ namespace TrenchBroom {
         }
 
         const String& BrushFaceAttributes::textureName() const {
-            return m_textureName;
+            return *m_textureName;
         }
         
         Assets::Texture* BrushFaceAttributes::texture() const {
@@ -145,7 +177,8 @@ namespace TrenchBroom {
             m_texture = texture;
             if (m_texture != NULL) {
                 m_texture->incUsageCount();
-                m_textureName = m_texture->name();
+                if (*m_textureName != m_texture->name())
+                    m_textureName = internTextureName(m_texture->name());
             }
         }
         
@@ -188,5 +221,13 @@ namespace TrenchBroom {
         void BrushFaceAttributes::setSurfaceValue(const float surfaceValue) {
             m_surfaceValue = surfaceValue;
         }
+
+        size_t BrushFaceAttributes::textureNameCount() {
+            return textureNameTable().size();
+        }
+
+        const String* BrushFaceAttributes::internTextureName(const String& textureName) {
+            return textureNameTable().intern(textureName);
+        }
     }
 }
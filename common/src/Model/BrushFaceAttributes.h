@@ -32,7 +32,8 @@ namespace TrenchBroom {
     namespace Model {
         class BrushFaceAttributes {
         private:
-            String m_textureName;
+            // texture names are interned since many faces share the same few textures
+            const String* m_textureName;
             Assets::Texture* m_texture;
             
             Vec2f m_offset;
@@ -81,6 +82,10 @@ namespace TrenchBroom {
             void setSurfaceContents(int surfaceContents);
             void setSurfaceFlags(int surfaceFlags);
             void setSurfaceValue(float surfaceValue);
+            
+            static size_t textureNameCount();
+        private:
+            static const String* internTextureName(const String& textureName);
         };
     }
 }
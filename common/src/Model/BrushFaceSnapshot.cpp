@@ -19,6 +19,8 @@
 
 #include "BrushFaceSnapshot.h"
 
+#include "Model/ParallelTexCoordSystem.h"
+
 namespace TrenchBroom {
     namespace Model {
         BrushFaceSnapshot::BrushFaceSnapshot(BrushFace* face, TexCoordSystem* coordSystem) :
@@ -36,5 +38,9 @@ namespace TrenchBroom {
             if (m_coordSystem != NULL)
                 m_coordSystem->restore();
         }
+
+        size_t BrushFaceSnapshot::memorySize() const {
+            return sizeof(BrushFaceSnapshot) + (m_coordSystem != NULL ? sizeof(ParallelTexCoordSystemSnapshot) : 0);
+        }
     }
 }
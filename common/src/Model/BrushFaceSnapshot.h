@@ -33,6 +33,7 @@ namespace TrenchBroom {
             BrushFaceSnapshot(BrushFace* face, TexCoordSystem* coordSystem);
             ~BrushFaceSnapshot();
             void restore();
+            size_t memorySize() const;
         };
     }
 }
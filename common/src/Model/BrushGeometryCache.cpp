@@ -0,0 +1,208 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrushGeometryCache.h"
+
+#include "Model/BrushFace.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Model {
+        class BrushGeometryCache::Entry {
+        public:
+            EntryMap::iterator position;
+            EntryList::iterator recentlyUsedPosition;
+            BrushGeometry geometry;
+            FaceIndices faceIndices;
+            size_t memoryUsage;
+            
+            Entry(const BrushGeometry& i_geometry, const FaceIndices& i_faceIndices) :
+            geometry(i_geometry),
+            faceIndices(i_faceIndices),
+            memoryUsage(0) {}
+        };
+
+        BrushGeometryCache::Key::Key(const BBox3& worldBounds, const BrushFaceList& faces) :
+        m_worldBounds(worldBounds) {
+            m_boundaries.reserve(faces.size());
+            BrushFaceList::const_iterator it, end;
+            for (it = faces.begin(), end = faces.end(); it != end; ++it) {
+                const BrushFace* face = *it;
+                m_boundaries.push_back(face->boundary());
+            }
+        }
+        
+        bool BrushGeometryCache::Key::operator<(const Key& other) const {
+            if (m_boundaries.size() != other.m_boundaries.size())
+                return m_boundaries.size() < other.m_boundaries.size();
+            if (m_worldBounds.min != other.m_worldBounds.min)
+                return m_worldBounds.min < other.m_worldBounds.min;
+            if (m_worldBounds.max != other.m_worldBounds.max)
+                return m_worldBounds.max < other.m_worldBounds.max;
+            return std::lexicographical_compare(m_boundaries.begin(), m_boundaries.end(),
+                                                other.m_boundaries.begin(), other.m_boundaries.end());
+        }
+
+        size_t BrushGeometryCache::Key::memoryUsage() const {
+            return sizeof(Key) + m_boundaries.capacity() * sizeof(Plane3);
+        }
+
+        BrushGeometryCache& BrushGeometryCache::instance() {
+            static BrushGeometryCache instance;
+            return instance;
+        }
+        
+        // The instance is first used by the map parse and geometry worker threads, but the initialization of function
+        // local statics is not thread safe with all supported compilers, so it is initialized at startup.
+        static const BrushGeometryCache& EagerInstance = BrushGeometryCache::instance();
+
+        BrushGeometryCache::BrushGeometryCache(const size_t memoryLimit) :
+        m_memoryUsage(0),
+        m_memoryLimit(memoryLimit),
+        m_hits(0),
+        m_misses(0) {}
+        
+        BrushGeometryCache::~BrushGeometryCache() {
+            clear();
+        }
+
+        BrushGeometry* BrushGeometryCache::find(const Key& key, FaceIndices& faceIndices) {
+            wxCriticalSectionLocker lock(m_lock);
+            
+            EntryMap::iterator it = m_entries.find(key);
+            if (it == m_entries.end()) {
+                ++m_misses;
+                return NULL;
+            }
+            
+            ++m_hits;
+            Entry* entry = it->second;
+            touch(entry);
+            
+            faceIndices = entry->faceIndices;
+            return new BrushGeometry(entry->geometry);
+        }
+
+        void BrushGeometryCache::insert(const Key& key, const BrushFaceList& faces, const BrushGeometry& geometry) {
+            typedef std::map<const BrushFace*, size_t> FaceIndexMap;
+            
+            FaceIndexMap faceIndexMap;
+            for (size_t i = 0; i < faces.size(); ++i)
+                faceIndexMap[faces[i]] = i;
+            
+            FaceIndices faceIndices;
+            faceIndices.reserve(geometry.faceCount());
+            
+            const BrushGeometry::FaceList& geometryFaces = geometry.faces();
+            BrushGeometry::FaceList::const_iterator it, end;
+            for (it = geometryFaces.begin(), end = geometryFaces.end(); it != end; ++it) {
+                const BrushFaceGeometry* faceGeometry = *it;
+                const FaceIndexMap::const_iterator indexIt = faceIndexMap.find(faceGeometry->payload());
+                if (indexIt == faceIndexMap.end())
+                    return;
+                faceIndices.push_back(indexIt->second);
+            }
+            
+            const size_t memoryUsage = (key.memoryUsage() +
+                                        sizeof(Entry) +
+                                        faceIndices.capacity() * sizeof(size_t) +
+                                        geometry.vertexCount() * sizeof(BrushVertex) +
+                                        geometry.edgeCount() * (sizeof(BrushEdge) + 2 * sizeof(BrushHalfEdge)) +
+                                        geometry.faceCount() * sizeof(BrushFaceGeometry));
+
+            wxCriticalSectionLocker lock(m_lock);
+            if (memoryUsage > m_memoryLimit || m_entries.count(key) > 0)
+                return;
+            
+            Entry* entry = new Entry(geometry, faceIndices);
+            entry->memoryUsage = memoryUsage;
+            entry->position = m_entries.insert(std::make_pair(key, entry)).first;
+            entry->recentlyUsedPosition = m_recentlyUsed.insert(m_recentlyUsed.end(), entry);
+            m_memoryUsage += memoryUsage;
+            
+            evict();
+        }
+
+        void BrushGeometryCache::clear() {
+            wxCriticalSectionLocker lock(m_lock);
+            while (!m_entries.empty())
+                removeEntry(m_entries.begin());
+            assert(m_recentlyUsed.empty());
+            assert(m_memoryUsage == 0);
+            
+            m_hits = 0;
+            m_misses = 0;
+        }
+
+        size_t BrushGeometryCache::hits() const {
+            wxCriticalSectionLocker lock(m_lock);
+            return m_hits;
+        }
+        
+        size_t BrushGeometryCache::misses() const {
+            wxCriticalSectionLocker lock(m_lock);
+            return m_misses;
+        }
+
+        size_t BrushGeometryCache::entryCount() const {
+            wxCriticalSectionLocker lock(m_lock);
+            return m_entries.size();
+        }
+
+        size_t BrushGeometryCache::memoryUsage() const {
+            wxCriticalSectionLocker lock(m_lock);
+            return m_memoryUsage;
+        }
+        
+        size_t BrushGeometryCache::memoryLimit() const {
+            wxCriticalSectionLocker lock(m_lock);
+            return m_memoryLimit;
+        }
+        
+        void BrushGeometryCache::setMemoryLimit(const size_t memoryLimit) {
+            wxCriticalSectionLocker lock(m_lock);
+            m_memoryLimit = memoryLimit;
+            evict();
+        }
+
+        void BrushGeometryCache::touch(Entry* entry) {
+            m_recentlyUsed.splice(m_recentlyUsed.end(), m_recentlyUsed, entry->recentlyUsedPosition);
+        }
+
+        void BrushGeometryCache::evict() {
+            while (m_memoryUsage > m_memoryLimit) {
+                assert(!m_recentlyUsed.empty());
+                Entry* entry = m_recentlyUsed.front();
+                removeEntry(entry->position);
+            }
+        }
+
+        void BrushGeometryCache::removeEntry(EntryMap::iterator it) {
+            Entry* entry = it->second;
+            assert(m_memoryUsage >= entry->memoryUsage);
+            
+            m_memoryUsage -= entry->memoryUsage;
+            m_recentlyUsed.erase(entry->recentlyUsedPosition);
+            m_entries.erase(it);
+            delete entry;
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_BrushGeometryCache
+#define TrenchBroom_BrushGeometryCache
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "Model/BrushGeometry.h"
+#include "Model/ModelTypes.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <wx/thread.h>
+
+namespace TrenchBroom {
+    namespace Model {
+        /*
+         Caches the geometry of brushes by the boundaries of their faces and the world bounds. Brushes with the same
+         planes as a brush that was built before (e.g. clones, restored snapshots or duplicate brushes in a map file)
+         copy the cached geometry instead of clipping a new one. Least recently used entries are evicted once the
+         estimated memory usage exceeds the memory limit. The cache may be accessed from multiple threads.
+         */
+        class BrushGeometryCache {
+        public:
+            // maps each face of a cached geometry to the index of the brush face that created it
+            typedef std::vector<size_t> FaceIndices;
+            
+            class Key {
+            private:
+                BBox3 m_worldBounds;
+                std::vector<Plane3> m_boundaries;
+            public:
+                Key(const BBox3& worldBounds, const BrushFaceList& faces);
+                
+                bool operator<(const Key& other) const;
+                size_t memoryUsage() const;
+            };
+            
+            static const size_t DefaultMemoryLimit = 32 * 1024 * 1024;
+        private:
+            class Entry;
+            typedef std::map<Key, Entry*> EntryMap;
+            typedef std::list<Entry*> EntryList;
+            
+            mutable wxCriticalSection m_lock;
+            EntryMap m_entries;
+            EntryList m_recentlyUsed;
+            size_t m_memoryUsage;
+            size_t m_memoryLimit;
+            size_t m_hits;
+            size_t m_misses;
+        public:
+            static BrushGeometryCache& instance();
+            
+            BrushGeometryCache(size_t memoryLimit = DefaultMemoryLimit);
+            ~BrushGeometryCache();
+            
+            // Returns a new copy of the cached geometry or NULL if there is none. The face payloads of the returned
+            // geometry are not set, use the given face indices to map them to the brush faces the key was created from.
+            BrushGeometry* find(const Key& key, FaceIndices& faceIndices);
+            
+            // The given faces are the faces the key was created from, they are only used to identify the payloads of
+            // the geometry's faces by their addresses and may have been deleted already.
+            void insert(const Key& key, const BrushFaceList& faces, const BrushGeometry& geometry);
+            
+            // Removes all entries and resets the hit and miss counters.
+            void clear();
+            
+            size_t hits() const;
+            size_t misses() const;
+            size_t entryCount() const;
+            size_t memoryUsage() const;
+            size_t memoryLimit() const;
+            void setMemoryLimit(size_t memoryLimit);
+        private:
+            void touch(Entry* entry);
+            void evict();
+            void removeEntry(EntryMap::iterator it);
+            
+            BrushGeometryCache(const BrushGeometryCache& other);
+            BrushGeometryCache& operator=(const BrushGeometryCache& other);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_BrushGeometryCache) */
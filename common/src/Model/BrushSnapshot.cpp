@@ -19,33 +19,69 @@
 
 #include "BrushSnapshot.h"
 
-#include "CollectionUtils.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
+#include "Model/ParaxialTexCoordSystem.h"
+#include "Model/TexCoordSystem.h"
 
 namespace TrenchBroom {
     namespace Model {
+        BrushSnapshot::FaceState::FaceState(const BrushFace* face) :
+        attribs(face->attribs()),
+        texCoordSystem(face->cloneTexCoordSystem()),
+        lineNumber(face->lineNumber()),
+        lineCount(face->lineCount()),
+        selected(face->selected()) {
+            for (size_t i = 0; i < 3; ++i)
+                points[i] = face->points()[i];
+        }
+
         BrushSnapshot::BrushSnapshot(Brush* brush) :
         m_brush(brush) {
             takeSnapshot(brush);
         }
 
         BrushSnapshot::~BrushSnapshot() {
-            VectorUtils::clearAndDelete(m_faces);
+            FaceStateList::const_iterator it, end;
+            for (it = m_faces.begin(), end = m_faces.end(); it != end; ++it)
+                delete it->texCoordSystem;
+            m_faces.clear();
         }
 
         void BrushSnapshot::takeSnapshot(Brush* brush) {
             const BrushFaceList& faces = brush->faces();
+            m_faces.reserve(faces.size());
+            
             BrushFaceList::const_iterator it, end;
             for (it = faces.begin(), end = faces.end(); it != end; ++it) {
-                BrushFace* face = *it;
-                m_faces.push_back(face->clone());
+                const BrushFace* face = *it;
+                m_faces.push_back(FaceState(face));
             }
         }
         
         void BrushSnapshot::doRestore(const BBox3& worldBounds) {
-            m_brush->setFaces(worldBounds, m_faces);
+            BrushFaceList faces;
+            faces.reserve(m_faces.size());
+            
+            FaceStateList::iterator it, end;
+            for (it = m_faces.begin(), end = m_faces.end(); it != end; ++it) {
+                FaceState& state = *it;
+                BrushFace* face = new BrushFace(state.points[0], state.points[1], state.points[2], state.attribs, state.texCoordSystem);
+                face->setFilePosition(state.lineNumber, state.lineCount);
+                if (state.selected)
+                    face->select();
+                state.texCoordSystem = NULL;
+                faces.push_back(face);
+            }
             m_faces.clear();
+            
+            // if the restored planes match a cached polyhedron, the geometry is not rebuilt
+            m_brush->setFaces(worldBounds, faces);
+        }
+
+        size_t BrushSnapshot::doGetMemorySize() const {
+            // paraxial texture coordinate systems are the larger of the two kinds
+            return sizeof(BrushSnapshot) + m_faces.capacity() * (sizeof(FaceState) + sizeof(ParaxialTexCoordSystem));
         }
     }
 }
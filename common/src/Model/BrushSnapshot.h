@@ -20,6 +20,9 @@
 #ifndef TrenchBroom_BrushSnapshot
 #define TrenchBroom_BrushSnapshot
 
+#include "VecMath.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/ModelTypes.h"
 #include "Model/NodeSnapshot.h"
 
@@ -28,18 +31,35 @@
 namespace TrenchBroom {
     namespace Model {
         class Brush;
-        class BrushFaceSnapshot;
+        class TexCoordSystem;
         
         class BrushSnapshot : public NodeSnapshot {
         private:
+            // the state of a face is stored by value instead of as a cloned face
+            struct FaceState {
+                BrushFace::Points points;
+                BrushFaceAttributes attribs;
+                TexCoordSystem* texCoordSystem;
+                size_t lineNumber;
+                size_t lineCount;
+                bool selected;
+                
+                FaceState(const BrushFace* face);
+            };
+            typedef std::vector<FaceState> FaceStateList;
+            
             Brush* m_brush;
-            BrushFaceList m_faces;
+            FaceStateList m_faces;
         public:
             BrushSnapshot(Brush* brush);
             ~BrushSnapshot();
         private:
             void takeSnapshot(Brush* brush);
             void doRestore(const BBox3& worldBounds);
+            size_t doGetMemorySize() const;
+            
+            BrushSnapshot(const BrushSnapshot&);
+            BrushSnapshot& operator=(const BrushSnapshot&);
         };
     }
 }
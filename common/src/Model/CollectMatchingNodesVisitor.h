@@ -21,6 +21,7 @@
 #define TrenchBroom_CollectMatchingNodesVisitor
 
 #include "CollectionUtils.h"
+#include "ThreadPool.h"
 #include "Model/NodeVisitor.h"
 #include "Model/Brush.h"
 #include "Model/Entity.h"
@@ -109,6 +110,86 @@ namespace TrenchBroom {
             return result;
         }
         
+        struct MatchCandidate {
+            const Object* object;
+            Node* node;
+            bool matches;
+            
+            MatchCandidate(const Object* i_object, Node* i_node) :
+            object(i_object),
+            node(i_node),
+            matches(false) {}
+        };
+        
+        typedef std::vector<MatchCandidate> MatchCandidateList;
+        
+        template <typename P>
+        class MatchCandidatesTask : public ThreadPool::Task {
+        private:
+            MatchCandidateList::iterator m_begin;
+            MatchCandidateList::iterator m_end;
+        public:
+            MatchCandidatesTask(MatchCandidateList::iterator begin, MatchCandidateList::iterator end) :
+            m_begin(begin),
+            m_end(end) {}
+        private:
+            void doRun() {
+                MatchCandidateList::iterator it;
+                for (it = m_begin; it != m_end; ++it) {
+                    const P predicate(it->object);
+                    it->matches = predicate(it->node);
+                }
+            }
+        };
+        
+        /*
+         Finds the nodes below the given root that match the predicate P for any of the given objects, except for the
+         objects themselves. Only those nodes whose bounds intersect the bounds of an object are tested, and they are
+         found using the spatial indices of the layers. The tests, which may be expensive for brushes, are run on the
+         given thread pool. The result is sorted and contains no duplicates.
+         */
+        template <typename P, typename I>
+        Model::NodeList findMatchingNodes(I cur, I end, Node* root, ThreadPool& threadPool) {
+            // the candidate search computes the bounds of all candidates, so the tasks will not modify any cached bounds
+            MatchCandidateList candidates;
+            NodeList nodes;
+            while (cur != end) {
+                Node* object = *cur;
+                nodes.clear();
+                root->findNodesIntersecting(object->bounds(), nodes);
+                
+                NodeList::const_iterator it, nEnd;
+                for (it = nodes.begin(), nEnd = nodes.end(); it != nEnd; ++it) {
+                    Node* node = *it;
+                    if (node != object)
+                        candidates.push_back(MatchCandidate(*cur, node));
+                }
+                ++cur;
+            }
+            
+            const size_t taskCount = std::min(candidates.size(), 4 * std::max(threadPool.threadCount(), static_cast<size_t>(1)));
+            std::vector< MatchCandidatesTask<P> > tasks;
+            tasks.reserve(taskCount);
+            
+            ThreadPool::TaskList taskList;
+            for (size_t i = 0; i < taskCount; ++i) {
+                const size_t first = i * candidates.size() / taskCount;
+                const size_t last = (i + 1) * candidates.size() / taskCount;
+                tasks.push_back(MatchCandidatesTask<P>(candidates.begin() + static_cast<MatchCandidateList::difference_type>(first),
+                                                       candidates.begin() + static_cast<MatchCandidateList::difference_type>(last)));
+                taskList.push_back(&tasks.back());
+            }
+            threadPool.run(taskList);
+            
+            NodeList result;
+            MatchCandidateList::const_iterator it, cEnd;
+            for (it = candidates.begin(), cEnd = candidates.end(); it != cEnd; ++it) {
+                if (it->matches)
+                    result.push_back(it->node);
+            }
+            VectorUtils::sortAndRemoveDuplicates(result);
+            return result;
+        }
     }
 }
 
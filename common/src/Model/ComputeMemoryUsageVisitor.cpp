@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ComputeMemoryUsageVisitor.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        ComputeMemoryUsageVisitor::Usage::Usage() :
+        count(0),
+        bytes(0) {}
+        
+        void ComputeMemoryUsageVisitor::Usage::add(const size_t i_bytes) {
+            ++count;
+            bytes += i_bytes;
+        }
+        
+        void ComputeMemoryUsageVisitor::Usage::add(const Usage& other) {
+            count += other.count;
+            bytes += other.bytes;
+        }
+
+        const ComputeMemoryUsageVisitor::Usage& ComputeMemoryUsageVisitor::worlds() const {
+            return m_worlds;
+        }
+        
+        const ComputeMemoryUsageVisitor::Usage& ComputeMemoryUsageVisitor::layers() const {
+            return m_layers;
+        }
+        
+        const ComputeMemoryUsageVisitor::Usage& ComputeMemoryUsageVisitor::groups() const {
+            return m_groups;
+        }
+        
+        const ComputeMemoryUsageVisitor::Usage& ComputeMemoryUsageVisitor::entities() const {
+            return m_entities;
+        }
+        
+        const ComputeMemoryUsageVisitor::Usage& ComputeMemoryUsageVisitor::brushes() const {
+            return m_brushes;
+        }
+        
+        const ComputeMemoryUsageVisitor::Usage& ComputeMemoryUsageVisitor::brushFaces() const {
+            return m_brushFaces;
+        }
+        
+        const ComputeMemoryUsageVisitor::Usage& ComputeMemoryUsageVisitor::brushGeometries() const {
+            return m_brushGeometries;
+        }
+
+        ComputeMemoryUsageVisitor::Usage ComputeMemoryUsageVisitor::total() const {
+            Usage result;
+            result.add(m_worlds);
+            result.add(m_layers);
+            result.add(m_groups);
+            result.add(m_entities);
+            result.add(m_brushes);
+            result.add(m_brushFaces);
+            result.add(m_brushGeometries);
+            return result;
+        }
+
+        void ComputeMemoryUsageVisitor::doVisit(const World* world) {
+            m_worlds.add(sizeof(World) + nodeUsage(world) + attributeUsage(world));
+        }
+        
+        void ComputeMemoryUsageVisitor::doVisit(const Layer* layer) {
+            m_layers.add(sizeof(Layer) + nodeUsage(layer) + layer->name().capacity());
+        }
+        
+        void ComputeMemoryUsageVisitor::doVisit(const Group* group) {
+            m_groups.add(sizeof(Group) + nodeUsage(group) + group->name().capacity());
+        }
+        
+        void ComputeMemoryUsageVisitor::doVisit(const Entity* entity) {
+            m_entities.add(sizeof(Entity) + nodeUsage(entity) + attributeUsage(entity));
+        }
+        
+        void ComputeMemoryUsageVisitor::doVisit(const Brush* brush) {
+            const BrushFaceList& faces = brush->faces();
+            m_brushes.add(sizeof(Brush) + nodeUsage(brush) + faces.capacity() * sizeof(BrushFace*));
+            
+            for (size_t i = 0; i < faces.size(); ++i)
+                m_brushFaces.add(sizeof(BrushFace));
+            
+            m_brushGeometries.add(sizeof(BrushGeometry) +
+                                  brush->vertexCount() * sizeof(BrushVertex) +
+                                  brush->edgeCount() * (sizeof(BrushEdge) + 2 * sizeof(BrushHalfEdge)) +
+                                  faces.size() * sizeof(BrushFaceGeometry));
+        }
+
+        size_t ComputeMemoryUsageVisitor::nodeUsage(const Node* node) const {
+            return node->children().capacity() * sizeof(Node*);
+        }
+
+        size_t ComputeMemoryUsageVisitor::attributeUsage(const AttributableNode* node) const {
+            // each attribute is stored in a list node with two links
+            size_t result = 0;
+            const EntityAttribute::List& attributes = node->attributes();
+            EntityAttribute::List::const_iterator it, end;
+            for (it = attributes.begin(), end = attributes.end(); it != end; ++it) {
+                const EntityAttribute& attribute = *it;
+                result += sizeof(EntityAttribute) + 2 * sizeof(void*);
+                result += attribute.name().capacity() + attribute.value().capacity();
+            }
+            return result;
+        }
+    }
+}
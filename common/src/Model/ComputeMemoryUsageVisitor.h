@@ -0,0 +1,73 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_ComputeMemoryUsageVisitor
+#define TrenchBroom_ComputeMemoryUsageVisitor
+
+#include "TrenchBroom.h"
+#include "Model/ModelTypes.h"
+#include "Model/NodeVisitor.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        class AttributableNode;
+        
+        // Estimates the memory used by the visited nodes per node type. The estimates include the nodes' attributes,
+        // brush faces and brush geometry, but not the allocator overhead or shared data such as textures.
+        class ComputeMemoryUsageVisitor : public ConstNodeVisitor {
+        public:
+            struct Usage {
+                size_t count;
+                size_t bytes;
+                
+                Usage();
+                void add(size_t i_bytes);
+                void add(const Usage& other);
+            };
+        private:
+            Usage m_worlds;
+            Usage m_layers;
+            Usage m_groups;
+            Usage m_entities;
+            Usage m_brushes;
+            Usage m_brushFaces;
+            Usage m_brushGeometries;
+        public:
+            const Usage& worlds() const;
+            const Usage& layers() const;
+            const Usage& groups() const;
+            const Usage& entities() const;
+            const Usage& brushes() const;
+            const Usage& brushFaces() const;
+            const Usage& brushGeometries() const;
+            Usage total() const;
+        private:
+            void doVisit(const World* world);
+            void doVisit(const Layer* layer);
+            void doVisit(const Group* group);
+            void doVisit(const Entity* entity);
+            void doVisit(const Brush* brush);
+            
+            size_t nodeUsage(const Node* node) const;
+            size_t attributeUsage(const AttributableNode* node) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_ComputeMemoryUsageVisitor) */
@@ -193,6 +193,34 @@ namespace TrenchBroom {
                     result.push_back(this);
             }
         }
+        
+        void Entity::doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result) {
+            if (!bounds().intersects(frustum))
+                return;
+            
+            result.push_back(this);
+            
+            const NodeList& children = Node::children();
+            NodeList::const_iterator it, end;
+            for (it = children.begin(), end = children.end(); it != end; ++it) {
+                Node* child = *it;
+                child->findNodesInFrustum(frustum, result);
+            }
+        }
+        
+        void Entity::doFindNodesIntersecting(const BBox3& bounds, NodeList& result) {
+            if (!this->bounds().intersects(bounds))
+                return;
+            
+            result.push_back(this);
+            
+            const NodeList& children = Node::children();
+            NodeList::const_iterator it, end;
+            for (it = children.begin(), end = children.end(); it != end; ++it) {
+                Node* child = *it;
+                child->findNodesIntersecting(bounds, result);
+            }
+        }
 
         FloatType Entity::doIntersectWithRay(const Ray3& ray) const {
             if (hasChildren()) {
@@ -74,6 +74,8 @@ namespace TrenchBroom {
             
             void doPick(const Ray3& ray, PickResult& pickResult) const;
             void doFindNodesContaining(const Vec3& point, NodeList& result);
+            void doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result);
+            void doFindNodesIntersecting(const BBox3& bounds, NodeList& result);
             FloatType doIntersectWithRay(const Ray3& ray) const;
 
             void doGenerateIssues(const IssueGenerator* generator, IssueList& issues);
@@ -35,6 +35,7 @@
 #include "IO/NodeWriter.h"
 #include "IO/WorldReader.h"
 #include "IO/SystemPaths.h"
+#include "IO/TextureCache.h"
 #include "IO/WadTextureLoader.h"
 #include "IO/WalTextureLoader.h"
 #include "Model/EntityAttributes.h"
@@ -42,6 +43,7 @@
 #include "Model/World.h"
 
 #include "Exceptions.h"
+#include "ThreadPool.h"
 
 #include <cstdio>
 
@@ -96,6 +98,7 @@ namespace TrenchBroom {
         World* GameImpl::doLoadMap(const MapFormat::Type format, const BBox3& worldBounds, const IO::Path& path, Logger* logger) const {
             const IO::MappedFile::Ptr file = IO::Disk::openFile(IO::Disk::fixPath(path));
             IO::WorldReader reader(file->begin(), file->end(), brushContentTypeBuilder(), logger);
+            reader.setThreadCount(ThreadPool::defaultThreadCount());
             return reader.read(format, worldBounds);
         }
         
@@ -279,7 +282,7 @@ namespace TrenchBroom {
         Assets::TextureCollection* GameImpl::loadWadTextureCollection(const Assets::TextureCollectionSpec& spec) const {
             assert(m_palette != NULL);
             
-            IO::WadTextureLoader loader(*m_palette);
+            IO::WadTextureLoader loader(*m_palette, &IO::TextureCache::instance());
             return loader.loadTextureCollection(spec);
         }
         
@@ -51,5 +51,15 @@ namespace TrenchBroom {
                 snapshot->restore(worldBounds);
             }
         }
+
+        size_t GroupSnapshot::doGetMemorySize() const {
+            size_t result = sizeof(GroupSnapshot) + m_snapshots.capacity() * sizeof(NodeSnapshot*);
+            NodeSnapshotList::const_iterator it, end;
+            for (it = m_snapshots.begin(), end = m_snapshots.end(); it != end; ++it) {
+                const NodeSnapshot* snapshot = *it;
+                result += snapshot->memorySize();
+            }
+            return result;
+        }
     }
 }
@@ -38,6 +38,7 @@ namespace TrenchBroom {
         private:
             void takeSnapshot(Group* group);
             void doRestore(const BBox3& worldBounds);
+            size_t doGetMemorySize() const;
         };
     }
 }
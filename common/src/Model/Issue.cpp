@@ -25,6 +25,8 @@
 
 #include <cassert>
 
+#include <wx/thread.h>
+
 namespace TrenchBroom {
     namespace Model {
         Issue::~Issue() {}
@@ -67,8 +69,15 @@ namespace TrenchBroom {
             assert(m_node != NULL);
         }
 
+        // issues are generated on several threads during validation
+        static wxCriticalSection& seqIdLock() {
+            static wxCriticalSection lock;
+            return lock;
+        }
+
         size_t Issue::nextSeqId() {
             static size_t seqId = 0;
+            wxCriticalSectionLocker lock(seqIdLock());
             return seqId++;
         }
 
@@ -0,0 +1,138 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IssueValidator.h"
+
+#include "Model/Brush.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/IssueGenerator.h"
+#include "Model/Layer.h"
+#include "Model/Node.h"
+#include "Model/NodeVisitor.h"
+#include "Model/World.h"
+
+#include <wx/stopwatch.h>
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace Model {
+        class IssueValidator::CollectInvalidNodesVisitor : public NodeVisitor {
+        private:
+            NodeList m_nodes;
+        public:
+            const NodeList& nodes() const {
+                return m_nodes;
+            }
+        private:
+            void doVisit(World* world)   { collect(world);  }
+            void doVisit(Layer* layer)   { collect(layer);  }
+            void doVisit(Group* group)   { collect(group);  }
+            void doVisit(Entity* entity) { collect(entity); }
+            void doVisit(Brush* brush)   { collect(brush);  }
+            
+            void collect(Node* node) {
+                if (!node->issuesValid())
+                    m_nodes.push_back(node);
+            }
+        };
+        
+        class IssueValidator::ValidateIssuesTask : public ThreadPool::Task {
+        private:
+            NodeList::const_iterator m_begin;
+            NodeList::const_iterator m_end;
+            const IssueGeneratorList* m_issueGenerators;
+            TimeList m_times;
+        public:
+            ValidateIssuesTask(NodeList::const_iterator begin, NodeList::const_iterator end, const IssueGeneratorList& issueGenerators) :
+            m_begin(begin),
+            m_end(end),
+            m_issueGenerators(&issueGenerators),
+            m_times(issueGenerators.size(), 0.0) {}
+            
+            const TimeList& times() const {
+                return m_times;
+            }
+        private:
+            void doRun() {
+                NodeList::const_iterator it;
+                for (size_t i = 0; i < m_issueGenerators->size(); ++i) {
+                    const IssueGenerator* generator = (*m_issueGenerators)[i];
+                    
+                    const wxStopWatch stopWatch;
+                    for (it = m_begin; it != m_end; ++it) {
+                        Node* node = *it;
+                        node->validateIssues(generator);
+                    }
+                    m_times[i] += stopWatch.TimeInMicro().ToDouble() / 1000.0;
+                }
+                
+                for (it = m_begin; it != m_end; ++it) {
+                    Node* node = *it;
+                    node->validateIssues(*m_issueGenerators);
+                }
+            }
+        };
+        
+        IssueValidator::IssueValidator(ThreadPool& threadPool) :
+        m_threadPool(threadPool),
+        m_nodeCount(0) {}
+        
+        void IssueValidator::validate(Node* root, const IssueGeneratorList& issueGenerators) {
+            CollectInvalidNodesVisitor visitor;
+            root->acceptAndRecurse(visitor);
+            
+            const NodeList& nodes = visitor.nodes();
+            m_nodeCount = nodes.size();
+            m_times.assign(issueGenerators.size(), 0.0);
+            if (nodes.empty())
+                return;
+            
+            const size_t taskCount = std::min(nodes.size(), 4 * std::max(m_threadPool.threadCount(), static_cast<size_t>(1)));
+            std::vector<ValidateIssuesTask> tasks;
+            tasks.reserve(taskCount);
+            
+            ThreadPool::TaskList taskList;
+            for (size_t i = 0; i < taskCount; ++i) {
+                const size_t first = i * nodes.size() / taskCount;
+                const size_t last = (i + 1) * nodes.size() / taskCount;
+                tasks.push_back(ValidateIssuesTask(nodes.begin() + static_cast<NodeList::difference_type>(first),
+                                                   nodes.begin() + static_cast<NodeList::difference_type>(last),
+                                                   issueGenerators));
+                taskList.push_back(&tasks.back());
+            }
+            m_threadPool.run(taskList);
+            
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                const TimeList& taskTimes = tasks[i].times();
+                for (size_t j = 0; j < taskTimes.size(); ++j)
+                    m_times[j] += taskTimes[j];
+            }
+        }
+        
+        size_t IssueValidator::nodeCount() const {
+            return m_nodeCount;
+        }
+        
+        const IssueValidator::TimeList& IssueValidator::times() const {
+            return m_times;
+        }
+    }
+}
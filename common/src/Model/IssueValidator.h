@@ -0,0 +1,56 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_IssueValidator
+#define TrenchBroom_IssueValidator
+
+#include "ThreadPool.h"
+#include "Model/ModelTypes.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class Node;
+        
+        // Validates the issues of all nodes whose issues were invalidated since the last validation. The nodes are
+        // validated on the given thread pool, so the model must not be modified during validation.
+        class IssueValidator {
+        public:
+            typedef std::vector<double> TimeList;
+        private:
+            class CollectInvalidNodesVisitor;
+            class ValidateIssuesTask;
+            
+            ThreadPool& m_threadPool;
+            size_t m_nodeCount;
+            TimeList m_times;
+        public:
+            IssueValidator(ThreadPool& threadPool);
+            
+            void validate(Node* root, const IssueGeneratorList& issueGenerators);
+            
+            // the number of nodes and the time in milliseconds spent in each generator during the last validation
+            size_t nodeCount() const;
+            const TimeList& times() const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_IssueValidator) */
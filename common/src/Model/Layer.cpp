@@ -163,6 +163,24 @@ namespace TrenchBroom {
                 node->findNodesContaining(point, result);
             }
         }
+        
+        void Layer::doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result) {
+            const Model::NodeList candidates = m_octree.findObjects(frustum);
+            NodeList::const_iterator it, end;
+            for (it = candidates.begin(), end = candidates.end(); it != end; ++it) {
+                Node* node = *it;
+                node->findNodesInFrustum(frustum, result);
+            }
+        }
+        
+        void Layer::doFindNodesIntersecting(const BBox3& bounds, NodeList& result) {
+            const Model::NodeList candidates = m_octree.findObjects(bounds);
+            NodeList::const_iterator it, end;
+            for (it = candidates.begin(), end = candidates.end(); it != end; ++it) {
+                Node* node = *it;
+                node->findNodesIntersecting(bounds, result);
+            }
+        }
 
         FloatType Layer::doIntersectWithRay(const Ray3& ray) const {
             return Math::nan<FloatType>();
@@ -38,7 +38,7 @@ namespace TrenchBroom {
         m_lockState(Lock_Inherited),
         m_lineNumber(0),
         m_lineCount(0),
-        m_issuesValid(false),
+        m_invalidIssueTypes(~0),
         m_hiddenIssues(0) {}
         
         Node::~Node() {
@@ -524,6 +524,14 @@ namespace TrenchBroom {
             doFindNodesContaining(point, result);
         }
 
+        void Node::findNodesInFrustum(const Plane3::List& frustum, NodeList& result) {
+            doFindNodesInFrustum(frustum, result);
+        }
+
+        void Node::findNodesIntersecting(const BBox3& bounds, NodeList& result) {
+            doFindNodesIntersecting(bounds, result);
+        }
+
         FloatType Node::intersectWithRay(const Ray3& ray) const {
             return doIntersectWithRay(ray);
         }
@@ -557,20 +565,52 @@ namespace TrenchBroom {
                 m_hiddenIssues &= ~type;
         }
 
+        bool Node::issuesValid() const {
+            return m_invalidIssueTypes == 0;
+        }
+
         void Node::validateIssues(const IssueGeneratorList& issueGenerators) {
-            if (!m_issuesValid) {
+            if (m_invalidIssueTypes != 0) {
                 IssueGeneratorList::const_iterator it, end;
                 for (it = issueGenerators.begin(), end = issueGenerators.end(); it != end; ++it) {
                     const IssueGenerator* generator = *it;
-                    doGenerateIssues(generator, m_issues);
+                    validateIssues(generator);
                 }
-                m_issuesValid = true;
+                // issues of types without a generator are stale
+                removeIssues(m_invalidIssueTypes);
+                m_invalidIssueTypes = 0;
+            }
+        }
+        
+        void Node::validateIssues(const IssueGenerator* issueGenerator) {
+            const IssueType type = issueGenerator->type();
+            if ((m_invalidIssueTypes & type) != 0) {
+                removeIssues(type);
+                doGenerateIssues(issueGenerator, m_issues);
+                m_invalidIssueTypes &= ~type;
             }
         }
         
         void Node::invalidateIssues() const {
-            clearIssues();
-            m_issuesValid = false;
+            invalidateIssues(~0);
+        }
+        
+        // stale issues are kept until the node is validated again so that views can still display them
+        void Node::invalidateIssues(const IssueType issueTypes) const {
+            m_invalidIssueTypes |= issueTypes;
+        }
+        
+        void Node::removeIssues(const IssueType issueTypes) {
+            IssueList::iterator it = m_issues.begin();
+            while (it != m_issues.end()) {
+                Issue* issue = *it;
+                if ((issue->type() & issueTypes) != 0) {
+                    delete issue;
+                    it = m_issues.erase(it);
+                } else {
+                    ++it;
+                }
+            }
         }
         
         void Node::clearIssues() const {
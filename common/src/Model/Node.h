@@ -44,7 +44,7 @@ namespace TrenchBroom {
             size_t m_lineCount;
 
             mutable IssueList m_issues;
-            mutable bool m_issuesValid;
+            mutable IssueType m_invalidIssueTypes;
             IssueType m_hiddenIssues;
         protected:
             Node();
@@ -213,6 +213,10 @@ namespace TrenchBroom {
         public: // picking
             void pick(const Ray3& ray, PickResult& result) const;
             void findNodesContaining(const Vec3& point, NodeList& result);
+            // collects the nodes whose bounds intersect the given frustum, whose plane normals must point outwards
+            void findNodesInFrustum(const Plane3::List& frustum, NodeList& result);
+            // collects the nodes whose bounds intersect the given bounds
+            void findNodesIntersecting(const BBox3& bounds, NodeList& result);
             FloatType intersectWithRay(const Ray3& ray) const;
         public: // file position
             size_t lineNumber() const;
@@ -220,13 +224,18 @@ namespace TrenchBroom {
             bool containsLine(size_t lineNumber) const;
         public: // issue management
             const IssueList& issues(const IssueGeneratorList& issueGenerators);
+            bool issuesValid() const;
             
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
+            
+            void validateIssues(const IssueGeneratorList& issueGenerators);
+            void validateIssues(const IssueGenerator* issueGenerator);
         public: // should only be called from this and from the world
             void invalidateIssues() const;
+            void invalidateIssues(IssueType issueTypes) const;
         private:
-            void validateIssues(const IssueGeneratorList& issueGenerators);
+            void removeIssues(IssueType issueTypes);
             void clearIssues() const;
         public: // visitors
             template <class V>
@@ -406,6 +415,8 @@ namespace TrenchBroom {
             
             virtual void doPick(const Ray3& ray, PickResult& pickResult) const = 0;
             virtual void doFindNodesContaining(const Vec3& point, NodeList& result) = 0;
+            virtual void doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result) = 0;
+            virtual void doFindNodesIntersecting(const BBox3& bounds, NodeList& result) = 0;
             virtual FloatType doIntersectWithRay(const Ray3& ray) const = 0;
             
             virtual void doGenerateIssues(const IssueGenerator* generator, IssueList& issues) = 0;
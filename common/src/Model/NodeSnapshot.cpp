@@ -28,5 +28,9 @@ namespace TrenchBroom {
         void NodeSnapshot::restore(const BBox3& worldBounds) {
             doRestore(worldBounds);
         }
+
+        size_t NodeSnapshot::memorySize() const {
+            return doGetMemorySize();
+        }
     }
 }
@@ -33,8 +33,10 @@ namespace TrenchBroom {
         public:
             virtual ~NodeSnapshot();
             void restore(const BBox3& worldBounds);
+            size_t memorySize() const;
         private:
             virtual void doRestore(const BBox3& worldBounds) = 0;
+            virtual size_t doGetMemorySize() const = 0;
         };
     }
 }
@@ -20,193 +20,122 @@
 #ifndef TrenchBroom_Octree
 #define TrenchBroom_Octree
 
-#include "CollectionUtils.h"
 #include "Macros.h"
+#include "UnorderedMap.h"
 #include "VecMath.h"
 #include "Exceptions.h"
-#include "SharedPointer.h"
 
-#include <map>
+#include <cassert>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Model {
+        /*
+         A loose octree. Every cell's bounds are extended by half of the cell's size on each side, so that an object
+         only needs to fit into the loose bounds of the cell that contains its center. Thereby, the depth at which an
+         object is stored only depends on its size, and objects which straddle a split plane do not accumulate in the
+         upper levels of the tree.
+         
+         The nodes are stored in contiguous arrays and are addressed by their index. The root node has index 0. Nodes
+         are never removed, but their object lists are, so that a node that has become empty is simply skipped.
+         */
         template <typename F, typename T>
-        class OctreeNode {
-        private:
+        class Octree {
+        public:
             typedef std::vector<T> List;
+            typedef std::vector< Plane<F,3> > PlaneList;
+        private:
+            typedef BBox<F,3> Box;
+            typedef std::vector<Box> BoxList;
             
-            BBox<F,3> m_bounds;
-            F m_minSize;
-            OctreeNode* m_parent;
-            OctreeNode* m_children[8];
-            List m_objects;
-        public:
-            OctreeNode(const BBox<F,3>& bounds, const F minSize, OctreeNode* parent) :
-            m_bounds(bounds),
-            m_minSize(minSize),
-            m_parent(parent) {
-                for (size_t i = 0; i < 8; ++i)
-                    m_children[i] = NULL;
-            }
+            static const size_t NoNode = static_cast<size_t>(-1);
             
-            ~OctreeNode() {
-                for (size_t i = 0; i < 8; ++i) {
-                    if (m_children[i] != NULL) {
-                        delete m_children[i];
-                        m_children[i] = NULL;
-                    }
+            struct Children {
+                size_t index[8];
+                
+                Children() {
+                    for (size_t i = 0; i < 8; ++i)
+                        index[i] = NoNode;
                 }
-            }
-            
-            bool contains(const BBox<F,3>& bounds) const {
-                return m_bounds.contains(bounds);
-            }
+            };
             
-            bool containsObject(const BBox<F,3>& bounds, T object) const {
-                assert(contains(bounds));
-                for (size_t i = 0; i < 8; ++i) {
-                    if (m_children[i] != NULL && m_children[i]->contains(bounds)) {
-                        return m_children[i]->containsObject(bounds, object);
-                    }
-                }
+            struct ObjectEntry {
+                size_t node;
+                size_t index;
                 
-                typename List::const_iterator it = std::find(m_objects.begin(), m_objects.end(), object);
-                return it != m_objects.end();
-            }
+                ObjectEntry(const size_t i_node = NoNode, const size_t i_index = 0) :
+                node(i_node),
+                index(i_index) {}
+            };
             
-            OctreeNode* addObject(const BBox<F,3>& bounds, T object) {
-                assert(contains(bounds));
-                
-                const Vec3f size = m_bounds.size();
-                if (size.x() > m_minSize || size.y() > m_minSize || size.z() > m_minSize) {
-                    for (size_t i = 0; i < 8; ++i) {
-                        if (m_children[i] != NULL && m_children[i]->contains(bounds)) {
-                            return m_children[i]->addObject(bounds, object);
-                        } else {
-                            const BBox<F,3> childBounds = octant(i);
-                            if (childBounds.contains(bounds)) {
-                                OctreeNode<F,T>* child = new OctreeNode<F,T>(childBounds, m_minSize, this);
-                                try {
-                                    OctreeNode* result = child->addObject(bounds, object);
-                                    m_children[i] = child;
-                                    return result;
-                                } catch (...) {
-                                    delete child;
-                                    throw;
-                                }
-                            }
-                        }
-                    }
+            typedef std::tr1::unordered_map<T, ObjectEntry> ObjectMap;
+            
+            struct RayQuery {
+                const Ray<F,3>& ray;
+                RayQuery(const Ray<F,3>& i_ray) : ray(i_ray) {}
+                bool operator()(const Box& box) const {
+                    return box.contains(ray.origin) || !Math::isnan(box.intersectWithRay(ray));
                 }
-                
-                assert(!VectorUtils::contains(m_objects, object));
-                m_objects.push_back(object);
-                return this;
-            }
+            };
             
-            bool removeObject(T object) {
-                typename List::iterator it = std::find(m_objects.begin(), m_objects.end(), object);
-                if (it == m_objects.end())
-                    return false;
-                m_objects.erase(it);
-                return true;
-            }
-
-            OctreeNode* findContaining(const BBox<F,3>& bounds) {
-                if (contains(bounds))
-                    return this;
-                if (m_parent == NULL)
-                    return NULL;
-                return m_parent->findContaining(bounds);
-            }
+            struct PointQuery {
+                const Vec<F,3>& point;
+                PointQuery(const Vec<F,3>& i_point) : point(i_point) {}
+                bool operator()(const Box& box) const {
+                    return box.contains(point);
+                }
+            };
             
-            void findObjects(const Ray<F,3>& ray, List& result) const {
-                const F distance = m_bounds.intersectWithRay(ray);
-                if (Math::isnan(distance))
-                    return;
-                
-                for (size_t i = 0; i < 8; ++i)
-                    if (m_children[i] != NULL)
-                        m_children[i]->findObjects(ray, result);
-                result.insert(result.end(), m_objects.begin(), m_objects.end());
-            }
+            struct BoxQuery {
+                const Box& bounds;
+                BoxQuery(const Box& i_bounds) : bounds(i_bounds) {}
+                bool operator()(const Box& box) const {
+                    return box.intersects(bounds);
+                }
+            };
             
-            void findObjects(const Vec<F,3>& point, List& result) const {
-                if (!m_bounds.contains(point))
-                    return;
-                
-                for (size_t i = 0; i < 8; ++i)
-                    if (m_children[i] != NULL)
-                        m_children[i]->findObjects(point, result);
-                result.insert(result.end(), m_objects.begin(), m_objects.end());
-            }
-        private:
-            BBox<F,3> octant(const size_t index) const {
-                const Vec3f& min = m_bounds.min;
-                const Vec3f& max = m_bounds.max;
-                const Vec3f mid = (min + max) / 2.0f;
-                switch (index) {
-                    case 0: // xyz +++
-                        return BBox<F,3>(mid, max);
-                    case 1: // xyz -++
-                        return BBox<F,3>(Vec3f(min.x(), mid.y(), mid.z()),
-                                      Vec3f(mid.x(), max.y(), max.z()));
-                    case 2: // xyz +-+
-                        return BBox<F,3>(Vec3f(mid.x(), min.y(), mid.z()),
-                                      Vec3f(max.x(), mid.y(), max.z()));
-                    case 3: // xyz --+
-                        return BBox<F,3>(Vec3f(min.x(), min.y(), mid.z()),
-                                      Vec3f(mid.x(), mid.y(), max.z()));
-                    case 4: // xyz ++-
-                        return BBox<F,3>(Vec3f(mid.x(), mid.y(), min.z()),
-                                      Vec3f(max.x(), max.y(), mid.z()));
-                    case 5: // xyz -+-
-                        return BBox<F,3>(Vec3f(min.x(), mid.y(), min.z()),
-                                      Vec3f(mid.x(), max.y(), mid.z()));
-                    case 6: // xyz +--
-                        return BBox<F,3>(Vec3f(mid.x(), min.y(), min.z()),
-                                      Vec3f(max.x(), mid.y(), mid.z()));
-                    case 7: // xyz ---
-                        return BBox<F,3>(Vec3f(min.x(), min.y(), min.z()),
-                                      Vec3f(mid.x(), mid.y(), mid.z()));
-                    default:
-                        assert(false);
-                        return BBox<F,3>();
+            struct FrustumQuery {
+                const PlaneList& planes;
+                FrustumQuery(const PlaneList& i_planes) : planes(i_planes) {}
+                bool operator()(const Box& box) const {
+                    return box.intersects(planes);
                 }
-            }
-        };
-        
-        template <typename F, typename T>
-        class Octree {
-        public:
-            typedef std::vector<T> List;
-        private:
-            typedef std::map<T, OctreeNode<F,T>*> ObjectMap;
-            BBox<F,3> m_bounds;
-            OctreeNode<F,T>* m_root;
+            };
+            
+            Box m_bounds;
+            F m_minSize;
+            
+            // node data, addressed by node index
+            BoxList m_cellBounds;
+            BoxList m_looseBounds;
+            std::vector<Children> m_children;
+            std::vector<List> m_objects;
+            std::vector<BoxList> m_objectBounds;
+            
             ObjectMap m_objectMap;
         public:
             Octree(const BBox<F,3>& bounds, const F minSize) :
             m_bounds(bounds),
-            m_root(new OctreeNode<F,T>(bounds, minSize, NULL)) {}
-            
-            ~Octree() {
-                delete m_root;
+            m_minSize(minSize) {
+                createNode(m_bounds);
             }
             
             const BBox<F,3>& bounds() const {
                 return m_bounds;
             }
             
+            size_t objectCount() const {
+                return m_objectMap.size();
+            }
+            
             void addObject(const BBox<F,3>& bounds, T object) {
-                if (!m_root->contains(bounds))
+                if (!m_bounds.contains(bounds))
                     throw OctreeException("Object is too large for this octree");
+                if (m_objectMap.count(object) > 0)
+                    throw OctreeException("Object is already contained in this octree");
                 
-                OctreeNode<F,T>* node = m_root->addObject(bounds, object);
-                if (node == NULL)
-                    throw OctreeException("Unknown error when inserting into octree");
-                assertResult(MapUtils::insertOrFail(m_objectMap, object, node));
+                const size_t node = findNode(bounds, true);
+                insertIntoNode(node, bounds, object);
             }
             
             void removeObject(T object) {
@@ -214,47 +143,188 @@ namespace TrenchBroom {
                 if (it == m_objectMap.end())
                     throw OctreeException("Cannot find object in octree");
                 
-                OctreeNode<F,T>* node = it->second;
-                if (!node->removeObject(object))
-                    throw OctreeException("Cannot find object in octree");
+                const ObjectEntry entry = it->second;
                 m_objectMap.erase(it);
+                removeFromNode(entry);
             }
             
             void updateObject(const BBox<F,3>& bounds, T object) {
                 typename ObjectMap::iterator it = m_objectMap.find(object);
                 if (it == m_objectMap.end())
                     throw OctreeException("Cannot find object in octree");
-
-                OctreeNode<F,T>* oldNode = it->second;
-                if (!oldNode->removeObject(object))
-                    throw OctreeException("Cannot find object in octree");
+                if (!m_bounds.contains(bounds))
+                    throw OctreeException("Object is too large for this octree");
                 
-                OctreeNode<F,T>* newAncestor = oldNode->findContaining(bounds);
-                if (newAncestor == NULL)
-                    throw OctreeException("Cannot find new ancestor node in octree");
-                OctreeNode<F,T>* newParent = newAncestor->addObject(bounds, object);
-                if (newParent == NULL)
-                    throw OctreeException("Unknown error when inserting into octree");
-                MapUtils::insertOrReplace(m_objectMap, object, newParent);
+                const ObjectEntry entry = it->second;
+                const size_t node = findNode(bounds, true);
+                if (node == entry.node) {
+                    m_objectBounds[node][entry.index] = bounds;
+                } else {
+                    m_objectMap.erase(it);
+                    removeFromNode(entry);
+                    insertIntoNode(node, bounds, object);
+                }
             }
             
             bool containsObject(const BBox<F,3>& bounds, T object) const {
-                if (!m_root->contains(bounds))
+                if (!m_bounds.contains(bounds))
                     return false;
-                return m_root->containsObject(bounds, object);
+                
+                typename ObjectMap::const_iterator it = m_objectMap.find(object);
+                if (it == m_objectMap.end())
+                    return false;
+                return it->second.node == const_cast<Octree*>(this)->findNode(bounds, false);
             }
             
             List findObjects(const Ray<F,3>& ray) const {
                 List result;
-                m_root->findObjects(ray, result);
+                findObjects(ray, result);
                 return result;
             }
             
+            void findObjects(const Ray<F,3>& ray, List& result) const {
+                query(RayQuery(ray), result);
+            }
+            
             List findObjects(const Vec<F,3>& point) const {
                 List result;
-                m_root->findObjects(point, result);
+                findObjects(point, result);
+                return result;
+            }
+            
+            void findObjects(const Vec<F,3>& point, List& result) const {
+                query(PointQuery(point), result);
+            }
+            
+            // finds all objects whose bounds intersect the given bounds
+            List findObjects(const BBox<F,3>& bounds) const {
+                List result;
+                findObjects(bounds, result);
                 return result;
             }
+            
+            void findObjects(const BBox<F,3>& bounds, List& result) const {
+                query(BoxQuery(bounds), result);
+            }
+            
+            // finds all objects whose bounds are not entirely above any of the given planes, so the plane normals
+            // must point out of the frustum
+            List findObjects(const PlaneList& frustum) const {
+                List result;
+                findObjects(frustum, result);
+                return result;
+            }
+            
+            void findObjects(const PlaneList& frustum, List& result) const {
+                query(FrustumQuery(frustum), result);
+            }
+            
+            // finds all objects whose bounds satisfy the given predicate, which must also be satisfied by the bounds of
+            // any box that contains such bounds
+            template <typename Query>
+            void findObjectsMatching(const Query& query, List& result) const {
+                this->query(query, result);
+            }
+        private:
+            size_t createNode(const Box& cellBounds) {
+                const Vec<F,3> halfSize = cellBounds.size() / static_cast<F>(2.0);
+                m_cellBounds.push_back(cellBounds);
+                m_looseBounds.push_back(Box(cellBounds.min - halfSize, cellBounds.max + halfSize));
+                m_children.push_back(Children());
+                m_objects.push_back(List());
+                m_objectBounds.push_back(BoxList());
+                return m_cellBounds.size() - 1;
+            }
+            
+            // Returns the deepest node whose loose bounds contain the given bounds. If create is false, the search
+            // stops at the first missing node.
+            size_t findNode(const Box& bounds, const bool create) {
+                const Vec<F,3> center = bounds.center();
+                
+                size_t node = 0;
+                while (true) {
+                    const Box cell = m_cellBounds[node];
+                    const Vec<F,3> size = cell.size();
+                    if (size.x() <= m_minSize && size.y() <= m_minSize && size.z() <= m_minSize)
+                        return node;
+                    
+                    const Vec<F,3> mid = cell.center();
+                    size_t octant = 0;
+                    Box childCell = cell;
+                    for (size_t i = 0; i < 3; ++i) {
+                        if (center[i] >= mid[i]) {
+                            octant |= (1 << i);
+                            childCell.min[i] = mid[i];
+                        } else {
+                            childCell.max[i] = mid[i];
+                        }
+                    }
+                    
+                    const Vec<F,3> halfSize = childCell.size() / static_cast<F>(2.0);
+                    if (!Box(childCell.min - halfSize, childCell.max + halfSize).contains(bounds))
+                        return node;
+                    
+                    size_t child = m_children[node].index[octant];
+                    if (child == NoNode) {
+                        if (!create)
+                            return node;
+                        child = createNode(childCell);
+                        m_children[node].index[octant] = child;
+                    }
+                    node = child;
+                }
+            }
+            
+            void insertIntoNode(const size_t node, const Box& bounds, T object) {
+                m_objects[node].push_back(object);
+                m_objectBounds[node].push_back(bounds);
+                m_objectMap.insert(std::make_pair(object, ObjectEntry(node, m_objects[node].size() - 1)));
+            }
+            
+            // swaps the last object of the node into the place of the removed one
+            void removeFromNode(const ObjectEntry& entry) {
+                List& objects = m_objects[entry.node];
+                BoxList& objectBounds = m_objectBounds[entry.node];
+                assert(entry.index < objects.size());
+                
+                const size_t last = objects.size() - 1;
+                if (entry.index < last) {
+                    objects[entry.index] = objects[last];
+                    objectBounds[entry.index] = objectBounds[last];
+                    
+                    typename ObjectMap::iterator it = m_objectMap.find(objects[entry.index]);
+                    assert(it != m_objectMap.end());
+                    it->second.index = entry.index;
+                }
+                objects.pop_back();
+                objectBounds.pop_back();
+            }
+            
+            template <typename Query>
+            void query(const Query& query, List& result) const {
+                std::vector<size_t> stack;
+                stack.push_back(0);
+                
+                while (!stack.empty()) {
+                    const size_t node = stack.back();
+                    stack.pop_back();
+                    if (!query(m_looseBounds[node]))
+                        continue;
+                    
+                    const List& objects = m_objects[node];
+                    const BoxList& objectBounds = m_objectBounds[node];
+                    for (size_t i = 0; i < objects.size(); ++i) {
+                        if (query(objectBounds[i]))
+                            result.push_back(objects[i]);
+                    }
+                    
+                    const Children& children = m_children[node];
+                    for (size_t i = 0; i < 8; ++i) {
+                        if (children.index[i] != NoNode)
+                            stack.push_back(children.index[i]);
+                    }
+                }
+            }
         };
     }
 }
@@ -47,16 +47,24 @@ namespace TrenchBroom {
             }
         }
 
+        size_t Snapshot::memorySize() const {
+            return m_memorySize;
+        }
+
         void Snapshot::takeSnapshot(Node* node) {
             NodeSnapshot* snapshot = node->takeSnapshot();
-            if (snapshot != NULL)
+            if (snapshot != NULL) {
                 m_nodeSnapshots.push_back(snapshot);
+                m_memorySize += sizeof(NodeSnapshot*) + snapshot->memorySize();
+            }
         }
 
         void Snapshot::takeSnapshot(BrushFace* face) {
             BrushFaceSnapshot* snapshot = face->takeSnapshot();
-            if (snapshot != NULL)
+            if (snapshot != NULL) {
                 m_brushFaceSnapshots.push_back(snapshot);
+                m_memorySize += sizeof(BrushFaceSnapshot*) + snapshot->memorySize();
+            }
         }
     }
 }
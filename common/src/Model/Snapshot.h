@@ -34,9 +34,11 @@ namespace TrenchBroom {
         private:
             NodeSnapshotList m_nodeSnapshots;
             BrushFaceSnapshotList m_brushFaceSnapshots;
+            size_t m_memorySize;
         public:
             template <typename I>
-            Snapshot(I cur, I end) {
+            Snapshot(I cur, I end) :
+            m_memorySize(sizeof(Snapshot)) {
                 while (cur != end) {
                     takeSnapshot(*cur);
                     ++cur;
@@ -47,6 +49,8 @@ namespace TrenchBroom {
             
             void restoreNodes(const BBox3& worldBounds);
             void restoreBrushFaces();
+            
+            size_t memorySize() const;
         private:
             void takeSnapshot(Node* node);
             void takeSnapshot(BrushFace* face);
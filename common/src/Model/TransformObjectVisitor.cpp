@@ -19,6 +19,7 @@
 
 #include "TransformObjectVisitor.h"
 
+#include "ThreadPool.h"
 #include "Model/Brush.h"
 #include "Model/Entity.h"
 #include "Model/Group.h"
@@ -35,5 +36,42 @@ namespace TrenchBroom {
         void TransformObjectVisitor::doVisit(Group* group)   {  group->transform(m_transformation, m_lockTextures, m_worldBounds); }
         void TransformObjectVisitor::doVisit(Entity* entity) { entity->transform(m_transformation, m_lockTextures, m_worldBounds); }
         void TransformObjectVisitor::doVisit(Brush* brush)   {  brush->transform(m_transformation, m_lockTextures, m_worldBounds); }
+        
+        // transforms point entities immediately and collects the brushes, also those which belong to groups and entities
+        class TransformPointEntitiesVisitor : public NodeVisitor {
+        private:
+            const Mat4x4d& m_transformation;
+            bool m_lockTextures;
+            const BBox3& m_worldBounds;
+            BrushList m_brushes;
+        public:
+            TransformPointEntitiesVisitor(const Mat4x4d& transformation, const bool lockTextures, const BBox3& worldBounds) :
+            m_transformation(transformation),
+            m_lockTextures(lockTextures),
+            m_worldBounds(worldBounds) {}
+            
+            const BrushList& brushes() const {
+                return m_brushes;
+            }
+        private:
+            void doVisit(World* world)   {}
+            void doVisit(Layer* layer)   {}
+            void doVisit(Group* group)   { group->iterate(*this); }
+            
+            void doVisit(Entity* entity) {
+                if (entity->hasChildren())
+                    entity->iterate(*this);
+                else
+                    entity->transform(m_transformation, m_lockTextures, m_worldBounds);
+            }
+            
+            void doVisit(Brush* brush)   { m_brushes.push_back(brush); }
+        };
+        
+        Brush::GeometryErrorList transformObjects(const NodeList& nodes, const Mat4x4d& transformation, const bool lockTextures, const BBox3& worldBounds, ThreadPool& threadPool) {
+            TransformPointEntitiesVisitor visitor(transformation, lockTextures, worldBounds);
+            Node::accept(nodes.begin(), nodes.end(), visitor);
+            return Brush::transformBrushes(visitor.brushes(), transformation, lockTextures, worldBounds, threadPool);
+        }
     }
 }
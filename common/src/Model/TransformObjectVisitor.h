@@ -22,9 +22,13 @@
 
 #include "TrenchBroom.h"
 #include "VecMath.h"
+#include "Model/Brush.h"
+#include "Model/ModelTypes.h"
 #include "Model/NodeVisitor.h"
 
 namespace TrenchBroom {
+    class ThreadPool;
+    
     namespace Model {
         class TransformObjectVisitor : public NodeVisitor {
         private:
@@ -40,6 +44,11 @@ namespace TrenchBroom {
             void doVisit(Entity* entity);
             void doVisit(Brush* brush);
         };
+        
+        // Transforms the given nodes like TransformObjectVisitor, but the brushes among the nodes and their descendants
+        // are transformed on the given thread pool. The nodes are notified on the calling thread. Brushes whose geometry
+        // cannot be built are returned together with the error messages.
+        Brush::GeometryErrorList transformObjects(const NodeList& nodes, const Mat4x4d& transformation, bool lockTextures, const BBox3& worldBounds, ThreadPool& threadPool);
     }
 }
 
@@ -73,15 +73,20 @@ namespace TrenchBroom {
 
         void World::registerIssueGenerator(IssueGenerator* issueGenerator) {
             m_issueGeneratorRegistry.registerGenerator(issueGenerator);
-            invalidateAllIssues();
+            invalidateAllIssues(issueGenerator->type());
         }
 
         void World::unregisterAllIssueGenerators() {
             m_issueGeneratorRegistry.unregisterAllGenerators();
-            invalidateAllIssues();
+            invalidateAllIssues(~0);
         }
 
         class World::InvalidateAllIssuesVisitor : public NodeVisitor {
+        private:
+            IssueType m_issueTypes;
+        public:
+            InvalidateAllIssuesVisitor(const IssueType issueTypes) :
+            m_issueTypes(issueTypes) {}
         private:
             void doVisit(World* world)   { invalidateIssues(world);  }
             void doVisit(Layer* layer)   { invalidateIssues(layer);  }
@@ -89,11 +94,11 @@ namespace TrenchBroom {
             void doVisit(Entity* entity) { invalidateIssues(entity); }
             void doVisit(Brush* brush)   { invalidateIssues(brush);  }
             
-            void invalidateIssues(Node* node) { node->invalidateIssues(); }
+            void invalidateIssues(Node* node) { node->invalidateIssues(m_issueTypes); }
         };
         
-        void World::invalidateAllIssues() {
-            InvalidateAllIssuesVisitor visitor;
+        void World::invalidateAllIssues(const IssueType issueTypes) {
+            InvalidateAllIssuesVisitor visitor(issueTypes);
             acceptAndRecurse(visitor);
         }
 
@@ -188,6 +193,24 @@ namespace TrenchBroom {
                 child->findNodesContaining(point, result);
             }
         }
+        
+        void World::doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result) {
+            const NodeList& children = Node::children();
+            NodeList::const_iterator it, end;
+            for (it = children.begin(), end = children.end(); it != end; ++it) {
+                Node* child = *it;
+                child->findNodesInFrustum(frustum, result);
+            }
+        }
+        
+        void World::doFindNodesIntersecting(const BBox3& bounds, NodeList& result) {
+            const NodeList& children = Node::children();
+            NodeList::const_iterator it, end;
+            for (it = children.begin(), end = children.end(); it != end; ++it) {
+                Node* child = *it;
+                child->findNodesIntersecting(bounds, result);
+            }
+        }
 
         FloatType World::doIntersectWithRay(const Ray3& ray) const {
             return Math::nan<FloatType>();
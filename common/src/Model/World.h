@@ -58,7 +58,7 @@ namespace TrenchBroom {
             void unregisterAllIssueGenerators();
         private:
             class InvalidateAllIssuesVisitor;
-            void invalidateAllIssues();
+            void invalidateAllIssues(IssueType issueTypes);
         private: // implement Node interface
             const BBox3& doGetBounds() const;
             Node* doClone(const BBox3& worldBounds) const;
@@ -69,6 +69,8 @@ namespace TrenchBroom {
             bool doSelectable() const;
             void doPick(const Ray3& ray, PickResult& pickResult) const;
             void doFindNodesContaining(const Vec3& point, NodeList& result);
+            void doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result);
+            void doFindNodesIntersecting(const BBox3& bounds, NodeList& result);
             FloatType doIntersectWithRay(const Ray3& ray) const;
             void doGenerateIssues(const IssueGenerator* generator, IssueList& issues);
             void doAccept(NodeVisitor& visitor);
@@ -25,6 +25,7 @@
 #include "DoublyLinkedList.h"
 
 #include <cassert>
+#include <iostream>
 #include <queue>
 #include <vector>
 
@@ -25,13 +25,15 @@
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 #include "Model/EditorContext.h"
-#include "Model/NodeVisitor.h"
 #include "Renderer/IndexArrayMapBuilder.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
 #include "Renderer/TexturedIndexArrayBuilder.h"
+#include "Renderer/VertexListBuilder.h"
 #include "Renderer/VertexSpec.h"
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace Renderer {
         BrushRenderer::Filter::~Filter() {}
@@ -67,9 +69,47 @@ namespace TrenchBroom {
         bool BrushRenderer::NoFilter::doShow(const Model::BrushEdge* edge) const { return true; }
         bool BrushRenderer::NoFilter::doIsTransparent(const Model::Brush* brush) const { return m_transparent; }
 
+        class BrushRenderer::BrushInfo {
+        public:
+            struct FaceIndices {
+                const Assets::Texture* texture;
+                size_t index;
+                size_t count;
+                
+                FaceIndices(const Assets::Texture* i_texture, const size_t i_index, const size_t i_count) :
+                texture(i_texture),
+                index(i_index),
+                count(i_count) {}
+            };
+            
+            typedef std::vector<FaceIndices> FaceIndicesList;
+            typedef std::vector<GLuint> EdgeIndexList;
+            
+            bool valid;
+            bool transparent;
+            size_t vertexOffset;
+            size_t vertexCount;
+            size_t vertexCapacity;
+            
+            // all indices are relative to the vertex offset
+            FaceIndicesList faces;
+            EdgeIndexList edges;
+            
+            BrushInfo() :
+            valid(false),
+            transparent(false),
+            vertexOffset(0),
+            vertexCount(0),
+            vertexCapacity(0) {}
+        };
+        
         BrushRenderer::BrushRenderer(const bool transparent) :
         m_filter(new NoFilter(transparent)),
+        m_usedVertexCount(0),
+        m_freeVertexCount(0),
+        m_vertexArrayValid(false),
         m_valid(true),
+        m_renderedBrushCount(0),
         m_showEdges(true),
         m_grayscale(false),
         m_tint(false),
@@ -78,30 +118,79 @@ namespace TrenchBroom {
         m_showHiddenBrushes(false) {}
         
         BrushRenderer::~BrushRenderer() {
+            MapUtils::clearAndDelete(m_brushInfos);
             delete m_filter;
             m_filter = NULL;
         }
 
         void BrushRenderer::addBrushes(const Model::BrushList& brushes) {
-            VectorUtils::append(m_brushes, brushes);
-            invalidate();
+            Model::BrushList::const_iterator it, end;
+            for (it = brushes.begin(), end = brushes.end(); it != end; ++it) {
+                Model::Brush* brush = *it;
+                if (m_brushInfos.count(brush) == 0) {
+                    m_brushInfos.insert(std::make_pair(brush, new BrushInfo()));
+                    m_brushes.push_back(brush);
+                }
+            }
+            m_valid = false;
         }
 
         void BrushRenderer::setBrushes(const Model::BrushList& brushes) {
+            // keep the vertices of brushes that are still present, so that only new brushes must be uploaded
+            BrushInfoMap brushInfos;
+            Model::BrushList::const_iterator it, end;
+            for (it = brushes.begin(), end = brushes.end(); it != end; ++it) {
+                const Model::Brush* brush = *it;
+                BrushInfoMap::iterator infoIt = m_brushInfos.find(brush);
+                if (infoIt != m_brushInfos.end()) {
+                    brushInfos.insert(*infoIt);
+                    m_brushInfos.erase(infoIt);
+                } else {
+                    brushInfos.insert(std::make_pair(brush, new BrushInfo()));
+                }
+            }
+            
+            BrushInfoMap::iterator infoIt, infoEnd;
+            for (infoIt = m_brushInfos.begin(), infoEnd = m_brushInfos.end(); infoIt != infoEnd; ++infoIt) {
+                BrushInfo* info = infoIt->second;
+                freeVertices(info->vertexOffset, info->vertexCapacity);
+                delete info;
+            }
+            
+            using std::swap;
+            swap(m_brushInfos, brushInfos);
             m_brushes = brushes;
-            invalidate();
+            m_valid = false;
         }
 
         void BrushRenderer::invalidate() {
-            m_vertexArray = VertexArray();
+            BrushInfoMap::iterator it, end;
+            for (it = m_brushInfos.begin(), end = m_brushInfos.end(); it != end; ++it)
+                it->second->valid = false;
             m_valid = false;
         }
         
+        void BrushRenderer::invalidateBrushes(const Model::BrushList& brushes) {
+            Model::BrushList::const_iterator it, end;
+            for (it = brushes.begin(), end = brushes.end(); it != end; ++it) {
+                BrushInfoMap::iterator infoIt = m_brushInfos.find(*it);
+                if (infoIt != m_brushInfos.end()) {
+                    infoIt->second->valid = false;
+                    m_valid = false;
+                }
+            }
+        }
+        
         void BrushRenderer::clear() {
             m_brushes.clear();
+            clearBrushInfos();
             m_transparentFaceRenderer = FaceRenderer();
             m_opaqueFaceRenderer = FaceRenderer();
-            m_vertexArray = VertexArray();
+            m_edgeRenderer = IndexedEdgeRenderer();
+            m_culledOpaqueFaceRenderer = FaceRenderer();
+            m_culledTransparentFaceRenderer = FaceRenderer();
+            m_culledEdgeRenderer = IndexedEdgeRenderer();
+            m_renderedBrushCount = 0;
             m_valid = true;
         }
 
@@ -149,34 +238,76 @@ namespace TrenchBroom {
         }
 
         void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
+            m_renderedBrushCount = m_brushes.size();
             if (!m_brushes.empty()) {
                 if (!m_valid)
                     validate();
                 if (renderContext.showFaces())
-                    renderFaces(renderBatch);
+                    renderFaces(renderBatch, m_opaqueFaceRenderer, m_transparentFaceRenderer);
+                if (renderContext.showEdges() && m_showEdges)
+                    renderEdges(renderBatch, m_edgeRenderer);
+            }
+        }
+        
+        void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch, const Model::BrushList& visibleBrushes) {
+            m_renderedBrushCount = 0;
+            if (m_brushes.empty())
+                return;
+            
+            if (!m_valid)
+                validate();
+            
+            BrushInfoList infos;
+            infos.reserve(std::min(visibleBrushes.size(), m_brushes.size()));
+            
+            Model::BrushList::const_iterator it, end;
+            for (it = visibleBrushes.begin(), end = visibleBrushes.end(); it != end; ++it) {
+                BrushInfoMap::const_iterator infoIt = m_brushInfos.find(*it);
+                if (infoIt != m_brushInfos.end())
+                    infos.push_back(infoIt->second);
+            }
+            
+            m_renderedBrushCount = infos.size();
+            if (infos.size() == m_brushes.size()) {
+                // nothing was culled, so the indices of all brushes can be used as they are
+                if (renderContext.showFaces())
+                    renderFaces(renderBatch, m_opaqueFaceRenderer, m_transparentFaceRenderer);
+                if (renderContext.showEdges() && m_showEdges)
+                    renderEdges(renderBatch, m_edgeRenderer);
+            } else if (!infos.empty()) {
+                buildIndices(infos, m_culledOpaqueFaceRenderer, m_culledTransparentFaceRenderer, m_culledEdgeRenderer);
+                if (renderContext.showFaces())
+                    renderFaces(renderBatch, m_culledOpaqueFaceRenderer, m_culledTransparentFaceRenderer);
                 if (renderContext.showEdges() && m_showEdges)
-                    renderEdges(renderBatch);
+                    renderEdges(renderBatch, m_culledEdgeRenderer);
             }
         }
         
+        size_t BrushRenderer::brushCount() const {
+            return m_brushes.size();
+        }
+        
+        size_t BrushRenderer::renderedBrushCount() const {
+            return m_renderedBrushCount;
+        }
 
-        void BrushRenderer::renderFaces(RenderBatch& renderBatch) {
-            m_opaqueFaceRenderer.setGrayscale(m_grayscale);
-            m_opaqueFaceRenderer.setTint(m_tint);
-            m_opaqueFaceRenderer.setTintColor(m_tintColor);
-            m_opaqueFaceRenderer.render(renderBatch);
-            
-            m_transparentFaceRenderer.setGrayscale(m_grayscale);
-            m_transparentFaceRenderer.setTint(m_tint);
-            m_transparentFaceRenderer.setTintColor(m_tintColor);
-            m_transparentFaceRenderer.setAlpha(m_transparencyAlpha);
-            m_transparentFaceRenderer.render(renderBatch);
+        void BrushRenderer::renderFaces(RenderBatch& renderBatch, FaceRenderer& opaqueFaceRenderer, FaceRenderer& transparentFaceRenderer) {
+            opaqueFaceRenderer.setGrayscale(m_grayscale);
+            opaqueFaceRenderer.setTint(m_tint);
+            opaqueFaceRenderer.setTintColor(m_tintColor);
+            opaqueFaceRenderer.render(renderBatch);
+            
+            transparentFaceRenderer.setGrayscale(m_grayscale);
+            transparentFaceRenderer.setTint(m_tint);
+            transparentFaceRenderer.setTintColor(m_tintColor);
+            transparentFaceRenderer.setAlpha(m_transparencyAlpha);
+            transparentFaceRenderer.render(renderBatch);
         }
         
-        void BrushRenderer::renderEdges(RenderBatch& renderBatch) {
+        void BrushRenderer::renderEdges(RenderBatch& renderBatch, IndexedEdgeRenderer& edgeRenderer) {
             if (m_showOccludedEdges)
-                m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
-            m_edgeRenderer.render(renderBatch, m_edgeColor);
+                edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+            edgeRenderer.render(renderBatch, m_edgeColor);
         }
 
         class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
@@ -193,227 +324,215 @@ namespace TrenchBroom {
             bool doIsTransparent(const Model::Brush* brush) const { return m_filter.transparent(brush); }
         };
 
-        class BrushRenderer::CountVertices : public Model::ConstNodeVisitor {
-        private:
-            const FilterWrapper& m_filter;
-            size_t m_vertexCount;
-        public:
-            CountVertices(const FilterWrapper& filter) :
-            m_filter(filter),
-            m_vertexCount(0) {}
+        void BrushRenderer::validate() {
+            assert(!m_valid);
             
-            size_t vertexCount() const {
-                return m_vertexCount;
-            }
-        private:
-            void doVisit(const Model::World* world) {}
-            void doVisit(const Model::Layer* layer) {}
-            void doVisit(const Model::Group* group) {}
-            void doVisit(const Model::Entity* entity) {}
-            void doVisit(const Model::Brush* brush) {
-                countFaceVertices(brush);
+            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
+            Model::BrushList::const_iterator it, end;
+            for (it = m_brushes.begin(), end = m_brushes.end(); it != end; ++it) {
+                const Model::Brush* brush = *it;
+                BrushInfo* info = MapUtils::find(m_brushInfos, brush, static_cast<BrushInfo*>(NULL));
+                assert(info != NULL);
+                if (!info->valid)
+                    validateBrush(wrapper, brush, info);
             }
             
-            void countFaceVertices(const Model::Brush* brush) {
-                const Model::BrushFaceList& faces = brush->faces();
-                Model::BrushFaceList::const_iterator it, end;
-                for (it = faces.begin(), end = faces.end(); it != end; ++it) {
-                    const Model::BrushFace* face = *it;
-                    if (m_filter.show(face)) {
-                        m_vertexCount += face->vertexCount();
-                    }
-                }
-            }
-        };
-
-        class BrushRenderer::CollectVertices : public Model::ConstNodeVisitor {
-        private:
-            const FilterWrapper& m_filter;
-            VertexListBuilder<Model::BrushFace::Vertex::Spec> m_builder;
-        public:
-            CollectVertices(const FilterWrapper& filter, const size_t faceVertexCount) :
-            m_filter(filter),
-            m_builder(faceVertexCount) {}
+            if (m_freeVertexCount > m_usedVertexCount / 2)
+                compactVertices();
             
-            VertexArray vertexArray() {
-                return VertexArray::swap(m_builder.vertices());
-            }
-        private:
-            void doVisit(const Model::World* world) {}
-            void doVisit(const Model::Layer* layer) {}
-            void doVisit(const Model::Group* group) {}
-            void doVisit(const Model::Entity* entity) {}
-            void doVisit(const Model::Brush* brush) {
-                collectFaceVertices(brush);
+            if (!m_vertexArrayValid) {
+                m_vertexArray = VertexArray::ref(m_vertices);
+                m_vertexArrayValid = true;
             }
             
-            void collectFaceVertices(const Model::Brush* brush) {
-                const Model::BrushFaceList& faces = brush->faces();
-                Model::BrushFaceList::const_iterator it, end;
-                for (it = faces.begin(), end = faces.end(); it != end; ++it) {
-                    const Model::BrushFace* face = *it;
-                    if (m_filter.show(face))
-                        face->getVertices(m_builder);
-                }
-            }
-        };
+            validateIndices();
+            m_valid = true;
+        }
         
-        class BrushRenderer::CountIndices : public Model::ConstNodeVisitor {
-        private:
-            const FilterWrapper& m_filter;
-            TexturedIndexArrayMap::Size m_opaqueIndexSize;
-            TexturedIndexArrayMap::Size m_transparentIndexSize;
-            IndexArrayMap::Size m_edgeIndexSize;
-        public:
-            CountIndices(const FilterWrapper& filter) :
-            m_filter(filter) {}
+        void BrushRenderer::validateBrush(const FilterWrapper& filter, const Model::Brush* brush, BrushInfo* info) {
+            VertexListBuilder<Model::BrushFace::Vertex::Spec> builder;
+            info->faces.clear();
+            info->edges.clear();
+            info->transparent = filter.transparent(brush);
             
-            const TexturedIndexArrayMap::Size& opaqueIndexSize() const {
-                return m_opaqueIndexSize;
-            }
-            
-            const TexturedIndexArrayMap::Size& transparentIndexSize() const {
-                return m_transparentIndexSize;
-            }
-            
-            const IndexArrayMap::Size& edgeIndexSize() const {
-                return m_edgeIndexSize;
-            }
-        private:
-            void doVisit(const Model::World* world) {}
-            void doVisit(const Model::Layer* layer) {}
-            void doVisit(const Model::Group* group) {}
-            void doVisit(const Model::Entity* entity) {}
-            void doVisit(const Model::Brush* brush) {
-                countFaceIndices(brush);
-                countEdgeIndices(brush);
+            const Model::BrushFaceList& faces = brush->faces();
+            Model::BrushFaceList::const_iterator fIt, fEnd;
+            for (fIt = faces.begin(), fEnd = faces.end(); fIt != fEnd; ++fIt) {
+                const Model::BrushFace* face = *fIt;
+                if (filter.show(face)) {
+                    const size_t index = builder.vertexCount();
+                    face->getVertices(builder);
+                    info->faces.push_back(BrushInfo::FaceIndices(face->texture(), index, face->vertexCount()));
+                }
             }
             
-            void countFaceIndices(const Model::Brush* brush) {
-                const Model::BrushFaceList& faces = brush->faces();
-                Model::BrushFaceList::const_iterator it, end;
-                for (it = faces.begin(), end = faces.end(); it != end; ++it) {
-                    const Model::BrushFace* face = *it;
-                    if (m_filter.show(face)) {
-                        if (m_filter.transparent(brush))
-                            face->countIndices(m_transparentIndexSize);
-                        else
-                            face->countIndices(m_opaqueIndexSize);
+            const GLuint vertexCount = static_cast<GLuint>(builder.vertexCount());
+            const Model::Brush::EdgeList& edges = brush->edges();
+            Model::Brush::EdgeList::const_iterator eIt, eEnd;
+            for (eIt = edges.begin(), eEnd = edges.end(); eIt != eEnd; ++eIt) {
+                const Model::BrushEdge* edge = *eIt;
+                if (filter.show(edge)) {
+                    // the vertex payloads are only valid if one of the adjacent faces was collected above
+                    const GLuint index1 = edge->firstVertex()->payload();
+                    const GLuint index2 = edge->secondVertex()->payload();
+                    if (index1 < vertexCount && index2 < vertexCount) {
+                        info->edges.push_back(index1);
+                        info->edges.push_back(index2);
                     }
                 }
             }
             
-            void countEdgeIndices(const Model::Brush* brush) {
-                const Model::Brush::EdgeList& edges = brush->edges();
-                Model::Brush::EdgeList::const_iterator it, end;
-                for (it = edges.begin(), end = edges.end(); it != end; ++it) {
-                    const Model::BrushEdge* edge = *it;
-                    if (m_filter.show(edge))
-                        m_edgeIndexSize.inc(GL_LINES, 2);
-                }
+            // rewrite the brush's vertices in place if they fit, otherwise move them to a new range
+            const VertexList& vertices = builder.vertices();
+            if (vertices.size() > info->vertexCapacity) {
+                freeVertices(info->vertexOffset, info->vertexCapacity);
+                info->vertexOffset = allocateVertices(vertices.size());
+                info->vertexCapacity = vertices.size();
             }
-        };
-        
-        class BrushRenderer::CollectIndices : public Model::ConstNodeVisitor {
-        private:
-            const FilterWrapper& m_filter;
-            TexturedIndexArrayBuilder m_opaqueFaceIndexBuilder;
-            TexturedIndexArrayBuilder m_transparentFaceIndexBuilder;
-            IndexArrayMapBuilder m_edgeIndexBuilder;
-        public:
-            CollectIndices(const FilterWrapper& filter, const CountIndices& indexSize) :
-            m_filter(filter),
-            m_opaqueFaceIndexBuilder(indexSize.opaqueIndexSize()),
-            m_transparentFaceIndexBuilder(indexSize.transparentIndexSize()),
-            m_edgeIndexBuilder(indexSize.edgeIndexSize()) {}
+            info->vertexCount = vertices.size();
             
-            TexturedIndexArrayBuilder& opaqueFaceIndices() {
-                return m_opaqueFaceIndexBuilder;
-            }
+            std::copy(vertices.begin(), vertices.end(), m_vertices.begin() + static_cast<VertexList::difference_type>(info->vertexOffset));
+            if (m_vertexArrayValid)
+                m_vertexArray.update(info->vertexOffset, info->vertexCount);
+            info->valid = true;
+        }
+        
+        void BrushRenderer::validateIndices() {
+            BrushInfoList infos;
+            infos.reserve(m_brushes.size());
             
-            TexturedIndexArrayBuilder& transparentFaceIndices() {
-                return m_transparentFaceIndexBuilder;
-            }
+            Model::BrushList::const_iterator it, end;
+            for (it = m_brushes.begin(), end = m_brushes.end(); it != end; ++it)
+                infos.push_back(MapUtils::find(m_brushInfos, *it, static_cast<BrushInfo*>(NULL)));
             
-            IndexArrayMapBuilder& edgeIndices() {
-                return m_edgeIndexBuilder;
-            }
-        private:
-            void doVisit(const Model::World* world) {}
-            void doVisit(const Model::Layer* layer) {}
-            void doVisit(const Model::Group* group) {}
-            void doVisit(const Model::Entity* entity) {}
-            void doVisit(const Model::Brush* brush) {
-                collectFaceIndices(brush);
-                collectEdgeIndices(brush);
-            }
+            buildIndices(infos, m_opaqueFaceRenderer, m_transparentFaceRenderer, m_edgeRenderer);
+        }
+        
+        void BrushRenderer::buildIndices(const BrushInfoList& infos, FaceRenderer& opaqueFaceRenderer, FaceRenderer& transparentFaceRenderer, IndexedEdgeRenderer& edgeRenderer) const {
+            TexturedIndexArrayMap::Size opaqueIndexSize;
+            TexturedIndexArrayMap::Size transparentIndexSize;
+            IndexArrayMap::Size edgeIndexSize;
             
-            void collectFaceIndices(const Model::Brush* brush) {
-                const Model::BrushFaceList& faces = brush->faces();
-                Model::BrushFaceList::const_iterator it, end;
-                for (it = faces.begin(), end = faces.end(); it != end; ++it) {
-                    const Model::BrushFace* face = *it;
-                    if (m_filter.show(face)) {
-                        if (m_filter.transparent(brush))
-                            face->getFaceIndices(m_transparentFaceIndexBuilder);
-                        else
-                            face->getFaceIndices(m_opaqueFaceIndexBuilder);
-                    }
+            BrushInfoList::const_iterator it, end;
+            for (it = infos.begin(), end = infos.end(); it != end; ++it) {
+                const BrushInfo* info = *it;
+                TexturedIndexArrayMap::Size& faceIndexSize = info->transparent ? transparentIndexSize : opaqueIndexSize;
+                
+                BrushInfo::FaceIndicesList::const_iterator fIt, fEnd;
+                for (fIt = info->faces.begin(), fEnd = info->faces.end(); fIt != fEnd; ++fIt) {
+                    if (fIt->count == 4)
+                        faceIndexSize.inc(fIt->texture, GL_QUADS, 4);
+                    else
+                        faceIndexSize.inc(fIt->texture, GL_TRIANGLES, 3 * (fIt->count - 2));
                 }
+                if (!info->edges.empty())
+                    edgeIndexSize.inc(GL_LINES, info->edges.size());
             }
             
-            void collectEdgeIndices(const Model::Brush* brush) {
-                const Model::Brush::EdgeList& edges = brush->edges();
-                Model::Brush::EdgeList::const_iterator it, end;
-                for (it = edges.begin(), end = edges.end(); it != end; ++it) {
-                    const Model::BrushEdge* edge = *it;
-                    if (m_filter.show(edge)) {
-                        const Model::BrushVertex* v1 = edge->firstVertex();
-                        const Model::BrushVertex* v2 = edge->secondVertex();
-                        m_edgeIndexBuilder.addLine(v1->payload(), v2->payload());
-                    }
+            TexturedIndexArrayBuilder opaqueFaceIndexBuilder(opaqueIndexSize);
+            TexturedIndexArrayBuilder transparentFaceIndexBuilder(transparentIndexSize);
+            IndexArrayMapBuilder edgeIndexBuilder(edgeIndexSize);
+            
+            for (it = infos.begin(), end = infos.end(); it != end; ++it) {
+                const BrushInfo* info = *it;
+                TexturedIndexArrayBuilder& faceIndexBuilder = info->transparent ? transparentFaceIndexBuilder : opaqueFaceIndexBuilder;
+                const GLuint offset = static_cast<GLuint>(info->vertexOffset);
+                
+                BrushInfo::FaceIndicesList::const_iterator fIt, fEnd;
+                for (fIt = info->faces.begin(), fEnd = info->faces.end(); fIt != fEnd; ++fIt) {
+                    const GLuint index = offset + static_cast<GLuint>(fIt->index);
+                    if (fIt->count == 4)
+                        faceIndexBuilder.addQuads(fIt->texture, index, fIt->count);
+                    else
+                        faceIndexBuilder.addPolygon(fIt->texture, index, fIt->count);
                 }
+                
+                BrushInfo::EdgeIndexList::const_iterator eIt, eEnd;
+                for (eIt = info->edges.begin(), eEnd = info->edges.end(); eIt != eEnd; eIt += 2)
+                    edgeIndexBuilder.addLine(offset + *eIt, offset + *(eIt + 1));
             }
-        };
-        
-        void BrushRenderer::validate() {
-            assert(!m_valid);
-            validateVertices();
-            validateIndices();
-            m_valid = true;
-        }
-        
-        void BrushRenderer::validateVertices() {
-            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
-            CountVertices countVertices(wrapper);
-            Model::Node::accept(m_brushes.begin(), m_brushes.end(), countVertices);
             
-            CollectVertices collectVertices(wrapper, countVertices.vertexCount());
-            Model::Node::accept(m_brushes.begin(), m_brushes.end(), collectVertices);
+            const IndexArray opaqueIndices = IndexArray::swap(opaqueFaceIndexBuilder.indices());
+            const TexturedIndexArrayMap& opaqueRanges = opaqueFaceIndexBuilder.ranges();
+            
+            const IndexArray transparentIndices = IndexArray::swap(transparentFaceIndexBuilder.indices());
+            const TexturedIndexArrayMap& transparentRanges = transparentFaceIndexBuilder.ranges();
+            
+            opaqueFaceRenderer = FaceRenderer(m_vertexArray, opaqueIndices, opaqueRanges, m_faceColor);
+            transparentFaceRenderer = FaceRenderer(m_vertexArray, transparentIndices, transparentRanges, m_faceColor);
             
-            m_vertexArray = collectVertices.vertexArray();
+            const IndexArray edgeIndices = IndexArray::swap(edgeIndexBuilder.indices());
+            const IndexArrayMap& edgeRanges = edgeIndexBuilder.ranges();
+            edgeRenderer = IndexedEdgeRenderer(m_vertexArray, edgeIndices, edgeRanges);
         }
         
-        void BrushRenderer::validateIndices() {
-            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
-            CountIndices countIndices(wrapper);
-            Model::Node::accept(m_brushes.begin(), m_brushes.end(), countIndices);
+        size_t BrushRenderer::allocateVertices(const size_t count) {
+            if (count == 0)
+                return 0;
             
-            CollectIndices collectIndices(wrapper, countIndices);
-            Model::Node::accept(m_brushes.begin(), m_brushes.end(), collectIndices);
+            FreeVertexMap::iterator it = m_freeVertices.lower_bound(count);
+            if (it != m_freeVertices.end()) {
+                const size_t capacity = it->first;
+                const size_t offset = it->second;
+                m_freeVertices.erase(it);
+                m_freeVertexCount -= capacity;
+                
+                if (capacity > count)
+                    freeVertices(offset + count, capacity - count);
+                return offset;
+            }
             
-            const IndexArray opaqueIndices = IndexArray::swap(collectIndices.opaqueFaceIndices().indices());
-            const TexturedIndexArrayMap& opaqueRanges = collectIndices.opaqueFaceIndices().ranges();
+            const size_t offset = m_usedVertexCount;
+            m_usedVertexCount += count;
+            if (m_usedVertexCount > m_vertices.size()) {
+                // leave some room so that growing brushes don't force a complete upload every time
+                m_vertices.resize(std::max(m_usedVertexCount, m_vertices.size() + m_vertices.size() / 2));
+                m_vertexArrayValid = false;
+            }
+            return offset;
+        }
+        
+        void BrushRenderer::freeVertices(const size_t offset, const size_t count) {
+            if (count > 0) {
+                m_freeVertices.insert(std::make_pair(count, offset));
+                m_freeVertexCount += count;
+            }
+        }
+        
+        void BrushRenderer::compactVertices() {
+            VertexList vertices(m_usedVertexCount - m_freeVertexCount);
+            size_t offset = 0;
             
-            const IndexArray transparentIndices = IndexArray::swap(collectIndices.transparentFaceIndices().indices());
-            const TexturedIndexArrayMap& transparentRanges = collectIndices.transparentFaceIndices().ranges();
+            BrushInfoMap::iterator it, end;
+            for (it = m_brushInfos.begin(), end = m_brushInfos.end(); it != end; ++it) {
+                BrushInfo* info = it->second;
+                if (info->vertexCapacity > 0) {
+                    const VertexList::iterator first = m_vertices.begin() + static_cast<VertexList::difference_type>(info->vertexOffset);
+                    std::copy(first, first + static_cast<VertexList::difference_type>(info->vertexCount), vertices.begin() + static_cast<VertexList::difference_type>(offset));
+                    info->vertexOffset = offset;
+                    info->vertexCapacity = info->vertexCount;
+                    offset += info->vertexCount;
+                }
+            }
             
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, opaqueIndices, opaqueRanges, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, transparentIndices, transparentRanges, m_faceColor);
+            vertices.resize(offset);
             
-            const IndexArray edgeIndices = IndexArray::swap(collectIndices.edgeIndices().indices());
-            const IndexArrayMap& edgeRanges = collectIndices.edgeIndices().ranges();
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, edgeIndices, edgeRanges);
+            using std::swap;
+            swap(m_vertices, vertices);
+            m_usedVertexCount = offset;
+            m_freeVertices.clear();
+            m_freeVertexCount = 0;
+            m_vertexArrayValid = false;
+        }
+        
+        void BrushRenderer::clearBrushInfos() {
+            MapUtils::clearAndDelete(m_brushInfos);
+            m_vertices.clear();
+            m_usedVertexCount = 0;
+            m_freeVertices.clear();
+            m_freeVertexCount = 0;
+            m_vertexArray = VertexArray();
+            m_vertexArrayValid = false;
         }
     }
 }
@@ -25,6 +25,9 @@
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
 
+#include <map>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         class EditorContext;
@@ -83,19 +86,36 @@ namespace TrenchBroom {
             };
         private:
             class FilterWrapper;
-            class CountVertices;
-            class CollectVertices;
-            class CountIndices;
-            class CollectIndices;
+            class BrushInfo;
+            
+            typedef Model::BrushFace::Vertex::List VertexList;
+            typedef std::map<const Model::Brush*, BrushInfo*> BrushInfoMap;
+            typedef std::vector<const BrushInfo*> BrushInfoList;
+            typedef std::multimap<size_t, size_t> FreeVertexMap;
         private:
             Filter* m_filter;
             Model::BrushList m_brushes;
+            BrushInfoMap m_brushInfos;
+            
+            // the vertices of all brushes, each brush owns a contiguous range of these
+            VertexList m_vertices;
+            size_t m_usedVertexCount;
+            FreeVertexMap m_freeVertices;
+            size_t m_freeVertexCount;
+            
             VertexArray m_vertexArray;
+            bool m_vertexArrayValid;
             FaceRenderer m_opaqueFaceRenderer;
             FaceRenderer m_transparentFaceRenderer;
             IndexedEdgeRenderer m_edgeRenderer;
             bool m_valid;
             
+            // rebuilt in every frame from the brushes that are visible in that frame
+            FaceRenderer m_culledOpaqueFaceRenderer;
+            FaceRenderer m_culledTransparentFaceRenderer;
+            IndexedEdgeRenderer m_culledEdgeRenderer;
+            size_t m_renderedBrushCount;
+            
             Color m_faceColor;
             bool m_showEdges;
             Color m_edgeColor;
@@ -111,7 +131,11 @@ namespace TrenchBroom {
             template <typename FilterT>
             BrushRenderer(const FilterT& filter) :
             m_filter(new FilterT(filter)),
+            m_usedVertexCount(0),
+            m_freeVertexCount(0),
+            m_vertexArrayValid(false),
             m_valid(true),
+            m_renderedBrushCount(0),
             m_showEdges(true),
             m_grayscale(false),
             m_tint(false),
@@ -128,6 +152,8 @@ namespace TrenchBroom {
             void clear();
             
             void invalidate();
+            // only the given brushes are collected again, the others keep their vertices in the buffer
+            void invalidateBrushes(const Model::BrushList& brushes);
             
             void setFaceColor(const Color& faceColor);
             void setShowEdges(bool showEdges);
@@ -141,13 +167,24 @@ namespace TrenchBroom {
             void setShowHiddenBrushes(bool showHiddenBrushes);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
+            // renders only those of the given brushes which belong to this renderer
+            void render(RenderContext& renderContext, RenderBatch& renderBatch, const Model::BrushList& visibleBrushes);
+            
+            size_t brushCount() const;
+            size_t renderedBrushCount() const;
         private:
-            void renderFaces(RenderBatch& renderBatch);
-            void renderEdges(RenderBatch& renderBatch);
+            void renderFaces(RenderBatch& renderBatch, FaceRenderer& opaqueFaceRenderer, FaceRenderer& transparentFaceRenderer);
+            void renderEdges(RenderBatch& renderBatch, IndexedEdgeRenderer& edgeRenderer);
             
             void validate();
-            void validateVertices();
+            void validateBrush(const FilterWrapper& filter, const Model::Brush* brush, BrushInfo* info);
             void validateIndices();
+            void buildIndices(const BrushInfoList& infos, FaceRenderer& opaqueFaceRenderer, FaceRenderer& transparentFaceRenderer, IndexedEdgeRenderer& edgeRenderer) const;
+            
+            size_t allocateVertices(size_t count);
+            void freeVertices(size_t offset, size_t count);
+            void compactVertices();
+            void clearBrushInfos();
         };
     }
 }
@@ -41,7 +41,8 @@ namespace TrenchBroom {
         m_document(document),
         m_defaultColor(0.5f, 1.0f, 0.5f, 1.0f),
         m_selectedColor(1.0f, 0.0f, 0.0f, 1.0f),
-        m_valid(false) {}
+        m_valid(false),
+        m_allLinksValid(false) {}
         
         void EntityLinkRenderer::setDefaultColor(const Color& color) {
             if (color == m_defaultColor)
@@ -64,6 +65,11 @@ namespace TrenchBroom {
         void EntityLinkRenderer::invalidate() {
             m_valid = false;
         }
+        
+        void EntityLinkRenderer::invalidateLinks() {
+            m_allLinksValid = false;
+            invalidate();
+        }
 
         void EntityLinkRenderer::doPrepareVertices(Vbo& vertexVbo) {
             if (!m_valid) {
@@ -103,6 +109,14 @@ namespace TrenchBroom {
         
         class EntityLinkRenderer::CollectEntitiesVisitor : public Model::CollectMatchingNodesVisitor<MatchEntities, Model::UniqueNodeCollectionStrategy> {};
 
+        void EntityLinkRenderer::addLink(const Model::AttributableNode* source, const Model::AttributableNode* target, const Color& defaultColor, const Color& selectedColor, Vertex::List& links) {
+            const bool anySelected = source->selected() || source->descendantSelected() || target->selected() || target->descendantSelected();
+            const Color& color = anySelected ? selectedColor : defaultColor;
+            
+            links.push_back(Vertex(source->linkSourceAnchor(), color));
+            links.push_back(Vertex(target->linkTargetAnchor(), color));
+        }
+        
         class EntityLinkRenderer::CollectLinksVisitor : public Model::NodeVisitor {
         protected:
             const Model::EditorContext& m_editorContext;
@@ -130,34 +144,31 @@ namespace TrenchBroom {
             virtual void visitEntity(Model::Entity* entity) = 0;
         protected:
             void addLink(const Model::AttributableNode* source, const Model::AttributableNode* target) {
-                const bool anySelected = source->selected() || source->descendantSelected() || target->selected() || target->descendantSelected();
-                const Color& sourceColor = anySelected ? m_selectedColor : m_defaultColor;
-                Color targetColor = anySelected ? m_selectedColor : m_defaultColor;
-                
-                m_links.push_back(Vertex(source->linkSourceAnchor(), sourceColor));
-                m_links.push_back(Vertex(target->linkTargetAnchor(), targetColor));
+                EntityLinkRenderer::addLink(source, target, m_defaultColor, m_selectedColor, m_links);
             }
         };
         
-        class EntityLinkRenderer::CollectAllLinksVisitor : public CollectLinksVisitor {
+        class EntityLinkRenderer::CollectAllLinksVisitor : public Model::NodeVisitor {
+        private:
+            LinkList& m_links;
         public:
-            CollectAllLinksVisitor(const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, Vertex::List& links) :
-            CollectLinksVisitor(editorContext, defaultColor, selectedColor, links) {}
+            CollectAllLinksVisitor(LinkList& links) :
+            m_links(links) {}
         private:
-            void visitEntity(Model::Entity* entity) {
-                if (m_editorContext.visible(entity)) {
-                    addTargets(entity, entity->linkTargets());
-                    addTargets(entity, entity->killTargets());
-                }
+            void doVisit(Model::World* world)   {}
+            void doVisit(Model::Layer* layer)   {}
+            void doVisit(Model::Group* group)   {}
+            void doVisit(Model::Brush* brush)   {}
+            void doVisit(Model::Entity* entity) {
+                addTargets(entity, entity->linkTargets());
+                addTargets(entity, entity->killTargets());
+                stopRecursion();
             }
             
             void addTargets(Model::Entity* source, const Model::AttributableNodeList& targets) {
                 Model::AttributableNodeList::const_iterator it, end;
-                for (it = targets.begin(), end = targets.end(); it != end; ++it) {
-                    const Model::AttributableNode* target = *it;
-                    if (m_editorContext.visible(target))
-                        addLink(source, target);
-                }
+                for (it = targets.begin(), end = targets.end(); it != end; ++it)
+                    m_links.push_back(Link(source, *it));
             }
         };
         
@@ -236,7 +247,7 @@ namespace TrenchBroom {
             }
         };
         
-        void EntityLinkRenderer::getLinks(Vertex::List& links) const {
+        void EntityLinkRenderer::getLinks(Vertex::List& links) {
             View::MapDocumentSPtr document = lock(m_document);
             const Model::EditorContext& editorContext = document->editorContext();
             switch (editorContext.entityLinkMode()) {
@@ -255,15 +266,30 @@ namespace TrenchBroom {
             }
         }
         
-        void EntityLinkRenderer::getAllLinks(Vertex::List& links) const {
+        void EntityLinkRenderer::getAllLinks(Vertex::List& links) {
             View::MapDocumentSPtr document = lock(m_document);
             const Model::EditorContext& editorContext = document->editorContext();
             
-            CollectAllLinksVisitor collectLinks(editorContext, m_defaultColor, m_selectedColor, links);
+            // the links only change with the entities and their attributes, so a change of the selection or
+            // visibility only needs to recolor and filter them
+            if (!m_allLinksValid) {
+                m_allLinks.clear();
+                
+                CollectAllLinksVisitor collectLinks(m_allLinks);
+                Model::World* world = document->world();
+                if (world != NULL)
+                    world->acceptAndRecurse(collectLinks);
+                m_allLinksValid = true;
+            }
             
-            Model::World* world = document->world();
-            if (world != NULL)
-                world->acceptAndRecurse(collectLinks);
+            links.reserve(2 * m_allLinks.size());
+            LinkList::const_iterator it, end;
+            for (it = m_allLinks.begin(), end = m_allLinks.end(); it != end; ++it) {
+                const Model::AttributableNode* source = it->first;
+                const Model::AttributableNode* target = it->second;
+                if (editorContext.visible(source) && editorContext.visible(target))
+                    addLink(source, target, m_defaultColor, m_selectedColor, links);
+            }
         }
         
         void EntityLinkRenderer::getTransitiveSelectedLinks(Vertex::List& links) const {
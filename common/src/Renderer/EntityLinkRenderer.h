@@ -27,6 +27,9 @@
 #include "Renderer/VertexArray.h"
 #include "View/ViewTypes.h"
 
+#include <utility>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         class EditorContext;
@@ -39,6 +42,8 @@ namespace TrenchBroom {
         class EntityLinkRenderer : public DirectRenderable {
         private:
             typedef VertexSpecs::P3C4::Vertex Vertex;
+            typedef std::pair<Model::AttributableNode*, Model::AttributableNode*> Link;
+            typedef std::vector<Link> LinkList;
             
             View::MapDocumentWPtr m_document;
             
@@ -47,6 +52,10 @@ namespace TrenchBroom {
             
             VertexArray m_entityLinks;
             bool m_valid;
+            
+            // all links between entities regardless of their visibility and selection
+            LinkList m_allLinks;
+            bool m_allLinksValid;
         public:
             EntityLinkRenderer(View::MapDocumentWPtr document);
             
@@ -55,6 +64,7 @@ namespace TrenchBroom {
             
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void invalidate();
+            void invalidateLinks();
         private:
             void doPrepareVertices(Vbo& vertexVbo);
             void doRender(RenderContext& renderContext);
@@ -69,12 +79,14 @@ namespace TrenchBroom {
             class CollectTransitiveSelectedLinksVisitor;
             class CollectDirectSelectedLinksVisitor;
 
-            void getLinks(Vertex::List& links) const;
-            void getAllLinks(Vertex::List& links) const;
+            void getLinks(Vertex::List& links);
+            void getAllLinks(Vertex::List& links);
             void getTransitiveSelectedLinks(Vertex::List& links) const;
             void getDirectSelectedLinks(Vertex::List& links) const;
             void collectSelectedLinks(CollectLinksVisitor& collectLinks) const;
             
+            static void addLink(const Model::AttributableNode* source, const Model::AttributableNode* target, const Color& defaultColor, const Color& selectedColor, Vertex::List& links);
+            
             EntityLinkRenderer(const EntityLinkRenderer& other);
             EntityLinkRenderer& operator=(const EntityLinkRenderer& other);
         };
@@ -111,7 +111,10 @@ namespace TrenchBroom {
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity))
                     continue;
                 
+                // renderers are prepared over several frames
                 TexturedIndexRangeRenderer* renderer = it->second;
+                if (!renderer->prepared())
+                    continue;
                 
                 const Mat4x4f translation(translationMatrix(entity->origin()));
                 const Mat4x4f rotation(entity->rotation());
@@ -79,10 +79,13 @@ namespace TrenchBroom {
         m_showOccludedBounds(false),
         m_showAngles(false),
         m_showHiddenEntities(false),
+        m_renderedEntityCount(0),
         m_vbo(0xFFF) {}
         
         void EntityRenderer::setEntities(const Model::EntityList& entities) {
+            // sorted so that the visible entities can be looked up in every frame
             m_entities = entities;
+            VectorUtils::sort(m_entities);
             reloadModels();
             invalidate();
         }
@@ -93,6 +96,7 @@ namespace TrenchBroom {
 
         void EntityRenderer::clear() {
             m_entities.clear();
+            m_renderedEntityCount = 0;
             m_wireframeBoundsRenderer = DirectEdgeRenderer();
             m_solidBoundsRenderer = TriangleRenderer();
             m_modelRenderer.clear();
@@ -155,14 +159,42 @@ namespace TrenchBroom {
         }
 
         void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
+            m_renderedEntityCount = m_entities.size();
             if (!m_entities.empty()) {
                 renderBounds(renderContext, renderBatch);
                 renderModels(renderContext, renderBatch);
-                renderClassnames(renderContext, renderBatch);
-                renderAngles(renderContext, renderBatch);
+                renderClassnames(renderContext, renderBatch, m_entities);
+                renderAngles(renderContext, renderBatch, m_entities);
             }
         }
         
+        void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch, const Model::EntityList& visibleEntities) {
+            m_renderedEntityCount = 0;
+            if (!m_entities.empty()) {
+                Model::EntityList entities;
+                Model::EntityList::const_iterator it, end;
+                for (it = visibleEntities.begin(), end = visibleEntities.end(); it != end; ++it) {
+                    Model::Entity* entity = *it;
+                    if (VectorUtils::setContains(m_entities, entity))
+                        entities.push_back(entity);
+                }
+                m_renderedEntityCount = entities.size();
+                
+                renderBounds(renderContext, renderBatch);
+                renderModels(renderContext, renderBatch);
+                renderClassnames(renderContext, renderBatch, entities);
+                renderAngles(renderContext, renderBatch, entities);
+            }
+        }
+        
+        size_t EntityRenderer::entityCount() const {
+            return m_entities.size();
+        }
+        
+        size_t EntityRenderer::renderedEntityCount() const {
+            return m_renderedEntityCount;
+        }
+        
         void EntityRenderer::renderBounds(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (!m_boundsValid)
                 validateBounds();
@@ -195,14 +227,14 @@ namespace TrenchBroom {
             }
         }
         
-        void EntityRenderer::renderClassnames(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void EntityRenderer::renderClassnames(RenderContext& renderContext, RenderBatch& renderBatch, const Model::EntityList& entities) {
             if (m_showOverlays && renderContext.showEntityClassnames()) {
                 Renderer::RenderService renderService(renderContext, renderBatch);
                 renderService.setForegroundColor(m_overlayTextColor);
                 renderService.setBackgroundColor(m_overlayBackgroundColor);
                 
                 Model::EntityList::const_iterator it, end;
-                for (it = m_entities.begin(), end = m_entities.end(); it != end; ++it) {
+                for (it = entities.begin(), end = entities.end(); it != end; ++it) {
                     const Model::Entity* entity = *it;
                     if (m_showHiddenEntities || m_editorContext.visible(entity)) {
                         if (m_showOccludedOverlays)
@@ -215,7 +247,7 @@ namespace TrenchBroom {
             }
         }
         
-        void EntityRenderer::renderAngles(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void EntityRenderer::renderAngles(RenderContext& renderContext, RenderBatch& renderBatch, const Model::EntityList& entities) {
             if (!m_showAngles)
                 return;
             
@@ -228,7 +260,7 @@ namespace TrenchBroom {
             
             Vec3f::List vertices(3);
             Model::EntityList::const_iterator it, end;
-            for (it = m_entities.begin(), end = m_entities.end(); it != end; ++it) {
+            for (it = entities.begin(), end = entities.end(); it != end; ++it) {
                 const Model::Entity* entity = *it;
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity))
                     continue;
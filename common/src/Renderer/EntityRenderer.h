@@ -70,6 +70,7 @@ namespace TrenchBroom {
             bool m_showAngles;
             Color m_angleColor;
             bool m_showHiddenEntities;
+            size_t m_renderedEntityCount;
             
             Vbo m_vbo;
         public:
@@ -123,13 +124,20 @@ namespace TrenchBroom {
             void setShowHiddenEntities(bool showHiddenEntities);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
+            // the bounds and models of all entities are rendered, but only the classnames and angles of the given
+            // entities which belong to this renderer; models are not culled because they may extend far beyond the
+            // bounds by which the visible entities were found
+            void render(RenderContext& renderContext, RenderBatch& renderBatch, const Model::EntityList& visibleEntities);
+            
+            size_t entityCount() const;
+            size_t renderedEntityCount() const;
         private:
             void renderBounds(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderWireframeBounds(RenderBatch& renderBatch);
             void renderSolidBounds(RenderBatch& renderBatch);
             void renderModels(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderClassnames(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderAngles(RenderContext& renderContext, RenderBatch& renderBatch);
+            void renderClassnames(RenderContext& renderContext, RenderBatch& renderBatch, const Model::EntityList& entities);
+            void renderAngles(RenderContext& renderContext, RenderBatch& renderBatch, const Model::EntityList& entities);
             Vec3f::List arrowHead(float length, float width) const;
             
             struct BuildColoredSolidBoundsVertices;
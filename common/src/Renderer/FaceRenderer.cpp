@@ -45,7 +45,7 @@ namespace TrenchBroom {
             void before(const Assets::Texture* texture) {
                 if (texture != NULL) {
                     texture->activate();
-                    shader.set("ApplyTexture", applyTexture);
+                    shader.set("ApplyTexture", applyTexture && texture->isPrepared());
                     shader.set("Color", texture->averageColor());
                 } else {
                     shader.set("ApplyTexture", false);
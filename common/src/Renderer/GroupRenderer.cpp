@@ -19,6 +19,7 @@
 
 #include "GroupRenderer.h"
 
+#include "CollectionUtils.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Model/EditorContext.h"
@@ -58,7 +59,9 @@ namespace TrenchBroom {
         m_showOccludedBounds(false) {}
         
         void GroupRenderer::setGroups(const Model::GroupList& groups) {
+            // sorted so that the visible groups can be looked up in every frame
             m_groups = groups;
+            VectorUtils::sort(m_groups);
             invalidate();
         }
 
@@ -106,7 +109,22 @@ namespace TrenchBroom {
         void GroupRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (!m_groups.empty()) {
                 renderBounds(renderContext, renderBatch);
-                renderNames(renderContext, renderBatch);
+                renderNames(renderContext, renderBatch, m_groups);
+            }
+        }
+        
+        void GroupRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch, const Model::GroupList& visibleGroups) {
+            if (!m_groups.empty()) {
+                Model::GroupList groups;
+                Model::GroupList::const_iterator it, end;
+                for (it = visibleGroups.begin(), end = visibleGroups.end(); it != end; ++it) {
+                    Model::Group* group = *it;
+                    if (VectorUtils::setContains(m_groups, group))
+                        groups.push_back(group);
+                }
+                
+                renderBounds(renderContext, renderBatch);
+                renderNames(renderContext, renderBatch, groups);
             }
         }
         
@@ -119,14 +137,14 @@ namespace TrenchBroom {
             m_boundsRenderer.render(renderBatch, m_overrideBoundsColor, m_boundsColor);
         }
         
-        void GroupRenderer::renderNames(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void GroupRenderer::renderNames(RenderContext& renderContext, RenderBatch& renderBatch, const Model::GroupList& groups) {
             if (m_showOverlays) {
                 Renderer::RenderService renderService(renderContext, renderBatch);
                 renderService.setForegroundColor(m_overlayTextColor);
                 renderService.setBackgroundColor(m_overlayBackgroundColor);
                 
                 Model::GroupList::const_iterator it, end;
-                for (it = m_groups.begin(), end = m_groups.end(); it != end; ++it) {
+                for (it = groups.begin(), end = groups.end(); it != end; ++it) {
                     const Model::Group* group = *it;
                     if (m_editorContext.visible(group)) {
                         const GroupNameAnchor anchor(group);
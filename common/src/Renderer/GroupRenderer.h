@@ -94,9 +94,11 @@ namespace TrenchBroom {
             void setOccludedBoundsColor(const Color& occludedBoundsColor);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
+            // the bounds of all groups are rendered, but only the names of the given groups which belong to this renderer
+            void render(RenderContext& renderContext, RenderBatch& renderBatch, const Model::GroupList& visibleGroups);
         private:
             void renderBounds(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderNames(RenderContext& renderContext, RenderBatch& renderBatch);
+            void renderNames(RenderContext& renderContext, RenderBatch& renderBatch, const Model::GroupList& groups);
             
             struct BuildColoredBoundsVertices;
             struct BuildBoundsVertices;
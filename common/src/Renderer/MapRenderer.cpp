@@ -19,11 +19,13 @@
 
 #include "MapRenderer.h"
 
+#include "AttrString.h"
 #include "CollectionUtils.h"
 #include "Macros.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Assets/EntityDefinitionManager.h"
+#include "Model/AssortNodesVisitor.h"
 #include "Model/Brush.h"
 #include "Model/CollectMatchingNodesVisitor.h"
 #include "Model/EditorContext.h"
@@ -42,9 +44,12 @@
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderService.h"
 #include "Renderer/RenderUtils.h"
+#include "Renderer/TextAnchor.h"
 #include "View/Selection.h"
 #include "View/MapDocument.h"
 
+#include <iomanip>
+
 namespace TrenchBroom {
     namespace Renderer {
         class MapRenderer::SelectedBrushRendererFilter : public BrushRenderer::DefaultFilter {
@@ -142,7 +147,7 @@ namespace TrenchBroom {
             m_defaultRenderer->clear();
             m_selectionRenderer->clear();
             m_lockedRenderer->clear();
-            m_entityLinkRenderer->invalidate();
+            m_entityLinkRenderer->invalidateLinks();
         }
         
         void MapRenderer::overrideSelectionColors(const Color& color, const float mix) {
@@ -160,14 +165,35 @@ namespace TrenchBroom {
             setupSelectionRenderer(m_selectionRenderer);
         }
         
+        class MapRenderer::VisibleObjects {
+        public:
+            Model::GroupList groups;
+            Model::EntityList entities;
+            Model::BrushList brushes;
+            
+            VisibleObjects(const Model::NodeList& nodes) {
+                Model::CollectObjectsVisitor visitor;
+                Model::Node::accept(nodes.begin(), nodes.end(), visitor);
+                groups = visitor.groups();
+                entities = visitor.entities();
+                brushes = visitor.brushes();
+            }
+        };
+        
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             commitPendingChanges();
             setupGL(renderBatch);
-            renderDefault(renderContext, renderBatch);
-            renderLocked(renderContext, renderBatch);
-            renderSelection(renderContext, renderBatch);
+            
+            // only the objects which intersect the camera frustum are submitted for rendering
+            View::MapDocumentSPtr document = lock(m_document);
+            const VisibleObjects visibleObjects(document->findNodesInFrustum(frustumPlanes(renderContext)));
+            
+            renderDefault(renderContext, renderBatch, visibleObjects);
+            renderLocked(renderContext, renderBatch, visibleObjects);
+            renderSelection(renderContext, renderBatch, visibleObjects);
             renderEntityLinks(renderContext, renderBatch);
             renderTutorialMessages(renderContext, renderBatch);
+            renderFrameStats(renderContext, renderBatch);
         }
         
         void MapRenderer::commitPendingChanges() {
@@ -190,19 +216,31 @@ namespace TrenchBroom {
             renderBatch.addOneShot(new SetupGL());
         }
         
-        void MapRenderer::renderDefault(RenderContext& renderContext, RenderBatch& renderBatch) {
+        Plane3::List MapRenderer::frustumPlanes(const RenderContext& renderContext) const {
+            const Camera& camera = renderContext.camera();
+            
+            Plane3f planes[4];
+            camera.frustumPlanes(planes[0], planes[1], planes[2], planes[3]);
+            
+            Plane3::List result(planes, planes + 4);
+            if (renderContext.render3D())
+                result.push_back(Plane3(camera.position() + camera.farPlane() * camera.direction(), camera.direction()));
+            return result;
+        }
+        
+        void MapRenderer::renderDefault(RenderContext& renderContext, RenderBatch& renderBatch, const VisibleObjects& visibleObjects) {
             m_defaultRenderer->setShowOverlays(renderContext.render3D());
-            m_defaultRenderer->render(renderContext, renderBatch);
+            m_defaultRenderer->render(renderContext, renderBatch, visibleObjects.groups, visibleObjects.entities, visibleObjects.brushes);
         }
         
-        void MapRenderer::renderSelection(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void MapRenderer::renderSelection(RenderContext& renderContext, RenderBatch& renderBatch, const VisibleObjects& visibleObjects) {
             if (!renderContext.hideSelection())
-                m_selectionRenderer->render(renderContext, renderBatch);
+                m_selectionRenderer->render(renderContext, renderBatch, visibleObjects.groups, visibleObjects.entities, visibleObjects.brushes);
         }
         
-        void MapRenderer::renderLocked(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void MapRenderer::renderLocked(RenderContext& renderContext, RenderBatch& renderBatch, const VisibleObjects& visibleObjects) {
             m_lockedRenderer->setShowOverlays(renderContext.render3D());
-            m_lockedRenderer->render(renderContext, renderBatch);
+            m_lockedRenderer->render(renderContext, renderBatch, visibleObjects.groups, visibleObjects.entities, visibleObjects.brushes);
         }
         
         void MapRenderer::renderEntityLinks(RenderContext& renderContext, RenderBatch& renderBatch) {
@@ -260,6 +298,55 @@ namespace TrenchBroom {
             }
         }
 
+        class MapRenderer::FrameStatsAnchor : public TextAnchor {
+        private:
+            Vec3f offset(const Camera& camera, const Vec2f& size) const {
+                return getOffset(camera);
+            }
+            
+            Vec3f position(const Camera& camera) const {
+                return camera.unproject(getOffset(camera));
+            }
+            
+            Vec3f getOffset(const Camera& camera) const {
+                return Vec3f(10.0f, 10.0f, 0.0f);
+            }
+        };
+        
+        void MapRenderer::renderFrameStats(RenderContext& renderContext, RenderBatch& renderBatch) {
+            if (!pref(Preferences::ShowFrameStats))
+                return;
+            
+            size_t brushCount = m_defaultRenderer->brushCount() + m_lockedRenderer->brushCount();
+            size_t renderedBrushCount = m_defaultRenderer->renderedBrushCount() + m_lockedRenderer->renderedBrushCount();
+            size_t entityCount = m_defaultRenderer->entityCount() + m_lockedRenderer->entityCount();
+            size_t renderedEntityCount = m_defaultRenderer->renderedEntityCount() + m_lockedRenderer->renderedEntityCount();
+            if (!renderContext.hideSelection()) {
+                brushCount += m_selectionRenderer->brushCount();
+                renderedBrushCount += m_selectionRenderer->renderedBrushCount();
+                entityCount += m_selectionRenderer->entityCount();
+                renderedEntityCount += m_selectionRenderer->renderedEntityCount();
+            }
+            
+            StringStream brushStats;
+            brushStats << "Brushes: " << renderedBrushCount << " submitted, " << brushCount - renderedBrushCount << " culled";
+            StringStream entityStats;
+            entityStats << "Entities: " << renderedEntityCount << " submitted, " << entityCount - renderedEntityCount << " culled";
+            
+            StringStream overlayStats;
+            overlayStats << "Overlays: " << std::fixed << std::setprecision(2) << renderContext.lastOverlayTime() << " ms";
+            
+            AttrString stats;
+            stats.appendLeftJustified(brushStats.str());
+            stats.appendLeftJustified(entityStats.str());
+            stats.appendLeftJustified(overlayStats.str());
+            
+            RenderService renderService(renderContext, renderBatch);
+            renderService.setForegroundColor(pref(Preferences::InfoOverlayTextColor));
+            renderService.setBackgroundColor(pref(Preferences::InfoOverlayBackgroundColor));
+            renderService.renderString(stats, FrameStatsAnchor());
+        }
+
         void MapRenderer::setupRenderers() {
             setupDefaultRenderer(m_defaultRenderer);
             setupSelectionRenderer(m_selectionRenderer);
@@ -400,7 +487,9 @@ namespace TrenchBroom {
                                              collect.lockedNodes().entities(),
                                              collect.lockedNodes().brushes());
             }
-            invalidateEntityLinkRenderer();
+            
+            // the selection or visibility of the nodes may have changed, which only affects how the links are drawn
+            m_entityLinkRenderer->invalidate();
         }
         
         void MapRenderer::invalidateRenderers(Renderer renderers) {
@@ -412,8 +501,20 @@ namespace TrenchBroom {
                 m_lockedRenderer->invalidate();
         }
 
+        void MapRenderer::invalidateBrushes(const Model::BrushList& brushes) {
+            m_defaultRenderer->invalidateBrushes(brushes);
+            m_selectionRenderer->invalidateBrushes(brushes);
+            m_lockedRenderer->invalidateBrushes(brushes);
+        }
+
+        void MapRenderer::invalidateEntityRenderers() {
+            m_defaultRenderer->invalidateEntities();
+            m_selectionRenderer->invalidateEntities();
+            m_lockedRenderer->invalidateEntities();
+        }
+        
         void MapRenderer::invalidateEntityLinkRenderer() {
-            m_entityLinkRenderer->invalidate();
+            m_entityLinkRenderer->invalidateLinks();
         }
 
         void MapRenderer::reloadEntityModels() {
@@ -439,6 +540,7 @@ namespace TrenchBroom {
             document->selectionDidChangeNotifier.addObserver(this, &MapRenderer::selectionDidChange);
             document->textureCollectionsDidChangeNotifier.addObserver(this, &MapRenderer::textureCollectionsDidChange);
             document->entityDefinitionsDidChangeNotifier.addObserver(this, &MapRenderer::entityDefinitionsDidChange);
+            document->entityModelsDidChangeNotifier.addObserver(this, &MapRenderer::entityModelsDidChange);
             document->modsDidChangeNotifier.addObserver(this, &MapRenderer::modsDidChange);
             document->editorContextDidChangeNotifier.addObserver(this, &MapRenderer::editorContextDidChange);
             document->mapViewConfigDidChangeNotifier.addObserver(this, &MapRenderer::mapViewConfigDidChange);
@@ -464,6 +566,7 @@ namespace TrenchBroom {
                 document->selectionDidChangeNotifier.removeObserver(this, &MapRenderer::selectionDidChange);
                 document->textureCollectionsDidChangeNotifier.removeObserver(this, &MapRenderer::textureCollectionsDidChange);
                 document->entityDefinitionsDidChangeNotifier.removeObserver(this, &MapRenderer::entityDefinitionsDidChange);
+                document->entityModelsDidChangeNotifier.removeObserver(this, &MapRenderer::entityModelsDidChange);
                 document->modsDidChangeNotifier.removeObserver(this, &MapRenderer::modsDidChange);
                 document->editorContextDidChangeNotifier.removeObserver(this, &MapRenderer::editorContextDidChange);
                 document->mapViewConfigDidChangeNotifier.removeObserver(this, &MapRenderer::mapViewConfigDidChange);
@@ -484,42 +587,60 @@ namespace TrenchBroom {
         
         void MapRenderer::nodesWereAdded(const Model::NodeList& nodes) {
             updateRenderers(Renderer_Default);
+            invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::nodesWereRemoved(const Model::NodeList& nodes) {
             updateRenderers(Renderer_Default);
+            invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::nodesDidChange(const Model::NodeList& nodes) {
             invalidateRenderers(Renderer_Selection);
+            invalidateBrushes(collectBrushes(nodes));
             invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::nodeVisibilityDidChange(const Model::NodeList& nodes) {
             updateRenderers(Renderer_All);
+            invalidateRenderers(Renderer_All);
         }
         
         void MapRenderer::nodeLockingDidChange(const Model::NodeList& nodes) {
             updateRenderers(Renderer_Default_Locked);
+            invalidateRenderers(Renderer_Default_Locked);
         }
         
         void MapRenderer::groupWasOpened(Model::Group* group) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateRenderers(Renderer_Default_Selection);
         }
         
         void MapRenderer::groupWasClosed(Model::Group* group) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateRenderers(Renderer_Default_Selection);
         }
 
         void MapRenderer::brushFacesDidChange(const Model::BrushFaceList& faces) {
             invalidateRenderers(Renderer_Selection);
+            invalidateBrushes(collectBrushes(faces));
         }
         
         void MapRenderer::selectionDidChange(const View::Selection& selection) {
             updateRenderers(Renderer_All); // need to update locked objects also because a selected object may have been reparented into a locked layer before deselection
+            
+            // brushes that stay in a renderer keep their vertices, but the filters show or hide faces by their selection state
+            invalidateBrushes(collectBrushes(selection.selectedBrushFaces()));
+            invalidateBrushes(collectBrushes(selection.deselectedBrushFaces()));
         }
         
-        Model::BrushSet MapRenderer::collectBrushes(const Model::BrushFaceList& faces) {
+        Model::BrushList MapRenderer::collectBrushes(const Model::NodeList& nodes) {
+            Model::CollectBrushesVisitor collect;
+            Model::Node::accept(nodes.begin(), nodes.end(), collect);
+            return collect.brushes();
+        }
+        
+        Model::BrushList MapRenderer::collectBrushes(const Model::BrushFaceList& faces) {
             Model::BrushSet result;
             Model::BrushFaceList::const_iterator it, end;
             for (it = faces.begin(), end = faces.end(); it != end; ++it) {
@@ -527,7 +648,7 @@ namespace TrenchBroom {
                 Model::Brush* brush = face->brush();
                 result.insert(brush);
             }
-            return result;
+            return Model::BrushList(result.begin(), result.end());
         }
         
         void MapRenderer::textureCollectionsDidChange() {
@@ -540,6 +661,11 @@ namespace TrenchBroom {
             invalidateEntityLinkRenderer();
         }
         
+        void MapRenderer::entityModelsDidChange() {
+            reloadEntityModels();
+            invalidateEntityRenderers();
+        }
+        
         void MapRenderer::modsDidChange() {
             reloadEntityModels();
             invalidateRenderers(Renderer_All);
@@ -47,6 +47,7 @@ namespace TrenchBroom {
             class SelectedBrushRendererFilter;
             class LockedBrushRendererFilter;
             class UnselectedBrushRendererFilter;
+            class VisibleObjects;
             
             typedef std::map<Model::Layer*, ObjectRenderer*> RendererMap;
             
@@ -72,11 +73,15 @@ namespace TrenchBroom {
         private:
             void commitPendingChanges();
             void setupGL(RenderBatch& renderBatch);
-            void renderDefault(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderSelection(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderLocked(RenderContext& renderContext, RenderBatch& renderBatch);
+            Plane3::List frustumPlanes(const RenderContext& renderContext) const;
+            void renderDefault(RenderContext& renderContext, RenderBatch& renderBatch, const VisibleObjects& visibleObjects);
+            void renderSelection(RenderContext& renderContext, RenderBatch& renderBatch, const VisibleObjects& visibleObjects);
+            void renderLocked(RenderContext& renderContext, RenderBatch& renderBatch, const VisibleObjects& visibleObjects);
             void renderEntityLinks(RenderContext& renderContext, RenderBatch& renderBatch);
             
+            class FrameStatsAnchor;
+            void renderFrameStats(RenderContext& renderContext, RenderBatch& renderBatch);
+            
             class MatchTutorialEntities;
             class FilterTutorialEntities;
             class CollectTutorialEntitiesVisitor;
@@ -101,6 +106,8 @@ namespace TrenchBroom {
             
             void updateRenderers(Renderer renderers);
             void invalidateRenderers(Renderer renderers);
+            void invalidateBrushes(const Model::BrushList& brushes);
+            void invalidateEntityRenderers();
             void invalidateEntityLinkRenderer();
             void reloadEntityModels();
         private: // notification
@@ -123,10 +130,12 @@ namespace TrenchBroom {
             void brushFacesDidChange(const Model::BrushFaceList& faces);
             
             void selectionDidChange(const View::Selection& selection);
-            Model::BrushSet collectBrushes(const Model::BrushFaceList& faces);
+            Model::BrushList collectBrushes(const Model::NodeList& nodes);
+            Model::BrushList collectBrushes(const Model::BrushFaceList& faces);
             
             void textureCollectionsDidChange();
             void entityDefinitionsDidChange();
+            void entityModelsDidChange();
             void modsDidChange();
             
             void editorContextDidChange();
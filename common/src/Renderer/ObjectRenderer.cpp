@@ -37,6 +37,14 @@ namespace TrenchBroom {
             m_brushRenderer.invalidate();
         }
 
+        void ObjectRenderer::invalidateBrushes(const Model::BrushList& brushes) {
+            m_brushRenderer.invalidateBrushes(brushes);
+        }
+
+        void ObjectRenderer::invalidateEntities() {
+            m_entityRenderer.invalidate();
+        }
+
         void ObjectRenderer::clear() {
             m_groupRenderer.clear();
             m_entityRenderer.clear();
@@ -132,5 +140,27 @@ namespace TrenchBroom {
             m_entityRenderer.render(renderContext, renderBatch);
             m_groupRenderer.render(renderContext, renderBatch);
         }
+        
+        void ObjectRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch, const Model::GroupList& visibleGroups, const Model::EntityList& visibleEntities, const Model::BrushList& visibleBrushes) {
+            m_brushRenderer.render(renderContext, renderBatch, visibleBrushes);
+            m_entityRenderer.render(renderContext, renderBatch, visibleEntities);
+            m_groupRenderer.render(renderContext, renderBatch, visibleGroups);
+        }
+        
+        size_t ObjectRenderer::entityCount() const {
+            return m_entityRenderer.entityCount();
+        }
+        
+        size_t ObjectRenderer::renderedEntityCount() const {
+            return m_entityRenderer.renderedEntityCount();
+        }
+        
+        size_t ObjectRenderer::brushCount() const {
+            return m_brushRenderer.brushCount();
+        }
+        
+        size_t ObjectRenderer::renderedBrushCount() const {
+            return m_brushRenderer.renderedBrushCount();
+        }
     }
 }
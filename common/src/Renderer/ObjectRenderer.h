@@ -49,6 +49,8 @@ namespace TrenchBroom {
         public: // object management
             void setObjects(const Model::GroupList& groups, const Model::EntityList& entities, const Model::BrushList& brushes);
             void invalidate();
+            void invalidateBrushes(const Model::BrushList& brushes);
+            void invalidateEntities();
             void clear();
             void reloadModels();
         public: // configuration
@@ -79,6 +81,13 @@ namespace TrenchBroom {
             void setShowHiddenObjects(bool showHiddenObjects);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
+            // renders only those of the given objects which belong to this renderer
+            void render(RenderContext& renderContext, RenderBatch& renderBatch, const Model::GroupList& visibleGroups, const Model::EntityList& visibleEntities, const Model::BrushList& visibleBrushes);
+        public: // statistics of the last rendered frame
+            size_t entityCount() const;
+            size_t renderedEntityCount() const;
+            size_t brushCount() const;
+            size_t renderedBrushCount() const;
         private:
             ObjectRenderer(const ObjectRenderer&);
             ObjectRenderer& operator=(const ObjectRenderer&);
@@ -27,73 +27,69 @@
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Vbo.h"
-#include "Renderer/VertexSpec.h"
-
-#include <algorithm>
 
 namespace TrenchBroom {
     namespace Renderer {
         PointHandleRenderer::PointHandleRenderer() :
-        m_handle(pref(Preferences::HandleRadius), 16, true),
-        m_highlight(2.0f * pref(Preferences::HandleRadius), 16, false) {}
+        m_handle(circle2D(pref(Preferences::HandleRadius), 0.0f, Math::Cf::twoPi(), 16)),
+        m_highlight(circle2D(2.0f * pref(Preferences::HandleRadius), 0.0f, Math::Cf::twoPi(), 16)) {
+            m_stopWatch.Pause();
+        }
         
-        void PointHandleRenderer::addPoint(const Color& color, const Vec3f& position) {
-            m_pointHandles[color].push_back(position);
+        void PointHandleRenderer::addPoint(RenderContext& renderContext, const Color& color, const Vec3f& position) {
+            const ResumeStopWatch time(m_stopWatch);
+            const Vec3f center = renderContext.camera().project(position);
+            
+            // the rim has one more vertex than segments because it ends where it started, so each pair of
+            // consecutive rim vertices forms one segment
+            for (size_t i = 0; i < m_handle.size() - 1; ++i) {
+                m_handleVertices.push_back(Vertex(center, color));
+                m_handleVertices.push_back(Vertex(center + Vec3f(m_handle[i], 0.0f), color));
+                m_handleVertices.push_back(Vertex(center + Vec3f(m_handle[i + 1], 0.0f), color));
+            }
         }
 
-        void PointHandleRenderer::addHighlight(const Color& color, const Vec3f& position) {
-            m_highlights[color].push_back(position);
+        void PointHandleRenderer::addHighlight(RenderContext& renderContext, const Color& color, const Vec3f& position) {
+            const ResumeStopWatch time(m_stopWatch);
+            const Vec3f center = renderContext.camera().project(position);
+            
+            for (size_t i = 0; i < m_highlight.size() - 1; ++i) {
+                m_highlightVertices.push_back(Vertex(center + Vec3f(m_highlight[i], 0.0f), color));
+                m_highlightVertices.push_back(Vertex(center + Vec3f(m_highlight[i + 1], 0.0f), color));
+            }
         }
         
         void PointHandleRenderer::doPrepareVertices(Vbo& vertexVbo) {
-            m_handle.prepare(vertexVbo);
-            m_highlight.prepare(vertexVbo);
+            const ResumeStopWatch time(m_stopWatch);
+            m_handleArray = VertexArray::swap(m_handleVertices);
+            m_highlightArray = VertexArray::swap(m_highlightVertices);
+            
+            m_handleArray.prepare(vertexVbo);
+            m_highlightArray.prepare(vertexVbo);
         }
         
         void PointHandleRenderer::doRender(RenderContext& renderContext) {
-            const Camera& camera = renderContext.camera();
-            const Camera::Viewport& viewport = camera.unzoomedViewport();
-            
-            const Mat4x4f projection = orthoMatrix(-1.0f, 1.0f,
-                                                   static_cast<float>(viewport.x),
-                                                   static_cast<float>(viewport.height),
-                                                   static_cast<float>(viewport.width),
-                                                   static_cast<float>(viewport.y));
-            const Mat4x4f view = viewMatrix(Vec3f::NegZ, Vec3f::PosY);
-            ReplaceTransformation ortho(renderContext.transformation(), projection, view);
-
-            glAssert(glDisable(GL_DEPTH_TEST));
-            renderHandles(renderContext, m_pointHandles, m_handle);
-            renderHandles(renderContext, m_highlights, m_highlight);
-            glAssert(glEnable(GL_DEPTH_TEST));
-            
-            clear();
-        }
-
-        void PointHandleRenderer::renderHandles(RenderContext& renderContext, const HandleMap& map, Circle& circle) {
-            const Camera& camera = renderContext.camera();
-            ActiveShader shader(renderContext.shaderManager(), Shaders::HandleShader);
-
-            HandleMap::const_iterator hIt, hEnd;
-            Vec3f::List::const_iterator pIt, pEnd;
-            
-            for (hIt = map.begin(), hEnd = map.end(); hIt != hEnd; ++hIt) {
-                const Color& color = hIt->first;
-                shader.set("Color", color);
+            {
+                const ResumeStopWatch time(m_stopWatch);
+                const Camera& camera = renderContext.camera();
+                const Camera::Viewport& viewport = camera.unzoomedViewport();
                 
-                const Vec3f::List& positions = hIt->second;
-                for (pIt = positions.begin(), pEnd = positions.end(); pIt != pEnd; ++pIt) {
-                    const Vec3f& position = *pIt;
-                    const Vec3f offset = camera.project(position);
-                    MultiplyModelMatrix translate(renderContext.transformation(), translationMatrix(offset));
-                    circle.render();
-                }
+                const Mat4x4f projection = orthoMatrix(-1.0f, 1.0f,
+                                                       static_cast<float>(viewport.x),
+                                                       static_cast<float>(viewport.height),
+                                                       static_cast<float>(viewport.width),
+                                                       static_cast<float>(viewport.y));
+                const Mat4x4f view = viewMatrix(Vec3f::NegZ, Vec3f::PosY);
+                ReplaceTransformation ortho(renderContext.transformation(), projection, view);
+                
+                glAssert(glDisable(GL_DEPTH_TEST));
+                ActiveShader shader(renderContext.shaderManager(), Shaders::ColoredHandleShader);
+                m_handleArray.render(GL_TRIANGLES);
+                m_highlightArray.render(GL_LINES);
+                glAssert(glEnable(GL_DEPTH_TEST));
             }
-        }
-
-        void PointHandleRenderer::clear() {
-            m_pointHandles.clear();
-            m_highlights.clear();
+            
+            renderContext.addOverlayTime(m_stopWatch.TimeInMicro().ToDouble() / 1000.0);
         }
     }
 }
@@ -23,37 +23,40 @@
 #include "TrenchBroom.h"
 #include "VecMath.h"
 #include "Color.h"
-#include "Renderer/Circle.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/VertexArray.h"
+#include "Renderer/VertexSpec.h"
 
-#include <map>
+#include <wx/stopwatch.h>
 
 namespace TrenchBroom {
     namespace Renderer {
-        class ActiveShader;
         class RenderContext;
         class Vbo;
         
+        // Projects all handles into screen space as they are added, so that the filled handles and the highlights
+        // can each be rendered with a single draw call.
         class PointHandleRenderer : public DirectRenderable {
         private:
-            typedef std::map<Color, Vec3f::List> HandleMap;
+            typedef VertexSpecs::P3C4::Vertex Vertex;
             
-            HandleMap m_pointHandles;
-            HandleMap m_highlights;
-
-            Circle m_handle;
-            Circle m_highlight;
+            Vec2f::List m_handle;
+            Vec2f::List m_highlight;
+            
+            Vertex::List m_handleVertices;
+            Vertex::List m_highlightVertices;
+            VertexArray m_handleArray;
+            VertexArray m_highlightArray;
+            
+            wxStopWatch m_stopWatch;
         public:
             PointHandleRenderer();
             
-            void addPoint(const Color& color, const Vec3f& position);
-            void addHighlight(const Color& color, const Vec3f& position);
+            void addPoint(RenderContext& renderContext, const Color& color, const Vec3f& position);
+            void addHighlight(RenderContext& renderContext, const Color& color, const Vec3f& position);
         private:
             void doPrepareVertices(Vbo& vertexVbo);
             void doRender(RenderContext& renderContext);
-            void renderHandles(RenderContext& renderContext, const HandleMap& map, Circle& circle);
-            
-            void clear();
         };
     }
 }
@@ -42,7 +42,9 @@ namespace TrenchBroom {
         m_gridSize(4),
         m_hideSelection(false),
         m_tintSelection(true),
-        m_showSelectionGuide(ShowSelectionGuide_Hide) {}
+        m_showSelectionGuide(ShowSelectionGuide_Hide),
+        m_overlayTime(0.0),
+        m_lastOverlayTime(0.0) {}
         
         bool RenderContext::render2D() const {
             return m_renderMode == RenderMode_2D;
@@ -192,6 +194,22 @@ namespace TrenchBroom {
             setShowSelectionGuide(ShowSelectionGuide_ForceHide);
         }
         
+        double RenderContext::overlayTime() const {
+            return m_overlayTime;
+        }
+        
+        void RenderContext::addOverlayTime(const double overlayTime) {
+            m_overlayTime += overlayTime;
+        }
+        
+        double RenderContext::lastOverlayTime() const {
+            return m_lastOverlayTime;
+        }
+        
+        void RenderContext::setLastOverlayTime(const double lastOverlayTime) {
+            m_lastOverlayTime = lastOverlayTime;
+        }
+        
         void RenderContext::setShowSelectionGuide(const ShowSelectionGuide showSelectionGuide) {
             switch (showSelectionGuide) {
                 case ShowSelectionGuide_Show:
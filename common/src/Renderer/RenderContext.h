@@ -75,6 +75,10 @@ namespace TrenchBroom {
             bool m_tintSelection;
             
             ShowSelectionGuide m_showSelectionGuide;
+            
+            // time in milliseconds spent on the text and handle overlays in this frame and the previous one
+            double m_overlayTime;
+            double m_lastOverlayTime;
         public:
             RenderContext(RenderMode renderMode, const Camera& camera, FontManager& fontManager, ShaderManager& shaderManager);
 
@@ -130,6 +134,11 @@ namespace TrenchBroom {
             void setHideSelectionGuide();
             void setForceShowSelectionGuide();
             void setForceHideSelectionGuide();
+            
+            double overlayTime() const;
+            void addOverlayTime(double overlayTime);
+            double lastOverlayTime() const;
+            void setLastOverlayTime(double lastOverlayTime);
         private:
             void setShowSelectionGuide(ShowSelectionGuide showSelectionGuide);
         };
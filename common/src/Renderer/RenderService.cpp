@@ -116,11 +116,11 @@ namespace TrenchBroom {
         }
         
         void RenderService::renderPointHandle(const Vec3f& position) {
-            m_pointHandleRenderer->addPoint(m_foregroundColor, position);
+            m_pointHandleRenderer->addPoint(m_renderContext, m_foregroundColor, position);
         }
 
         void RenderService::renderPointHandleHighlight(const Vec3f& position) {
-            m_pointHandleRenderer->addHighlight(m_foregroundColor, position);
+            m_pointHandleRenderer->addHighlight(m_renderContext, m_foregroundColor, position);
         }
 
         void RenderService::renderLine(const Vec3f& start, const Vec3f& end) {
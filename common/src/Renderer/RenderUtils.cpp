@@ -66,6 +66,15 @@ namespace TrenchBroom {
                 texture->deactivate();
         }
 
+        ResumeStopWatch::ResumeStopWatch(wxStopWatch& stopWatch) :
+        m_stopWatch(stopWatch) {
+            m_stopWatch.Resume();
+        }
+        
+        ResumeStopWatch::~ResumeStopWatch() {
+            m_stopWatch.Pause();
+        }
+        
         Vec2f::List circle2D(const float radius, const size_t segments) {
             Vec2f::List vertices = circle2D(radius, 0.0f, Math::Cf::twoPi(), segments);
             vertices.push_back(Vec2f::Null);
@@ -27,6 +27,8 @@
 
 #include <utility>
 
+#include <wx/stopwatch.h>
+
 namespace TrenchBroom {
     namespace Assets {
         class Texture;
@@ -55,6 +57,15 @@ namespace TrenchBroom {
             void after(const Assets::Texture* texture);
         };
 
+        // resumes the given paused stop watch for the lifetime of this object
+        class ResumeStopWatch {
+        private:
+            wxStopWatch& m_stopWatch;
+        public:
+            ResumeStopWatch(wxStopWatch& stopWatch);
+            ~ResumeStopWatch();
+        };
+        
         Vec2f::List circle2D(float radius, size_t segments);
         Vec2f::List circle2D(float radius, float startAngle, float angleLength, size_t segments);
         Vec3f::List circle2D(float radius, Math::Axis::Type axis, float startAngle, float angleLength, size_t segments);
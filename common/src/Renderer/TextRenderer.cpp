@@ -55,7 +55,9 @@ namespace TrenchBroom {
         m_fontDescriptor(fontDescriptor),
         m_maxViewDistance(maxViewDistance),
         m_minZoomFactor(minZoomFactor),
-        m_inset(inset) {}
+        m_inset(inset) {
+            m_stopWatch.Pause();
+        }
 
         void TextRenderer::renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position) {
             renderString(renderContext, textColor, backgroundColor, string, position, false);
@@ -72,15 +74,18 @@ namespace TrenchBroom {
             if (distance <= 0.0f)
                 return;
             
-            if (!isVisible(renderContext, string, position, distance, onTop))
-                return;
+            const ResumeStopWatch time(m_stopWatch);
             
             FontManager& fontManager = renderContext.fontManager();
             TextureFont& font = fontManager.font(m_fontDescriptor);
-
-            Vec2f::List vertices = font.quads(string, true);
+            const TextureFont::Layout& layout = font.layout(string);
+            
+            if (!isVisible(renderContext, layout.size.rounded(), position, distance, onTop))
+                return;
+            
+            Vec2f::List vertices = layout.vertices;
             const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-            const Vec2f size = font.measure(string);
+            const Vec2f& size = layout.size;
             const Vec3f offset = position.offset(camera, size);
             
             if (onTop)
@@ -93,7 +98,7 @@ namespace TrenchBroom {
                                           Color(backgroundColor, alphaFactor * backgroundColor.a())));
         }
 
-        bool TextRenderer::isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, const float distance, const bool onTop) const {
+        bool TextRenderer::isVisible(RenderContext& renderContext, const Vec2f& size, const TextAnchor& position, const float distance, const bool onTop) const {
             if (!onTop) {
                 if (renderContext.render3D() && distance > m_maxViewDistance)
                     return false;
@@ -104,7 +109,6 @@ namespace TrenchBroom {
             const Camera& camera = renderContext.camera();
             const Camera::Viewport& viewport = camera.unzoomedViewport();
             
-            const Vec2f size = stringSize(renderContext, string);
             const Vec2f offset = Vec2f(position.offset(camera, size)) - m_inset;
             const Vec2f actualSize = size + 2.0f * m_inset;
             
@@ -135,13 +139,8 @@ namespace TrenchBroom {
             collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
         }
         
-        Vec2f TextRenderer::stringSize(RenderContext& renderContext, const AttrString& string) const {
-            FontManager& fontManager = renderContext.fontManager();
-            TextureFont& font = fontManager.font(m_fontDescriptor);
-            return font.measure(string).rounded();
-        }
-
         void TextRenderer::doPrepareVertices(Vbo& vertexVbo) {
+            const ResumeStopWatch time(m_stopWatch);
             prepare(m_entries, false, vertexVbo);
             prepare(m_entriesOnTop, true, vertexVbo);
         }
@@ -196,13 +195,18 @@ namespace TrenchBroom {
                                                    static_cast<float>(viewport.width),
                                                    static_cast<float>(viewport.y));
             const Mat4x4f view = viewMatrix(Vec3f::NegZ, Vec3f::PosY);
-            ReplaceTransformation ortho(renderContext.transformation(), projection, view);
-            
-            render(m_entries, renderContext);
+            {
+                const ResumeStopWatch time(m_stopWatch);
+                ReplaceTransformation ortho(renderContext.transformation(), projection, view);
+                
+                render(m_entries, renderContext);
+                
+                glAssert(glDisable(GL_DEPTH_TEST));
+                render(m_entriesOnTop, renderContext);
+                glAssert(glEnable(GL_DEPTH_TEST));
+            }
             
-            glAssert(glDisable(GL_DEPTH_TEST));
-            render(m_entriesOnTop, renderContext);
-            glAssert(glEnable(GL_DEPTH_TEST));
+            renderContext.addOverlayTime(m_stopWatch.TimeInMicro().ToDouble() / 1000.0);
         }
 
         void TextRenderer::render(EntryCollection& collection, RenderContext& renderContext) {
@@ -30,6 +30,8 @@
 #include <map>
 #include <vector>
 
+#include <wx/stopwatch.h>
+
 namespace TrenchBroom {
     class AttrString;
     
@@ -78,6 +80,9 @@ namespace TrenchBroom {
             
             EntryCollection m_entries;
             EntryCollection m_entriesOnTop;
+            
+            // accumulates the time spent on laying out, preparing and rendering the strings
+            wxStopWatch m_stopWatch;
         public:
             TextRenderer(const FontDescriptor& fontDescriptor, float maxViewDistance = DefaultMaxViewDistance, float minZoomFactor = DefaultMinZoomFactor, const Vec2f& inset = DefaultInset);
             
@@ -86,11 +91,10 @@ namespace TrenchBroom {
         private:
             void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, bool onTop);
             
-            bool isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, float distance, bool onTop) const;
+            bool isVisible(RenderContext& renderContext, const Vec2f& size, const TextAnchor& position, float distance, bool onTop) const;
             float computeAlphaFactor(const RenderContext& renderContext, float distance, bool onTop) const;
             void addEntry(EntryCollection& collection, const Entry& entry);
             
-            Vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
         private:
             void doPrepareVertices(Vbo& vertexVbo);
             void prepare(EntryCollection& collection, bool onTop, Vbo& vbo);
@@ -23,6 +23,8 @@
 
 namespace TrenchBroom {
     namespace Renderer {
+        const size_t TextureFont::MaxCachedLayouts = 4096;
+        
         TextureFont::TextureFont(FontTexture* texture, const FontGlyph::List& glyphs, const size_t lineHeight, const unsigned char firstChar, const unsigned char charCount) :
         m_texture(texture),
         m_glyphs(glyphs),
@@ -165,6 +167,21 @@ namespace TrenchBroom {
             string.lines(measureString);
             return measureString.size();
         }
+        
+        const TextureFont::Layout& TextureFont::layout(const AttrString& string) {
+            LayoutCache::iterator it = m_layoutCache.find(string);
+            if (it != m_layoutCache.end())
+                return it->second;
+            
+            // strings such as coordinates change constantly, so the cache is flushed instead of growing unbounded
+            if (m_layoutCache.size() >= MaxCachedLayouts)
+                m_layoutCache.clear();
+            
+            Layout& layout = m_layoutCache[string];
+            layout.vertices = quads(string, true);
+            layout.size = measure(string);
+            return layout;
+        }
 
         Vec2f::List TextureFont::quads(const String& string, const bool clockwise, const Vec2f& offset) {
             Vec2f::List result;
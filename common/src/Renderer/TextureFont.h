@@ -26,6 +26,7 @@
 #include "Renderer/FontGlyph.h"
 #include "Renderer/FontGlyphBuilder.h"
 
+#include <map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -34,19 +35,32 @@ namespace TrenchBroom {
         
         class TextureFont {
         public:
+            struct Layout {
+                Vec2f::List vertices;
+                Vec2f size;
+            };
         private:
+            typedef std::map<AttrString, Layout> LayoutCache;
+            static const size_t MaxCachedLayouts;
+            
             FontTexture* m_texture;
             FontGlyph::List m_glyphs;
             size_t m_lineHeight;
             
             unsigned char m_firstChar;
             unsigned char m_charCount;
+            
+            LayoutCache m_layoutCache;
         public:
             TextureFont(FontTexture* texture, const FontGlyph::List& glyphs, size_t lineHeight, unsigned char firstChar, unsigned char charCount);
             ~TextureFont();
             
             Vec2f::List quads(const AttrString& string, bool clockwise, const Vec2f& offset = Vec2f::Null);
             Vec2f measure(const AttrString& string);
+            
+            // Returns the clockwise quads and the size of the given string. The layout is cached by the string's
+            // contents, and the returned reference is only valid until the next call.
+            const Layout& layout(const AttrString& string);
 
             Vec2f::List quads(const String& string, bool clockwise, const Vec2f& offset = Vec2f::Null);
             Vec2f measure(const String& string);
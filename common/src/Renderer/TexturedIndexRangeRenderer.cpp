@@ -35,6 +35,10 @@ namespace TrenchBroom {
             return m_vertexArray.empty();
         }
 
+        bool TexturedIndexRangeRenderer::prepared() const {
+            return m_vertexArray.prepared();
+        }
+
         void TexturedIndexRangeRenderer::prepare(Vbo& vbo) {
             m_vertexArray.prepare(vbo);
         }
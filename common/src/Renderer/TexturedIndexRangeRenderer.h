@@ -42,6 +42,7 @@ namespace TrenchBroom {
             TexturedIndexRangeRenderer(const VertexArray& vertexArray, const Assets::Texture* texture, const IndexRangeMap& indexRange);
 
             bool empty() const;
+            bool prepared() const;
             
             void prepare(Vbo& vbo);
             void render();
@@ -86,6 +86,11 @@ namespace TrenchBroom {
             }
 
             VboBlockList::iterator it = findFreeBlock(capacity);
+            if (it == m_freeBlocks.end() && m_freeCapacity >= capacity && m_freeBlocks.size() > 1) {
+                // there is enough free space, but it is fragmented
+                compact();
+                it = findFreeBlock(capacity);
+            }
             if (it == m_freeBlocks.end()) {
                 increaseCapacityToAccomodate(capacity);
                 it = findFreeBlock(capacity);
@@ -241,6 +246,60 @@ namespace TrenchBroom {
             }
         }
 
+        void Vbo::compact() {
+            assert(active());
+            assert(!partiallyMapped());
+            assert(!fullyMapped());
+            assert(checkBlockChain());
+            
+            // Move all used blocks to the front of the buffer, preserving their order, and merge all free
+            // blocks into a single block at the end. The block objects remain valid, only their offsets change.
+            unsigned char* buffer = map(GL_READ_WRITE);
+            
+            VboBlock* lastUsed = NULL;
+            size_t offset = 0;
+            
+            VboBlock* block = m_firstBlock;
+            while (block != NULL) {
+                VboBlock* next = block->next();
+                if (block->isFree()) {
+                    delete block;
+                } else {
+                    if (block->offset() != offset) {
+                        memmove(buffer + offset, buffer + block->offset(), block->capacity());
+                        block->m_offset = offset;
+                    }
+                    block->setPrevious(lastUsed);
+                    if (lastUsed != NULL)
+                        lastUsed->setNext(block);
+                    else
+                        m_firstBlock = block;
+                    lastUsed = block;
+                    offset += block->capacity();
+                }
+                block = next;
+            }
+            
+            unmap();
+            
+            m_freeBlocks.clear();
+            m_freeCapacity = 0;
+            
+            if (lastUsed == NULL) {
+                m_firstBlock = m_lastBlock = new VboBlock(*this, 0, m_totalCapacity, NULL, NULL);
+                insertFreeBlock(m_firstBlock);
+            } else {
+                lastUsed->setNext(NULL);
+                m_lastBlock = lastUsed;
+                if (offset < m_totalCapacity) {
+                    m_lastBlock = lastUsed->createSuccessor(m_totalCapacity - offset);
+                    insertFreeBlock(m_lastBlock);
+                }
+            }
+            
+            assert(checkBlockChain());
+        }
+
         Vbo::VboBlockList::iterator Vbo::findFreeBlock(const size_t minCapacity) {
             VboBlock query(*this, 0, minCapacity, NULL, NULL);
             return std::lower_bound(m_freeBlocks.begin(), m_freeBlocks.end(), &query, CompareVboBlocksByCapacity());
@@ -297,7 +356,7 @@ namespace TrenchBroom {
             return m_state == State_FullyMapped;
         }
         
-        unsigned char* Vbo::map() {
+        unsigned char* Vbo::map(const GLenum access) {
             assert(active());
             assert(!fullyMapped());
             assert(!partiallyMapped());
@@ -306,7 +365,7 @@ namespace TrenchBroom {
             // fixes a crash on Mac OS X where a buffer could not be mapped after another windows was closed
             glAssert(glFinishObjectAPPLE(GL_BUFFER_OBJECT_APPLE, static_cast<GLint>(m_vboId)));
 #endif
-            unsigned char* buffer = reinterpret_cast<unsigned char *>(glMapBuffer(m_type, GL_WRITE_ONLY));
+            unsigned char* buffer = reinterpret_cast<unsigned char *>(glMapBuffer(m_type, access));
             assert(buffer != NULL);
             m_state = State_FullyMapped;
             
@@ -124,6 +124,7 @@ namespace TrenchBroom {
              */
             void increaseCapacityToAccomodate(const size_t capacity);
             void increaseCapacity(size_t delta);
+            void compact();
             VboBlockList::iterator findFreeBlock(size_t minCapacity);
             void insertFreeBlock(VboBlock* block);
             void removeFreeBlock(VboBlock* block);
@@ -134,7 +135,7 @@ namespace TrenchBroom {
             void unmapPartially();
             
             bool fullyMapped() const;
-            unsigned char* map();
+            unsigned char* map(GLenum access = GL_WRITE_ONLY);
             void unmap();
 
             bool checkBlockChain() const;
@@ -79,6 +79,22 @@ namespace TrenchBroom {
                 return size;
             }
 
+            template <typename T>
+            size_t writeBuffer(const size_t address, const std::vector<T>& buffer, const size_t index, const size_t count) {
+                assert(mapped());
+                assert(index + count <= buffer.size());
+
+                const size_t size = count * sizeof(T);
+                assert(address + size <= m_capacity);
+
+                const GLvoid* ptr = static_cast<const GLvoid*>(&(buffer[index]));
+                const GLintptr offset = static_cast<GLintptr>(m_offset + address);
+                const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
+                glAssert(glBufferSubData(m_vbo.type(), offset, sizei, ptr));
+
+                return size;
+            }
+
             void free();
         private:
             bool mapped() const;
@@ -53,12 +53,17 @@ namespace TrenchBroom {
             return m_holder == NULL ? 0 : m_holder->vertexCount();
         }
 
+        void VertexArray::update(const size_t index, const size_t count) {
+            if (!empty())
+                m_holder->update(index, count);
+        }
+
         bool VertexArray::prepared() const {
             return m_prepared;
         }
 
         void VertexArray::prepare(Vbo& vbo) {
-            if (!prepared() && !empty())
+            if (!empty() && (!prepared() || m_holder->hasPendingUpdates()))
                 m_holder->prepare(vbo);
             m_prepared = true;
         }
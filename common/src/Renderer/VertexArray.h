@@ -28,6 +28,10 @@
 #include "Renderer/Vertex.h"
 #include "Renderer/VertexSpec.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Renderer {
         class VertexArray {
@@ -40,6 +44,9 @@ namespace TrenchBroom {
                 virtual size_t vertexCount() const = 0;
                 virtual size_t sizeInBytes() const = 0;
                 
+                virtual void update(size_t index, size_t count) = 0;
+                virtual bool hasPendingUpdates() const = 0;
+                
                 virtual void prepare(Vbo& vbo) = 0;
                 virtual void setup() = 0;
                 virtual void cleanup() = 0;
@@ -49,9 +56,12 @@ namespace TrenchBroom {
             class Holder : public BaseHolder {
             private:
                 typedef typename VertexSpec::Vertex::List VertexList;
+                typedef std::pair<size_t, size_t> Range;
+                typedef std::vector<Range> RangeList;
             private:
                 VboBlock* m_block;
                 size_t m_vertexCount;
+                RangeList m_pendingUpdates;
             public:
                 size_t vertexCount() const {
                     return m_vertexCount;
@@ -61,6 +71,16 @@ namespace TrenchBroom {
                     return VertexSpec::Size * m_vertexCount;
                 }
                 
+                void update(const size_t index, const size_t count) {
+                    assert(index + count <= m_vertexCount);
+                    if (m_block != NULL && count > 0)
+                        m_pendingUpdates.push_back(Range(index, count));
+                }
+                
+                bool hasPendingUpdates() const {
+                    return !m_pendingUpdates.empty();
+                }
+                
                 virtual void prepare(Vbo& vbo) {
                     if (m_vertexCount > 0 && m_block == NULL) {
                         ActivateVbo activate(vbo);
@@ -68,7 +88,10 @@ namespace TrenchBroom {
                         
                         MapVboBlock map(m_block);
                         m_block->writeBuffer(0, doGetVertices());
+                    } else if (!m_pendingUpdates.empty()) {
+                        writePendingUpdates(vbo);
                     }
+                    m_pendingUpdates.clear();
                 }
                 
                 virtual void setup() {
@@ -91,6 +114,29 @@ namespace TrenchBroom {
                     }
                 }
             private:
+                void writePendingUpdates(Vbo& vbo) {
+                    const VertexList& vertices = doGetVertices();
+                    assert(vertices.size() == m_vertexCount);
+                    
+                    std::sort(m_pendingUpdates.begin(), m_pendingUpdates.end());
+                    
+                    ActivateVbo activate(vbo);
+                    MapVboBlock map(m_block);
+                    
+                    typename RangeList::const_iterator it = m_pendingUpdates.begin();
+                    const typename RangeList::const_iterator end = m_pendingUpdates.end();
+                    while (it != end) {
+                        const size_t first = it->first;
+                        size_t last = it->first + it->second;
+                        
+                        // merge overlapping and adjacent ranges into a single write
+                        while (++it != end && it->first <= last)
+                            last = std::max(last, it->first + it->second);
+                        
+                        m_block->writeBuffer(VertexSpec::Size * first, vertices, first, last - first);
+                    }
+                }
+                
                 virtual const VertexList& doGetVertices() const = 0;
             };
             
@@ -258,6 +304,10 @@ namespace TrenchBroom {
             size_t sizeInBytes() const;
             size_t vertexCount() const;
             
+            // Marks the given range of vertices as changed so that only that range is written to the buffer
+            // when the array is prepared again. Only arrays that reference their vertices can be updated.
+            void update(size_t index, size_t count);
+            
             bool prepared() const;
             void prepare(Vbo& vbo);
             
@@ -20,10 +20,52 @@
 #include "StringUtils.h"
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <cstdarg>
 #include <cstdio>
 
 namespace StringUtils {
+    size_t formatFloat(char* buffer, const double value, const int precision) {
+        assert(precision > 0);
+        
+        // %g prints integral values below 10^precision without exponent and decimal point, we only handle values
+        // that fit into an unsigned long here
+        double limit = 1.0;
+        for (int i = 0; i < std::min(precision, 9); ++i)
+            limit *= 10.0;
+        
+        if (std::floor(value) == value && std::abs(value) < limit) {
+            // negative zero is printed as "-0"
+            const bool negative = value < 0.0 || (value == 0.0 && 1.0 / value < 0.0);
+            unsigned long integer = static_cast<unsigned long>(std::abs(value));
+            
+            char digits[16];
+            size_t count = 0;
+            do {
+                digits[count++] = static_cast<char>('0' + integer % 10);
+                integer /= 10;
+            } while (integer > 0);
+            
+            size_t length = 0;
+            if (negative)
+                buffer[length++] = '-';
+            while (count > 0)
+                buffer[length++] = digits[--count];
+            buffer[length] = 0;
+            return length;
+        }
+        
+        const int count =
+#if defined _MSC_VER
+        sprintf_s(buffer, FormatFloatBufferSize, "%.*g", precision, value);
+#else
+        std::sprintf(buffer, "%.*g", precision, value);
+#endif
+        assert(count > 0 && static_cast<size_t>(count) < FormatFloatBufferSize);
+        return static_cast<size_t>(count);
+    }
+    
     String formatString(const char* format, ...) {
         va_list(arguments);
         va_start(arguments, format);
@@ -131,6 +131,13 @@ namespace StringUtils {
         return str.erase(end + 1);
     }
     
+    // buffers passed to formatFloat must hold at least this many characters
+    const size_t FormatFloatBufferSize = 32;
+    
+    // Writes the value to the buffer exactly as printf("%.*g", precision, value) would, but formats integral values
+    // without going through printf. Returns the number of characters written, not counting the terminating zero.
+    size_t formatFloat(char* buffer, double value, int precision);
+    
     String formatString(const char* format, ...);
     String formatStringV(const char* format, va_list arguments);
     String trim(const String& str, const String& chars = " \n\t\r");
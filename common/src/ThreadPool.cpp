@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ThreadPool.h"
+
+#include "Allocator.h"
+
+#include <cassert>
+
+namespace TrenchBroom {
+    ThreadPool::Task::~Task() {}
+    
+    void ThreadPool::Task::run() {
+        doRun();
+    }
+
+    class ThreadPool::Worker : public wxThread {
+    private:
+        ThreadPool& m_pool;
+    public:
+        Worker(ThreadPool& pool) :
+        wxThread(wxTHREAD_JOINABLE),
+        m_pool(pool) {}
+    private:
+        ExitCode Entry() {
+            Task* task = m_pool.dequeue();
+            while (task != NULL) {
+                try {
+                    task->run();
+                } catch (...) {
+                    // tasks must handle their own errors, but an exception must never escape a worker thread
+                }
+                m_pool.taskDone();
+                task = m_pool.dequeue();
+            }
+            AllocatorCache::releaseThreadCaches();
+            return static_cast<ExitCode>(0);
+        }
+    };
+    
+    size_t ThreadPool::defaultThreadCount() {
+        const int count = wxThread::GetCPUCount();
+        return count > 1 ? static_cast<size_t>(count) : 1;
+    }
+
+    ThreadPool::ThreadPool(const size_t threadCount) :
+    m_taskAvailable(m_mutex),
+    m_tasksDone(m_mutex),
+    m_pendingTasks(0),
+    m_stopping(false) {
+        m_workers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            Worker* worker = new Worker(*this);
+            if (worker->Create() != wxTHREAD_NO_ERROR || worker->Run() != wxTHREAD_NO_ERROR) {
+                delete worker;
+                break;
+            }
+            m_workers.push_back(worker);
+        }
+    }
+    
+    ThreadPool::~ThreadPool() {
+        wait();
+        
+        {
+            wxMutexLocker lock(m_mutex);
+            m_stopping = true;
+            m_taskAvailable.Broadcast();
+        }
+        
+        WorkerList::const_iterator it, end;
+        for (it = m_workers.begin(), end = m_workers.end(); it != end; ++it) {
+            Worker* worker = *it;
+            worker->Wait();
+            delete worker;
+        }
+        m_workers.clear();
+    }
+
+    size_t ThreadPool::threadCount() const {
+        return m_workers.size();
+    }
+
+    void ThreadPool::enqueue(Task* task) {
+        assert(task != NULL);
+        if (m_workers.empty()) {
+            task->run();
+        } else {
+            wxMutexLocker lock(m_mutex);
+            m_queue.push_back(task);
+            ++m_pendingTasks;
+            m_taskAvailable.Signal();
+        }
+    }
+
+    void ThreadPool::enqueue(const TaskList& tasks) {
+        if (m_workers.empty()) {
+            TaskList::const_iterator it, end;
+            for (it = tasks.begin(), end = tasks.end(); it != end; ++it)
+                (*it)->run();
+        } else {
+            wxMutexLocker lock(m_mutex);
+            m_queue.insert(m_queue.end(), tasks.begin(), tasks.end());
+            m_pendingTasks += tasks.size();
+            m_taskAvailable.Broadcast();
+        }
+    }
+
+    void ThreadPool::wait() {
+        wxMutexLocker lock(m_mutex);
+        while (m_pendingTasks > 0)
+            m_tasksDone.Wait();
+    }
+
+    void ThreadPool::run(const TaskList& tasks) {
+        enqueue(tasks);
+        wait();
+    }
+
+    ThreadPool::Task* ThreadPool::dequeue() {
+        wxMutexLocker lock(m_mutex);
+        while (m_queue.empty() && !m_stopping)
+            m_taskAvailable.Wait();
+        if (m_queue.empty())
+            return NULL;
+        
+        Task* task = m_queue.front();
+        m_queue.pop_front();
+        return task;
+    }
+    
+    void ThreadPool::taskDone() {
+        wxMutexLocker lock(m_mutex);
+        assert(m_pendingTasks > 0);
+        if (--m_pendingTasks == 0)
+            m_tasksDone.Broadcast();
+    }
+}
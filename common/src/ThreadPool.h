@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_ThreadPool
+#define TrenchBroom_ThreadPool
+
+#include <deque>
+#include <vector>
+
+#include <wx/thread.h>
+
+namespace TrenchBroom {
+    class ThreadPool {
+    public:
+        class Task {
+        public:
+            virtual ~Task();
+            void run();
+        private:
+            virtual void doRun() = 0;
+        };
+        
+        typedef std::vector<Task*> TaskList;
+    private:
+        class Worker;
+        friend class Worker;
+        
+        typedef std::vector<Worker*> WorkerList;
+        typedef std::deque<Task*> TaskQueue;
+        
+        wxMutex m_mutex;
+        wxCondition m_taskAvailable;
+        wxCondition m_tasksDone;
+        
+        TaskQueue m_queue;
+        size_t m_pendingTasks;
+        bool m_stopping;
+        
+        WorkerList m_workers;
+    public:
+        static size_t defaultThreadCount();
+        
+        ThreadPool(size_t threadCount = defaultThreadCount());
+        ~ThreadPool();
+        
+        size_t threadCount() const;
+        
+        // The pool does not take ownership of the given tasks. If the pool has no worker threads, the tasks are
+        // executed immediately on the calling thread.
+        void enqueue(Task* task);
+        void enqueue(const TaskList& tasks);
+        void wait();
+        void run(const TaskList& tasks);
+    private:
+        Task* dequeue();
+        void taskDone();
+        
+        ThreadPool(const ThreadPool& other);
+        ThreadPool& operator=(const ThreadPool& other);
+    };
+}
+
+#endif /* defined(TrenchBroom_ThreadPool) */
@@ -21,6 +21,7 @@
 
 #include "CollectionUtils.h"
 #include "Macros.h"
+#include "Model/ComputeMemoryUsageVisitor.h"
 #include "Model/Node.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -109,5 +110,18 @@ namespace TrenchBroom {
         bool AddRemoveNodesCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t AddRemoveNodesCommand::doGetMemorySize() const {
+            // the nodes to add are owned by this command, the nodes to remove are owned by the document
+            Model::ComputeMemoryUsageVisitor visitor;
+            Model::ParentChildrenMap::const_iterator it, end;
+            for (it = m_nodesToAdd.begin(), end = m_nodesToAdd.end(); it != end; ++it) {
+                const Model::NodeList& children = it->second;
+                Model::Node::acceptAndRecurse(children.begin(), children.end(), visitor);
+            }
+            return (sizeof(AddRemoveNodesCommand) + m_name.capacity() +
+                    m_nodesToRemove.capacity() * sizeof(Model::Node*) +
+                    visitor.total().bytes);
+        }
     }
 }
@@ -71,5 +71,9 @@ namespace TrenchBroom {
             ChangeBrushFaceAttributesCommand* other = static_cast<ChangeBrushFaceAttributesCommand*>(command.get());
             return m_request.collateWith(other->m_request);
         }
+
+        size_t ChangeBrushFaceAttributesCommand::doGetMemorySize() const {
+            return sizeof(ChangeBrushFaceAttributesCommand) + m_name.capacity() + (m_snapshot != NULL ? m_snapshot->memorySize() : 0);
+        }
     }
 }
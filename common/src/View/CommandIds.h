@@ -94,6 +94,7 @@ namespace TrenchBroom {
                 const int DebugPrintVertices                 = Lowest + 127;
                 const int DebugCreateBrush                   = Lowest + 128;
                 const int DebugCopyJSShortcuts               = Lowest + 129;
+                const int DebugPrintMemoryUsage              = Lowest + 130;
                 
                 const int FileRecentDocuments                = Lowest + 190;
 
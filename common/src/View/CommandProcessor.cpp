@@ -26,6 +26,7 @@
 #include <wx/time.h>
 
 #include <algorithm>
+#include <numeric>
 
 namespace TrenchBroom {
     namespace View {
@@ -103,6 +104,17 @@ namespace TrenchBroom {
             return false;
         }
         
+        size_t CommandGroup::doGetMemorySize() const {
+            size_t result = sizeof(CommandGroup) + m_name.capacity();
+            CommandList::const_iterator it, end;
+            for (it = m_commands.begin(), end = m_commands.end(); it != end; ++it) {
+                UndoableCommand::Ptr command = *it;
+                result += command->memorySize();
+            }
+            return result;
+        }
+        
+        const size_t CommandProcessor::DefaultMemoryLimit = 512 * 1024 * 1024;
         const wxLongLong CommandProcessor::CollationInterval(1000);
         
         struct CommandProcessor::SubmitAndStoreResult {
@@ -116,9 +128,11 @@ namespace TrenchBroom {
         
         CommandProcessor::CommandProcessor(MapDocumentCommandFacade* document) :
         m_document(document),
+        m_memorySize(0),
         m_clearRepeatableCommandStack(false),
         m_lastCommandTimestamp(0),
-        m_groupLevel(0) {
+        m_groupLevel(0),
+        m_memoryLimit(DefaultMemoryLimit) {
             assert(m_document != NULL);
         }
         
@@ -166,8 +180,8 @@ namespace TrenchBroom {
             if (!success)
                 return false;
             
-            m_lastCommandStack.clear();
-            m_nextCommandStack.clear();
+            clearLastCommands();
+            clearNextCommands();
             return true;
         }
         
@@ -235,10 +249,23 @@ namespace TrenchBroom {
             assert(m_groupLevel == 0);
             
             clearRepeatableCommands();
-            m_lastCommandStack.clear();
-            m_nextCommandStack.clear();
+            clearLastCommands();
+            clearNextCommands();
             m_lastCommandTimestamp = 0;
         }
+        
+        size_t CommandProcessor::memorySize() const {
+            return m_memorySize;
+        }
+        
+        size_t CommandProcessor::memoryLimit() const {
+            return m_memoryLimit;
+        }
+        
+        void CommandProcessor::setMemoryLimit(const size_t memoryLimit) {
+            m_memoryLimit = memoryLimit;
+            evictOldestCommands();
+        }
 
         CommandProcessor::SubmitAndStoreResult CommandProcessor::submitAndStoreCommand(UndoableCommand::Ptr command, const bool collate) {
             SubmitAndStoreResult result;
@@ -248,7 +275,7 @@ namespace TrenchBroom {
             
             result.stored = storeCommand(command, collate);
             if (!m_nextCommandStack.empty())
-                m_nextCommandStack.clear();
+                clearNextCommands();
             return result;
         }
         
@@ -343,10 +370,21 @@ namespace TrenchBroom {
             
             if (collatable(collate, timestamp)) {
                 UndoableCommand::Ptr lastCommand = m_lastCommandStack.back();
-                if (lastCommand->collateWith(command))
+                if (lastCommand->collateWith(command)) {
+                    // the collated command may have grown
+                    const size_t size = lastCommand->memorySize();
+                    m_memorySize = m_memorySize - m_lastCommandSizes.back() + size;
+                    m_lastCommandSizes.back() = size;
+                    evictOldestCommands();
                     return false;
+                }
             }
+            
+            const size_t size = command->memorySize();
             m_lastCommandStack.push_back(command);
+            m_lastCommandSizes.push_back(size);
+            m_memorySize += size;
+            evictOldestCommands();
             return true;
         }
         
@@ -354,9 +392,25 @@ namespace TrenchBroom {
             return collate && !m_lastCommandStack.empty() && timestamp - m_lastCommandTimestamp <= CollationInterval;
         }
         
+        void CommandProcessor::evictOldestCommands() {
+            // the most recent command is always kept so that it can be undone
+            size_t count = 0;
+            while (m_memorySize > m_memoryLimit && m_lastCommandStack.size() - count > 1) {
+                m_memorySize -= m_lastCommandSizes[count];
+                ++count;
+            }
+            
+            typedef CommandStack::difference_type Diff;
+            m_lastCommandStack.erase(m_lastCommandStack.begin(), m_lastCommandStack.begin() + static_cast<Diff>(count));
+            m_lastCommandSizes.erase(m_lastCommandSizes.begin(), m_lastCommandSizes.begin() + static_cast<Diff>(count));
+        }
+        
         void CommandProcessor::pushNextCommand(UndoableCommand::Ptr command) {
             assert(m_groupLevel == 0);
+            const size_t size = command->memorySize();
             m_nextCommandStack.push_back(command);
+            m_nextCommandSizes.push_back(size);
+            m_memorySize += size;
         }
         
         void CommandProcessor::pushRepeatableCommand(UndoableCommand::Ptr command) {
@@ -377,6 +431,8 @@ namespace TrenchBroom {
                 throw CommandProcessorException("Command stack is empty");
             UndoableCommand::Ptr lastCommand = m_lastCommandStack.back();
             m_lastCommandStack.pop_back();
+            m_memorySize -= m_lastCommandSizes.back();
+            m_lastCommandSizes.pop_back();
             return lastCommand;
         }
         
@@ -386,9 +442,23 @@ namespace TrenchBroom {
                 throw CommandProcessorException("Command stack is empty");
             UndoableCommand::Ptr nextCommand = m_nextCommandStack.back();
             m_nextCommandStack.pop_back();
+            m_memorySize -= m_nextCommandSizes.back();
+            m_nextCommandSizes.pop_back();
             return nextCommand;
         }
         
+        void CommandProcessor::clearLastCommands() {
+            m_lastCommandStack.clear();
+            m_lastCommandSizes.clear();
+            m_memorySize = std::accumulate(m_nextCommandSizes.begin(), m_nextCommandSizes.end(), size_t(0));
+        }
+        
+        void CommandProcessor::clearNextCommands() {
+            m_nextCommandStack.clear();
+            m_nextCommandSizes.clear();
+            m_memorySize = std::accumulate(m_lastCommandSizes.begin(), m_lastCommandSizes.end(), size_t(0));
+        }
+        
         void CommandProcessor::popLastRepeatableCommand(UndoableCommand::Ptr command) {
             if (!m_repeatableCommandStack.empty() && m_repeatableCommandStack.back() == command)
                 m_repeatableCommandStack.pop_back();
@@ -62,9 +62,12 @@ namespace TrenchBroom {
             UndoableCommand::Ptr doRepeat(MapDocumentCommandFacade* document) const;
 
             bool doCollateWith(UndoableCommand::Ptr command);
+            size_t doGetMemorySize() const;
         };
         
         class CommandProcessor {
+        public:
+            static const size_t DefaultMemoryLimit;
         private:
             static const wxLongLong CollationInterval;
             
@@ -73,6 +76,13 @@ namespace TrenchBroom {
             typedef CommandList CommandStack;
             CommandStack m_lastCommandStack;
             CommandStack m_nextCommandStack;
+            
+            // the memory size of each stored command, computed when it is pushed
+            typedef std::vector<size_t> SizeStack;
+            SizeStack m_lastCommandSizes;
+            SizeStack m_nextCommandSizes;
+            size_t m_memorySize;
+            
             CommandStack m_repeatableCommandStack;
             bool m_clearRepeatableCommandStack;
             wxLongLong m_lastCommandTimestamp;
@@ -80,6 +90,8 @@ namespace TrenchBroom {
             String m_groupName;
             CommandStack m_groupedCommands;
             size_t m_groupLevel;
+            
+            size_t m_memoryLimit;
 
             struct SubmitAndStoreResult;
         public:
@@ -111,6 +123,10 @@ namespace TrenchBroom {
             void clearRepeatableCommands();
             
             void clear();
+            
+            size_t memorySize() const;
+            size_t memoryLimit() const;
+            void setMemoryLimit(size_t memoryLimit);
         private:
             SubmitAndStoreResult submitAndStoreCommand(UndoableCommand::Ptr command, bool collate);
             bool doCommand(Command::Ptr command);
@@ -125,6 +141,7 @@ namespace TrenchBroom {
 
             bool pushLastCommand(UndoableCommand::Ptr command, bool collate);
             bool collatable(bool collate, wxLongLong timestamp) const;
+            void evictOldestCommands();
             
             void pushNextCommand(UndoableCommand::Ptr command);
             void pushRepeatableCommand(UndoableCommand::Ptr command);
@@ -132,6 +149,8 @@ namespace TrenchBroom {
             
             UndoableCommand::Ptr popLastCommand();
             UndoableCommand::Ptr popNextCommand();
+            void clearLastCommands();
+            void clearNextCommands();
             void popLastRepeatableCommand(UndoableCommand::Ptr command);
         };
     }
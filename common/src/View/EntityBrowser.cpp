@@ -81,12 +81,9 @@ namespace TrenchBroom {
             wxPanel* browserPanel = new wxPanel(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxBORDER_NONE);
             m_scrollBar = new wxScrollBar(browserPanel, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxSB_VERTICAL);
             
-            MapDocumentSPtr document = lock(m_document);
             m_view = new EntityBrowserView(browserPanel, m_scrollBar,
                                            contextManager,
-                                           document->entityDefinitionManager(),
-                                           document->entityModelManager(),
-                                           *document);
+                                           m_document);
             
             wxSizer* browserPanelSizer = new wxBoxSizer(wxHORIZONTAL);
             browserPanelSizer->Add(m_view, 1, wxEXPAND);
@@ -138,6 +135,7 @@ namespace TrenchBroom {
             document->documentWasLoadedNotifier.addObserver(this, &EntityBrowser::documentWasLoaded);
             document->modsDidChangeNotifier.addObserver(this, &EntityBrowser::modsDidChange);
             document->entityDefinitionsDidChangeNotifier.addObserver(this, &EntityBrowser::entityDefinitionsDidChange);
+            document->entityModelsDidChangeNotifier.addObserver(this, &EntityBrowser::entityModelsDidChange);
             
             PreferenceManager& prefs = PreferenceManager::instance();
             prefs.preferenceDidChangeNotifier.addObserver(this, &EntityBrowser::preferenceDidChange);
@@ -150,6 +148,7 @@ namespace TrenchBroom {
                 document->documentWasLoadedNotifier.removeObserver(this, &EntityBrowser::documentWasLoaded);
                 document->modsDidChangeNotifier.removeObserver(this, &EntityBrowser::modsDidChange);
                 document->entityDefinitionsDidChangeNotifier.removeObserver(this, &EntityBrowser::entityDefinitionsDidChange);
+                document->entityModelsDidChangeNotifier.removeObserver(this, &EntityBrowser::entityModelsDidChange);
             }
             
             PreferenceManager& prefs = PreferenceManager::instance();
@@ -172,6 +171,10 @@ namespace TrenchBroom {
             reload();
         }
 
+        void EntityBrowser::entityModelsDidChange() {
+            reload();
+        }
+
         void EntityBrowser::preferenceDidChange(const IO::Path& path) {
             MapDocumentSPtr document = lock(m_document);
             if (document->isGamePathPreference(path))
@@ -36,6 +36,7 @@
 #include "Renderer/TexturedIndexRangeRenderer.h"
 #include "Renderer/Vertex.h"
 #include "Renderer/VertexArray.h"
+#include "View/MapDocument.h"
 #include "View/MapFrame.h"
 #include "View/ViewUtils.h"
 #include "View/wxUtils.h"
@@ -53,13 +54,11 @@ namespace TrenchBroom {
         EntityBrowserView::EntityBrowserView(wxWindow* parent,
                                              wxScrollBar* scrollBar,
                                              GLContextManager& contextManager,
-                                             Assets::EntityDefinitionManager& entityDefinitionManager,
-                                             Assets::EntityModelManager& entityModelManager,
-                                             Logger& logger) :
+                                             MapDocumentWPtr document) :
         CellView(parent, contextManager, buildAttribs(), scrollBar),
-        m_entityDefinitionManager(entityDefinitionManager),
-        m_entityModelManager(entityModelManager),
-        m_logger(logger),
+        m_document(document),
+        m_entityDefinitionManager(lock(m_document)->entityDefinitionManager()),
+        m_entityModelManager(lock(m_document)->entityModelManager()),
         m_group(false),
         m_hideUnused(false),
         m_sortOrder(Assets::EntityDefinition::Name) {
@@ -181,7 +180,7 @@ namespace TrenchBroom {
                 const Vec2f actualSize = fontManager().font(actualFont).measure(definition->name());
                 
                 const Assets::ModelSpecification spec = definition->defaultModel();
-                Assets::EntityModel* model = safeGetModel(m_entityModelManager, spec, m_logger);
+                Assets::EntityModel* model = safeGetModel(m_entityModelManager, spec, *lock(m_document));
                 EntityRenderer* modelRenderer = NULL;
                 
                 BBox3f rotatedBounds;
@@ -208,6 +207,9 @@ namespace TrenchBroom {
         void EntityBrowserView::doClear() {}
         
         void EntityBrowserView::doRender(Layout& layout, const float y, const float height) {
+            MapDocumentSPtr document = lock(m_document);
+            document->commitPendingAssets();
+            
             const float viewLeft      = static_cast<float>(GetClientRect().GetLeft());
             const float viewTop       = static_cast<float>(GetClientRect().GetBottom());
             const float viewRight     = static_cast<float>(GetClientRect().GetRight());
@@ -220,6 +222,10 @@ namespace TrenchBroom {
             renderBounds(layout, y, height);
             renderModels(layout, y, height, transformation);
             renderNames(layout, y, height, projection);
+            
+            // models are loaded and prepared over several frames
+            if (m_entityModelManager.hasPendingModels())
+                Refresh();
         }
 
         bool EntityBrowserView::doShouldRenderFocusIndicator() const {
@@ -299,7 +305,7 @@ namespace TrenchBroom {
                                 const Layout::Group::Row::Cell& cell = row[k];
                                 EntityRenderer* modelRenderer = cell.item().modelRenderer;
                                 
-                                if (modelRenderer != NULL) {
+                                if (modelRenderer != NULL && modelRenderer->prepared()) {
                                     const Mat4x4f itemTrans = itemTransformation(cell, y, height);
                                     Renderer::MultiplyModelMatrix multMatrix(transformation, itemTrans);
                                     modelRenderer->render();
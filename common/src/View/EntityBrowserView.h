@@ -27,8 +27,6 @@
 #include "View/ViewTypes.h"
 
 namespace TrenchBroom {
-    class Logger;
-
     namespace Assets {
         class EntityModelManager;
         class PointEntityDefinition;
@@ -64,9 +62,9 @@ namespace TrenchBroom {
             typedef Renderer::VertexSpecs::P2T2C4::Vertex TextVertex;
             typedef std::map<Renderer::FontDescriptor, TextVertex::List> StringMap;
 
+            MapDocumentWPtr m_document;
             Assets::EntityDefinitionManager& m_entityDefinitionManager;
             Assets::EntityModelManager& m_entityModelManager;
-            Logger& m_logger;
             Quatf m_rotation;
             
             bool m_group;
@@ -77,9 +75,7 @@ namespace TrenchBroom {
             EntityBrowserView(wxWindow* parent,
                               wxScrollBar* scrollBar,
                               GLContextManager& contextManager,
-                              Assets::EntityDefinitionManager& entityDefinitionManager,
-                              Assets::EntityModelManager& entityModelManager,
-                              Logger& logger);
+                              MapDocumentWPtr document);
             ~EntityBrowserView();
         public:
             void setSortOrder(Assets::EntityDefinition::SortOrder sortOrder);
@@ -59,5 +59,9 @@ namespace TrenchBroom {
         bool FindPlanePointsCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t FindPlanePointsCommand::doGetMemorySize() const {
+            return sizeof(FindPlanePointsCommand) + m_name.capacity() + (m_snapshot != NULL ? m_snapshot->memorySize() : 0);
+        }
     }
 }
@@ -118,19 +118,20 @@ namespace TrenchBroom {
         }
         
         void IssueBrowser::nodesWereAdded(const Model::NodeList& nodes) {
-            m_view->reset();
+            m_view->invalidate();
         }
         
+        // removed nodes may be deleted before the next idle event, so their issues must not be displayed any longer
         void IssueBrowser::nodesWereRemoved(const Model::NodeList& nodes) {
             m_view->reset();
         }
         
         void IssueBrowser::nodesDidChange(const Model::NodeList& nodes) {
-            m_view->reset();
+            m_view->invalidate();
         }
         
         void IssueBrowser::brushFacesDidChange(const Model::BrushFaceList& faces) {
-            m_view->reset();
+            m_view->invalidate();
         }
 
         void IssueBrowser::issueIgnoreChanged(Model::Issue* issue) {
@@ -21,7 +21,9 @@
 
 #include "Model/CollectMatchingIssuesVisitor.h"
 #include "Model/Issue.h"
+#include "Model/IssueGenerator.h"
 #include "Model/IssueQuickFix.h"
+#include "Model/IssueValidator.h"
 #include "Model/World.h"
 #include "View/MapDocument.h"
 #include "View/wxUtils.h"
@@ -35,7 +37,8 @@ namespace TrenchBroom {
         wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxLC_HRULES | wxLC_VRULES | wxBORDER_NONE),
         m_document(document),
         m_hiddenGenerators(0),
-        m_showHiddenIssues(false) {
+        m_showHiddenIssues(false),
+        m_valid(false) {
             AppendColumn("Line");
             AppendColumn("Description");
             
@@ -63,6 +66,19 @@ namespace TrenchBroom {
             updateIssues();
             SetItemCount(static_cast<long>(m_issues.size()));
             Refresh();
+            m_valid = true;
+        }
+
+        // the displayed issues are kept until the next idle event so that several changes are validated at once
+        void IssueBrowserView::invalidate() {
+            m_valid = false;
+        }
+
+        void IssueBrowserView::OnIdle(wxIdleEvent& event) {
+            if (IsBeingDeleted()) return;
+            
+            if (!m_valid)
+                reset();
         }
 
         void IssueBrowserView::OnSize(wxSizeEvent& event) {
@@ -163,6 +179,8 @@ namespace TrenchBroom {
             MapDocumentSPtr document = lock(m_document);
             Model::World* world = document->world();
             if (world != NULL) {
+                validateIssues(world);
+                
                 const Model::IssueGeneratorList& issueGenerators = world->registeredIssueGenerators();
                 Model::CollectMatchingIssuesVisitor<IssueVisible> visitor(issueGenerators, IssueVisible(m_hiddenGenerators, m_showHiddenIssues));
                 world->acceptAndRecurse(visitor);
@@ -171,6 +189,21 @@ namespace TrenchBroom {
             }
         }
 
+        void IssueBrowserView::validateIssues(Model::World* world) {
+            const Model::IssueGeneratorList& issueGenerators = world->registeredIssueGenerators();
+            Model::IssueValidator validator(m_validationPool);
+            validator.validate(world, issueGenerators);
+            
+            if (validator.nodeCount() > 0) {
+                MapDocumentSPtr document = lock(m_document);
+                document->debug("Validated issues of %lu nodes", static_cast<unsigned long>(validator.nodeCount()));
+                
+                const Model::IssueValidator::TimeList& times = validator.times();
+                for (size_t i = 0; i < issueGenerators.size(); ++i)
+                    document->debug("  %-40s %8.2f ms", issueGenerators[i]->description().c_str(), times[i]);
+            }
+        }
+
         void IssueBrowserView::OnApplyQuickFix(wxCommandEvent& event) {
             if (IsBeingDeleted()) return;
 
@@ -265,6 +298,7 @@ namespace TrenchBroom {
         }
         
         void IssueBrowserView::bindEvents() {
+            Bind(wxEVT_IDLE, &IssueBrowserView::OnIdle, this);
             Bind(wxEVT_SIZE, &IssueBrowserView::OnSize, this);
             Bind(wxEVT_LIST_ITEM_RIGHT_CLICK, &IssueBrowserView::OnItemRightClick, this);
             Bind(wxEVT_LIST_ITEM_SELECTED, &IssueBrowserView::OnItemSelectionChanged, this);
@@ -20,6 +20,7 @@
 #ifndef TrenchBroom_IssueBrowserView
 #define TrenchBroom_IssueBrowserView
 
+#include "ThreadPool.h"
 #include "View/ViewTypes.h"
 
 #include "Model/Issue.h"
@@ -46,6 +47,9 @@ namespace TrenchBroom {
             
             Model::IssueType m_hiddenGenerators;
             bool m_showHiddenIssues;
+            
+            ThreadPool m_validationPool;
+            bool m_valid;
         public:
             IssueBrowserView(wxWindow* parent, MapDocumentWPtr document);
             
@@ -53,7 +57,9 @@ namespace TrenchBroom {
             void setHiddenGenerators(int hiddenGenerators);
             void setShowHiddenIssues(bool show);
             void reset();
+            void invalidate();
             
+            void OnIdle(wxIdleEvent& event);
             void OnSize(wxSizeEvent& event);
             
             void OnItemRightClick(wxListEvent& event);
@@ -66,6 +72,7 @@ namespace TrenchBroom {
             class IssueCmp;
             
             void updateIssues();
+            void validateIssues(Model::World* world);
             
             Model::IssueList collectIssues(const IndexList& indices) const;
             Model::IssueQuickFixList collectQuickFixes(const IndexList& indices) const;
@@ -22,6 +22,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Polyhedron.h"
+#include "ThreadPool.h"
 #include "Assets/EntityDefinitionManager.h"
 #include "Assets/EntityModelManager.h"
 #include "Assets/TextureCollectionSpec.h"
@@ -32,7 +33,9 @@
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/BrushGeometry.h"
+#include "Model/BrushGeometryCache.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/CollectAttributableNodesVisitor.h"
 #include "Model/CollectContainedNodesVisitor.h"
@@ -44,6 +47,7 @@
 #include "Model/CollectSelectedNodesVisitor.h"
 #include "Model/CollectTouchingNodesVisitor.h"
 #include "Model/CollectUniqueNodesVisitor.h"
+#include "Model/ComputeMemoryUsageVisitor.h"
 #include "Model/ComputeNodeBoundsVisitor.h"
 #include "Model/EditorContext.h"
 #include "Model/EmptyBrushEntityIssueGenerator.h"
@@ -445,7 +449,8 @@ namespace TrenchBroom {
         
         void MapDocument::selectTouching(const bool del) {
             const Model::BrushList& brushes = m_selectedNodes.brushes();
-            const Model::NodeList nodes = Model::collectMatchingNodes<Model::CollectTouchingNodesVisitor>(brushes.begin(), brushes.end(), m_world);
+            ThreadPool threadPool;
+            const Model::NodeList nodes = Model::findMatchingNodes<Model::MatchTouchingNodes>(brushes.begin(), brushes.end(), m_world, threadPool);
             
             Transaction transaction(this, "Select Touching");
             if (del)
@@ -457,7 +462,8 @@ namespace TrenchBroom {
         
         void MapDocument::selectInside(const bool del) {
             const Model::BrushList& brushes = m_selectedNodes.brushes();
-            const Model::NodeList nodes = Model::collectMatchingNodes<Model::CollectContainedNodesVisitor>(brushes.begin(), brushes.end(), m_world);
+            ThreadPool threadPool;
+            const Model::NodeList nodes = Model::findMatchingNodes<Model::MatchContainedNodes>(brushes.begin(), brushes.end(), m_world, threadPool);
             
             Transaction transaction(this, "Select Inside");
             if (del)
@@ -1004,6 +1010,33 @@ namespace TrenchBroom {
             }
         }
 
+        static void logMemoryUsage(Logger* logger, const String& type, const Model::ComputeMemoryUsageVisitor::Usage& usage) {
+            logger->info("%-16s %10lu %12lu KB", type.c_str(), static_cast<unsigned long>(usage.count), static_cast<unsigned long>(usage.bytes / 1024));
+        }
+        
+        void MapDocument::printMemoryUsage() {
+            Model::ComputeMemoryUsageVisitor visitor;
+            m_world->acceptAndRecurse(visitor);
+            
+            info("Estimated memory usage:");
+            logMemoryUsage(this, "Worlds", visitor.worlds());
+            logMemoryUsage(this, "Layers", visitor.layers());
+            logMemoryUsage(this, "Groups", visitor.groups());
+            logMemoryUsage(this, "Entities", visitor.entities());
+            logMemoryUsage(this, "Brushes", visitor.brushes());
+            logMemoryUsage(this, "Brush faces", visitor.brushFaces());
+            logMemoryUsage(this, "Brush geometries", visitor.brushGeometries());
+            logMemoryUsage(this, "Total", visitor.total());
+            
+            const Model::BrushGeometryCache& cache = Model::BrushGeometryCache::instance();
+            info("Brush geometry cache: %lu entries, %lu KB, %lu hits, %lu misses",
+                 static_cast<unsigned long>(cache.entryCount()),
+                 static_cast<unsigned long>(cache.memoryUsage() / 1024),
+                 static_cast<unsigned long>(cache.hits()),
+                 static_cast<unsigned long>(cache.misses()));
+            info("Interned texture names: %lu", static_cast<unsigned long>(Model::BrushFaceAttributes::textureNameCount()));
+        }
+
         bool MapDocument::canUndoLastCommand() const {
             return doCanUndoLastCommand();
         }
@@ -1059,6 +1092,14 @@ namespace TrenchBroom {
         
         void MapDocument::commitPendingAssets() {
             m_textureManager->commitChanges();
+            if (m_entityModelManager->commitLoadedModels()) {
+                setEntityModels();
+                entityModelsDidChangeNotifier();
+            }
+        }
+        
+        bool MapDocument::hasPendingAssets() const {
+            return m_textureManager->hasPendingChanges() || m_entityModelManager->hasPendingModels();
         }
         
         void MapDocument::pick(const Ray3& pickRay, Model::PickResult& pickResult) const {
@@ -1072,6 +1113,13 @@ namespace TrenchBroom {
                 m_world->findNodesContaining(point, result);
             return result;
         }
+        
+        Model::NodeList MapDocument::findNodesInFrustum(const Plane3::List& frustum) const {
+            Model::NodeList result;
+            if (m_world != NULL)
+                m_world->findNodesInFrustum(frustum, result);
+            return result;
+        }
 
         void MapDocument::createWorld(const Model::MapFormat::Type mapFormat, const BBox3& worldBounds, Model::GamePtr game) {
             m_worldBounds = worldBounds;
@@ -1515,9 +1563,10 @@ namespace TrenchBroom {
             if (isGamePathPreference(path)) {
                 const Model::GameFactory& gameFactory = Model::GameFactory::instance();
                 const IO::Path newGamePath = gameFactory.gamePath(m_game->gameName());
-                m_game->setGamePath(newGamePath);
                 
+                // the model load tasks read from the game's file system, so they must be done before it is replaced
                 clearEntityModels();
+                m_game->setGamePath(newGamePath);
                 setEntityModels();
                 
                 unsetTextures();
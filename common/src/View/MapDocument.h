@@ -132,6 +132,7 @@ namespace TrenchBroom {
             
             Notifier0 textureCollectionsDidChangeNotifier;
             Notifier0 entityDefinitionsDidChangeNotifier;
+            Notifier0 entityModelsDidChangeNotifier;
             Notifier0 modsDidChangeNotifier;
             
             Notifier0 pointFileWasLoadedNotifier;
@@ -296,6 +297,7 @@ namespace TrenchBroom {
             virtual void performRebuildBrushGeometry(const Model::BrushList& brushes) = 0;
         public: // debug commands
             void printVertices();
+            void printMemoryUsage();
         public: // command processing
             bool canUndoLastCommand() const;
             bool canRedoNextCommand() const;
@@ -329,9 +331,11 @@ namespace TrenchBroom {
             virtual bool doSubmit(UndoableCommand::Ptr command) = 0;
         public: // asset state management
             void commitPendingAssets();
+            bool hasPendingAssets() const;
         public: // picking
             void pick(const Ray3& pickRay, Model::PickResult& pickResult) const;
             Model::NodeList findNodesContaining(const Vec3& point) const;
+            Model::NodeList findNodesInFrustum(const Plane3::List& frustum) const;
         private: // world management
             void createWorld(Model::MapFormat::Type mapFormat, const BBox3& worldBounds, Model::GamePtr game);
             void loadWorld(Model::MapFormat::Type mapFormat, const BBox3& worldBounds, Model::GamePtr game, const IO::Path& path);
@@ -20,6 +20,7 @@
 #include "MapDocumentCommandFacade.h"
 
 #include "CollectionUtils.h"
+#include "ThreadPool.h"
 #include "Assets/EntityDefinitionFileSpec.h"
 #include "Assets/TextureManager.h"
 #include "Model/Brush.h"
@@ -574,6 +575,36 @@ namespace TrenchBroom {
             groupWasClosedNotifier(previousGroup);
         }
 
+        static size_t brushThreadCount(const Model::BrushList& brushes) {
+            // not worth starting any threads for a handful of brushes
+            if (brushes.size() < 64)
+                return 0;
+            return ThreadPool::defaultThreadCount();
+        }
+        
+        static size_t transformThreadCount(const Model::NodeList& nodes) {
+            if (nodes.size() >= 64)
+                return ThreadPool::defaultThreadCount();
+            
+            // a single group or brush entity can contain many brushes
+            Model::NodeList::const_iterator it, end;
+            for (it = nodes.begin(), end = nodes.end(); it != end; ++it) {
+                const Model::Node* node = *it;
+                if (node->hasChildren())
+                    return ThreadPool::defaultThreadCount();
+            }
+            return 0;
+        }
+        
+        static void logGeometryErrors(Logger& logger, const Model::Brush::GeometryErrorList& errors) {
+            Model::Brush::GeometryErrorList::const_iterator it, end;
+            for (it = errors.begin(), end = errors.end(); it != end; ++it) {
+                const Model::Brush* brush = it->first;
+                const String& message = it->second;
+                logger.error("Could not build geometry of brush at line %lu: %s", static_cast<unsigned long>(brush->lineNumber()), message.c_str());
+            }
+        }
+        
         void MapDocumentCommandFacade::performTransform(const Mat4x4& transform, const bool lockTextures) {
             const Model::NodeList& nodes = m_selectedNodes.nodes();
             const Model::NodeList parents = collectParents(nodes);
@@ -581,8 +612,8 @@ namespace TrenchBroom {
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
             
-            Model::TransformObjectVisitor visitor(transform, lockTextures, m_worldBounds);
-            Model::Node::accept(nodes.begin(), nodes.end(), visitor);
+            ThreadPool threadPool(transformThreadCount(nodes));
+            logGeometryErrors(*this, Model::transformObjects(nodes, transform, lockTextures, m_worldBounds, threadPool));
             
             invalidateSelectionBounds();
         }
@@ -768,11 +799,8 @@ namespace TrenchBroom {
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
             
-            Model::BrushList::const_iterator it, end;
-            for (it = brushes.begin(), end = brushes.end(); it != end; ++it) {
-                Model::Brush* brush = *it;
-                brush->findIntegerPlanePoints(m_worldBounds);
-            }
+            ThreadPool threadPool(brushThreadCount(brushes));
+            logGeometryErrors(*this, Model::Brush::findIntegerPlanePoints(brushes, m_worldBounds, threadPool));
             
             return snapshot;
         }
@@ -935,11 +963,8 @@ namespace TrenchBroom {
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
             
-            Model::BrushList::const_iterator it, end;
-            for (it = brushes.begin(), end = brushes.end(); it != end; ++it) {
-                Model::Brush* brush = *it;
-                brush->rebuildGeometry(m_worldBounds);
-            }
+            ThreadPool threadPool(brushThreadCount(brushes));
+            logGeometryErrors(*this, Model::Brush::rebuildGeometry(brushes, m_worldBounds, threadPool));
 
             invalidateSelectionBounds();
         }
@@ -475,6 +475,7 @@ namespace TrenchBroom {
             Bind(wxEVT_MENU, &MapFrame::OnDebugPrintVertices, this, CommandIds::Menu::DebugPrintVertices);
             Bind(wxEVT_MENU, &MapFrame::OnDebugCreateBrush, this, CommandIds::Menu::DebugCreateBrush);
             Bind(wxEVT_MENU, &MapFrame::OnDebugCopyJSShortcutMap, this, CommandIds::Menu::DebugCopyJSShortcuts);
+            Bind(wxEVT_MENU, &MapFrame::OnDebugPrintMemoryUsage, this, CommandIds::Menu::DebugPrintMemoryUsage);
             
             Bind(wxEVT_MENU, &MapFrame::OnFlipObjectsHorizontally, this, CommandIds::Actions::FlipObjectsHorizontally);
             Bind(wxEVT_MENU, &MapFrame::OnFlipObjectsVertically, this, CommandIds::Actions::FlipObjectsVertically);
@@ -973,6 +974,12 @@ namespace TrenchBroom {
 
         }
 
+        void MapFrame::OnDebugPrintMemoryUsage(wxCommandEvent& event) {
+            if (IsBeingDeleted()) return;
+            
+            m_document->printMemoryUsage();
+        }
+
         void MapFrame::OnFlipObjectsHorizontally(wxCommandEvent& event) {
             if (IsBeingDeleted()) return;
             m_mapView->flipObjects(Math::Direction_Left);
@@ -1201,6 +1208,7 @@ namespace TrenchBroom {
                 case CommandIds::Menu::DebugPrintVertices:
                 case CommandIds::Menu::DebugCreateBrush:
                 case CommandIds::Menu::DebugCopyJSShortcuts:
+                case CommandIds::Menu::DebugPrintMemoryUsage:
                     event.Enable(true);
                     break;
                 case CommandIds::Actions::FlipObjectsHorizontally:
@@ -188,6 +188,7 @@ namespace TrenchBroom {
             void OnDebugPrintVertices(wxCommandEvent& event);
             void OnDebugCreateBrush(wxCommandEvent& event);
             void OnDebugCopyJSShortcutMap(wxCommandEvent& event);
+            void OnDebugPrintMemoryUsage(wxCommandEvent& event);
             
             void OnFlipObjectsHorizontally(wxCommandEvent& event);
             void OnFlipObjectsVertically(wxCommandEvent& event);
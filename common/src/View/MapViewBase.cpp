@@ -70,7 +70,8 @@ namespace TrenchBroom {
         m_toolBox(toolBox),
         m_animationManager(new AnimationManager()),
         m_renderer(renderer),
-        m_compass(NULL) {
+        m_compass(NULL),
+        m_overlayTime(0.0) {
             setToolBox(toolBox);
             toolBox.addWindow(this);
             bindEvents();
@@ -832,6 +833,7 @@ namespace TrenchBroom {
             const Renderer::FontDescriptor fontDescriptor(fontPath, fontSize);
 
             Renderer::RenderContext renderContext = createRenderContext();
+            renderContext.setLastOverlayTime(m_overlayTime);
 
             setupGL(renderContext);
             setRenderOptions(renderContext);
@@ -847,6 +849,12 @@ namespace TrenchBroom {
             renderCompass(renderBatch);
             
             renderBatch.render(renderContext);
+            m_overlayTime = renderContext.overlayTime();
+            
+            // textures are uploaded over several frames
+            MapDocumentSPtr document = lock(m_document);
+            if (document->hasPendingAssets())
+                Refresh();
         }
 
         Renderer::RenderContext MapViewBase::createRenderContext() {
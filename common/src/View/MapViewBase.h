@@ -69,6 +69,7 @@ namespace TrenchBroom {
         private:
             Renderer::MapRenderer& m_renderer;
             Renderer::Compass* m_compass;
+            double m_overlayTime;
         protected:
             MapViewBase(wxWindow* parent, Logger* logger, MapDocumentWPtr document, MapViewToolBox& toolBox, Renderer::MapRenderer& renderer, GLContextManager& contextManager);
             
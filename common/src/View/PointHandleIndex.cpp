@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PointHandleIndex.h"
+
+#include "Renderer/Camera.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace View {
+        class PointHandleIndex::PickQuery {
+        private:
+            const Ray3& m_ray;
+            const Renderer::Camera& m_camera;
+            FloatType m_handleRadius;
+        public:
+            PickQuery(const Ray3& ray, const Renderer::Camera& camera, const FloatType handleRadius) :
+            m_ray(ray),
+            m_camera(camera),
+            m_handleRadius(handleRadius) {}
+            
+            bool operator()(const BBox3& box) const {
+                const BBox3 expanded = box.expanded(maxPickRadius(box));
+                return expanded.contains(m_ray.origin) || !Math::isnan(expanded.intersectWithRay(m_ray));
+            }
+        private:
+            // The pick radius of a handle grows linearly with its distance from the camera plane, so the largest
+            // pick radius within the given box is found at the corner nearest to or furthest from that plane.
+            FloatType maxPickRadius(const BBox3& box) const {
+                const Vec3 direction(m_camera.direction());
+                Vec3 nearest, furthest;
+                for (size_t i = 0; i < 3; ++i) {
+                    nearest[i]  = direction[i] >= 0.0 ? box.min[i] : box.max[i];
+                    furthest[i] = direction[i] >= 0.0 ? box.max[i] : box.min[i];
+                }
+                
+                const FloatType nearestScaling  = std::abs(static_cast<FloatType>(m_camera.perspectiveScalingFactor(Vec3f(nearest))));
+                const FloatType furthestScaling = std::abs(static_cast<FloatType>(m_camera.perspectiveScalingFactor(Vec3f(furthest))));
+                return 2.0 * m_handleRadius * std::max(nearestScaling, furthestScaling);
+            }
+        };
+        
+        PointHandleIndex::PointHandleIndex() :
+        m_tree(NULL) {}
+        
+        PointHandleIndex::~PointHandleIndex() {
+            invalidate();
+        }
+        
+        bool PointHandleIndex::valid() const {
+            return m_tree != NULL;
+        }
+        
+        void PointHandleIndex::invalidate() {
+            delete m_tree;
+            m_tree = NULL;
+        }
+        
+        void PointHandleIndex::build(const List& positions) {
+            invalidate();
+            
+            BBox3 bounds(Vec3::Null, Vec3::Null);
+            if (!positions.empty()) {
+                bounds = BBox3(*positions.front(), *positions.front());
+                List::const_iterator it, end;
+                for (it = positions.begin(), end = positions.end(); it != end; ++it) {
+                    const Vec3* position = *it;
+                    bounds.mergeWith(*position);
+                }
+            }
+            
+            // leave some room so that no handle lies on the boundary of the tree and handles which are added later
+            // do not invalidate the tree right away, and split the tree into at most 64 cells along its longest side
+            const Vec3 handleSize = bounds.size();
+            bounds.expand(std::max(1.0, std::max(std::max(handleSize.x(), handleSize.y()), handleSize.z()) / 4.0));
+            const Vec3 size = bounds.size();
+            const FloatType minSize = std::max(std::max(size.x(), size.y()), size.z()) / 64.0;
+            
+            m_tree = new HandleTree(bounds, minSize);
+            List::const_iterator it, end;
+            for (it = positions.begin(), end = positions.end(); it != end; ++it) {
+                const Vec3* position = *it;
+                m_tree->addObject(BBox3(*position, *position), position);
+            }
+        }
+        
+        void PointHandleIndex::addHandle(const Vec3* position) {
+            if (!valid())
+                return;
+            
+            const BBox3 bounds(*position, *position);
+            if (m_tree->bounds().contains(bounds))
+                m_tree->addObject(bounds, position);
+            else
+                invalidate();
+        }
+        
+        void PointHandleIndex::removeHandle(const Vec3* position) {
+            if (valid())
+                m_tree->removeObject(position);
+        }
+
+        PointHandleIndex::List PointHandleIndex::findHandles(const Ray3& ray, const Renderer::Camera& camera, const FloatType handleRadius) const {
+            assert(valid());
+            
+            List result;
+            m_tree->findObjectsMatching(PickQuery(ray, camera, handleRadius), result);
+            return result;
+        }
+    }
+}
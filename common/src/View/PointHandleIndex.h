@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_PointHandleIndex
+#define TrenchBroom_PointHandleIndex
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "Model/Octree.h"
+
+#include <map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        class Camera;
+    }
+    
+    namespace View {
+        /*
+         A spatial index of point handle positions which is built on demand and can be updated afterwards. The
+         positions are not copied, so they must not change or be destroyed while they are in the index.
+         */
+        class PointHandleIndex {
+        public:
+            typedef std::vector<const Vec3*> List;
+        private:
+            typedef Model::Octree<FloatType, const Vec3*> HandleTree;
+            class PickQuery;
+            
+            HandleTree* m_tree;
+        public:
+            PointHandleIndex();
+            ~PointHandleIndex();
+            
+            bool valid() const;
+            void invalidate();
+            
+            template <typename T, typename O>
+            void build(const std::map<Vec3, T, O>& handles) {
+                List positions;
+                positions.reserve(handles.size());
+                
+                typename std::map<Vec3, T, O>::const_iterator it, end;
+                for (it = handles.begin(), end = handles.end(); it != end; ++it) {
+                    const Vec3& position = it->first;
+                    positions.push_back(&position);
+                }
+                build(positions);
+            }
+            
+            void build(const List& positions);
+            
+            // These do nothing if the index is invalid. A handle outside the bounds of the index invalidates it.
+            void addHandle(const Vec3* position);
+            void removeHandle(const Vec3* position);
+            
+            // Finds the handles which may be hit by the given ray. The result contains every handle for which
+            // Camera::pickPointHandle reports a hit, but the caller must still test the returned handles.
+            List findHandles(const Ray3& ray, const Renderer::Camera& camera, FloatType handleRadius) const;
+        private:
+            PointHandleIndex(const PointHandleIndex& other);
+            PointHandleIndex& operator=(const PointHandleIndex& other);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_PointHandleIndex) */
@@ -20,6 +20,8 @@
 #include "ReparentNodesCommand.h"
 
 #include "CollectionUtils.h"
+#include "Model/ComputeMemoryUsageVisitor.h"
+#include "Model/Node.h"
 #include "View/MapDocumentCommandFacade.h"
 
 #include <cassert>
@@ -74,5 +76,16 @@ namespace TrenchBroom {
         bool ReparentNodesCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t ReparentNodesCommand::doGetMemorySize() const {
+            // the nodes which were removed because they became empty are owned by this command
+            Model::ComputeMemoryUsageVisitor visitor;
+            Model::ParentChildrenMap::const_iterator it, end;
+            for (it = m_removedNodes.begin(), end = m_removedNodes.end(); it != end; ++it) {
+                const Model::NodeList& children = it->second;
+                Model::Node::acceptAndRecurse(children.begin(), children.end(), visitor);
+            }
+            return sizeof(ReparentNodesCommand) + m_name.capacity() + visitor.total().bytes;
+        }
     }
 }
@@ -181,6 +181,10 @@ namespace TrenchBroom {
             renderBounds(layout, y, height);
             renderTextures(layout, y, height);
             renderNames(layout, y, height);
+            
+            // textures are uploaded over several frames
+            if (m_textureManager.hasPendingChanges())
+                Refresh();
         }
 
         bool TextureBrowserView::doShouldRenderFocusIndicator() const {
@@ -163,6 +163,10 @@ namespace TrenchBroom {
                 renderTextureAxes(renderContext, renderBatch);
                 
                 renderBatch.render(renderContext);
+                
+                // textures are uploaded over several frames
+                if (document->hasPendingAssets())
+                    Refresh();
             }
         }
         
@@ -239,7 +243,7 @@ namespace TrenchBroom {
                 texture->activate();
                 
                 Renderer::ActiveShader shader(renderContext.shaderManager(), Renderer::Shaders::UVViewShader);
-                shader.set("ApplyTexture", true);
+                shader.set("ApplyTexture", texture->isPrepared());
                 shader.set("Color", texture->averageColor());
                 shader.set("Brightness", pref(Preferences::Brightness));
                 shader.set("RenderGrid", true);
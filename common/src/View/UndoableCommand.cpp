@@ -58,6 +58,10 @@ namespace TrenchBroom {
             return doCollateWith(command);
         }
 
+        size_t UndoableCommand::memorySize() const {
+            return doGetMemorySize();
+        }
+
         bool UndoableCommand::doIsRepeatDelimiter() const {
             return false;
         }
@@ -66,6 +70,10 @@ namespace TrenchBroom {
             throw CommandProcessorException("Command is not repeatable");
         }
 
+        size_t UndoableCommand::doGetMemorySize() const {
+            return sizeof(UndoableCommand) + m_name.capacity();
+        }
+
         size_t UndoableCommand::documentModificationCount() const {
             throw CommandProcessorException("Command does not modify the document");
         }
@@ -41,6 +41,8 @@ namespace TrenchBroom {
             UndoableCommand::Ptr repeat(MapDocumentCommandFacade* document) const;
             
             virtual bool collateWith(UndoableCommand::Ptr command);
+            
+            size_t memorySize() const;
         private:
             virtual bool doPerformUndo(MapDocumentCommandFacade* document) = 0;
             
@@ -49,6 +51,7 @@ namespace TrenchBroom {
             virtual UndoableCommand::Ptr doRepeat(MapDocumentCommandFacade* document) const;
             
             virtual bool doCollateWith(UndoableCommand::Ptr command) = 0;
+            virtual size_t doGetMemorySize() const;
         public: // this method is just a service for DocumentCommand and should never be called from anywhere else
             virtual size_t documentModificationCount() const;
         };
@@ -125,6 +125,10 @@ namespace TrenchBroom {
             return false;
         }
 
+        size_t VertexCommand::doGetMemorySize() const {
+            return sizeof(VertexCommand) + m_brushes.capacity() * sizeof(Model::Brush*) + m_name.capacity() + (m_snapshot != NULL ? m_snapshot->memorySize() : 0);
+        }
+
         void VertexCommand::takeSnapshot() {
             assert(m_snapshot == NULL);
             m_snapshot = new Model::Snapshot(m_brushes.begin(), m_brushes.end());
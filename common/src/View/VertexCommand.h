@@ -47,6 +47,7 @@ namespace TrenchBroom {
             bool doPerformDo(MapDocumentCommandFacade* document);
             bool doPerformUndo(MapDocumentCommandFacade* document);
             bool doIsRepeatable(MapDocumentCommandFacade* document) const;
+            size_t doGetMemorySize() const;
         private:
             void takeSnapshot();
             void deleteSnapshot();
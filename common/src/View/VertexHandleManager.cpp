@@ -254,7 +254,7 @@ namespace TrenchBroom {
                     mapIt->second.insert(brush);
                     m_selectedVertexCount++;
                 } else {
-                    m_unselectedVertexHandles[vertex->position()].insert(brush);
+                    addHandle(vertex->position(), brush, m_unselectedVertexHandles, m_unselectedVertexHandleIndex);
                 }
             }
             m_totalVertexCount += brushVertices.size();
@@ -269,7 +269,7 @@ namespace TrenchBroom {
                     mapIt->second.insert(edge);
                     m_selectedEdgeCount++;
                 } else {
-                    m_unselectedEdgeHandles[position].insert(edge);
+                    addHandle(position, edge, m_unselectedEdgeHandles, m_unselectedEdgeHandleIndex);
                 }
             }
             m_totalEdgeCount+= brushEdges.size();
@@ -284,7 +284,7 @@ namespace TrenchBroom {
                     mapIt->second.insert(face);
                     m_selectedFaceCount++;
                 } else {
-                    m_unselectedFaceHandles[position].insert(face);
+                    addHandle(position, face, m_unselectedFaceHandles, m_unselectedFaceHandleIndex);
                 }
             }
             m_totalFaceCount += brushFaces.size();
@@ -296,11 +296,11 @@ namespace TrenchBroom {
             Model::Brush::VertexList::const_iterator vIt, vEnd;
             for (vIt = brushVertices.begin(), vEnd = brushVertices.end(); vIt != vEnd; ++vIt) {
                 const Model::BrushVertex* vertex = *vIt;
-                if (removeHandle(vertex->position(), brush, m_selectedVertexHandles)) {
+                if (removeHandle(vertex->position(), brush, m_selectedVertexHandles, m_selectedVertexHandleIndex)) {
                     assert(m_selectedVertexCount > 0);
                     m_selectedVertexCount--;
                 } else {
-                    removeHandle(vertex->position(), brush, m_unselectedVertexHandles);
+                    removeHandle(vertex->position(), brush, m_unselectedVertexHandles, m_unselectedVertexHandleIndex);
                 }
             }
             assert(m_totalVertexCount >= brushVertices.size());
@@ -311,11 +311,11 @@ namespace TrenchBroom {
             for (eIt = brushEdges.begin(), eEnd = brushEdges.end(); eIt != eEnd; ++eIt) {
                 Model::BrushEdge* edge = *eIt;
                 const Vec3 position = edge->center();
-                if (removeHandle(position, edge, m_selectedEdgeHandles)) {
+                if (removeHandle(position, edge, m_selectedEdgeHandles, m_selectedEdgeHandleIndex)) {
                     assert(m_selectedEdgeCount > 0);
                     m_selectedEdgeCount--;
                 } else {
-                    removeHandle(position, edge, m_unselectedEdgeHandles);
+                    removeHandle(position, edge, m_unselectedEdgeHandles, m_unselectedEdgeHandleIndex);
                 }
             }
             assert(m_totalEdgeCount >= brushEdges.size());
@@ -326,11 +326,11 @@ namespace TrenchBroom {
             for (fIt = brushFaces.begin(), fEnd = brushFaces.end(); fIt != fEnd; ++fIt) {
                 Model::BrushFace* face = *fIt;
                 const Vec3 position = face->center();
-                if (removeHandle(position, face, m_selectedFaceHandles)) {
+                if (removeHandle(position, face, m_selectedFaceHandles, m_selectedFaceHandleIndex)) {
                     assert(m_selectedFaceCount > 0);
                     m_selectedFaceCount--;
                 } else {
-                    removeHandle(position, face, m_unselectedFaceHandles);
+                    removeHandle(position, face, m_unselectedFaceHandles, m_unselectedFaceHandleIndex);
                 }
             }
             assert(m_totalFaceCount >= brushFaces.size());
@@ -351,12 +351,18 @@ namespace TrenchBroom {
             m_selectedFaceHandles.clear();
             m_totalFaceCount = 0;
             m_selectedFaceCount = 0;
+            m_unselectedVertexHandleIndex.invalidate();
+            m_selectedVertexHandleIndex.invalidate();
+            m_unselectedEdgeHandleIndex.invalidate();
+            m_selectedEdgeHandleIndex.invalidate();
+            m_unselectedFaceHandleIndex.invalidate();
+            m_selectedFaceHandleIndex.invalidate();
             m_renderStateValid = false;
         }
         
         void VertexHandleManager::selectVertexHandle(const Vec3& position) {
             size_t count = 0;
-            if ((count = moveHandle(position, m_unselectedVertexHandles, m_selectedVertexHandles)) > 0) {
+            if ((count = moveHandle(position, m_unselectedVertexHandles, m_unselectedVertexHandleIndex, m_selectedVertexHandles, m_selectedVertexHandleIndex)) > 0) {
                 m_selectedVertexCount += count;
                 m_renderStateValid = false;
             }
@@ -364,7 +370,7 @@ namespace TrenchBroom {
         
         void VertexHandleManager::deselectVertexHandle(const Vec3& position) {
             size_t count = 0;
-            if ((count = moveHandle(position, m_selectedVertexHandles, m_unselectedVertexHandles)) > 0) {
+            if ((count = moveHandle(position, m_selectedVertexHandles, m_selectedVertexHandleIndex, m_unselectedVertexHandles, m_unselectedVertexHandleIndex)) > 0) {
                 assert(m_selectedVertexCount >= count);
                 m_selectedVertexCount -= count;
                 m_renderStateValid = false;
@@ -373,10 +379,10 @@ namespace TrenchBroom {
         
         void VertexHandleManager::toggleVertexHandle(const Vec3& position) {
             size_t count = 0;
-            if ((count = moveHandle(position, m_unselectedVertexHandles, m_selectedVertexHandles)) > 0) {
+            if ((count = moveHandle(position, m_unselectedVertexHandles, m_unselectedVertexHandleIndex, m_selectedVertexHandles, m_selectedVertexHandleIndex)) > 0) {
                 m_selectedVertexCount += count;
                 m_renderStateValid = false;
-            } else if ((count = moveHandle(position, m_selectedVertexHandles, m_unselectedVertexHandles)) > 0) {
+            } else if ((count = moveHandle(position, m_selectedVertexHandles, m_selectedVertexHandleIndex, m_unselectedVertexHandles, m_unselectedVertexHandleIndex)) > 0) {
                 assert(m_selectedVertexCount >= count);
                 m_selectedVertexCount -= count;
                 m_renderStateValid = false;
@@ -390,14 +396,7 @@ namespace TrenchBroom {
         }
         
         void VertexHandleManager::deselectAllVertexHandles() {
-            Model::VertexToBrushesMap::const_iterator vIt, vEnd;
-            for (vIt = m_selectedVertexHandles.begin(), vEnd = m_selectedVertexHandles.end(); vIt != vEnd; ++vIt) {
-                const Vec3& position = vIt->first;
-                const Model::BrushSet& selectedBrushes = vIt->second;
-                Model::BrushSet& unselectedBrushes = m_unselectedVertexHandles[position];
-                unselectedBrushes.insert(selectedBrushes.begin(), selectedBrushes.end());
-            }
-            m_selectedVertexHandles.clear();
+            moveAllHandles(m_selectedVertexHandles, m_selectedVertexHandleIndex, m_unselectedVertexHandles, m_unselectedVertexHandleIndex);
             m_selectedVertexCount = 0;
             m_renderStateValid = false;
         }
@@ -410,7 +409,7 @@ namespace TrenchBroom {
         
         void VertexHandleManager::selectEdgeHandle(const Vec3& position) {
             size_t count = 0;
-            if ((count = moveHandle(position, m_unselectedEdgeHandles, m_selectedEdgeHandles)) > 0) {
+            if ((count = moveHandle(position, m_unselectedEdgeHandles, m_unselectedEdgeHandleIndex, m_selectedEdgeHandles, m_selectedEdgeHandleIndex)) > 0) {
                 m_selectedEdgeCount += count;
                 m_renderStateValid = false;
             }
@@ -418,7 +417,7 @@ namespace TrenchBroom {
         
         void VertexHandleManager::deselectEdgeHandle(const Vec3& position) {
             size_t count = 0;
-            if ((count = moveHandle(position, m_selectedEdgeHandles, m_unselectedEdgeHandles)) > 0) {
+            if ((count = moveHandle(position, m_selectedEdgeHandles, m_selectedEdgeHandleIndex, m_unselectedEdgeHandles, m_unselectedEdgeHandleIndex)) > 0) {
                 assert(m_selectedEdgeCount >= count);
                 m_selectedEdgeCount -= count;
                 m_renderStateValid = false;
@@ -427,10 +426,10 @@ namespace TrenchBroom {
         
         void VertexHandleManager::toggleEdgeHandle(const Vec3& position) {
             size_t count = 0;
-            if ((count = moveHandle(position, m_unselectedEdgeHandles, m_selectedEdgeHandles)) > 0) {
+            if ((count = moveHandle(position, m_unselectedEdgeHandles, m_unselectedEdgeHandleIndex, m_selectedEdgeHandles, m_selectedEdgeHandleIndex)) > 0) {
                 m_selectedEdgeCount += count;
                 m_renderStateValid = false;
-            } else if ((count = moveHandle(position, m_selectedEdgeHandles, m_unselectedEdgeHandles)) > 0) {
+            } else if ((count = moveHandle(position, m_selectedEdgeHandles, m_selectedEdgeHandleIndex, m_unselectedEdgeHandles, m_unselectedEdgeHandleIndex)) > 0) {
                 assert(m_selectedEdgeCount >= count);
                 m_selectedEdgeCount -= count;
                 m_renderStateValid = false;
@@ -446,14 +445,7 @@ namespace TrenchBroom {
         }
         
         void VertexHandleManager::deselectAllEdgeHandles() {
-            Model::VertexToEdgesMap::const_iterator eIt, eEnd;
-            for (eIt = m_selectedEdgeHandles.begin(), eEnd = m_selectedEdgeHandles.end(); eIt != eEnd; ++eIt) {
-                const Vec3& position = eIt->first;
-                const Model::BrushEdgeSet& selectedEdges = eIt->second;
-                Model::BrushEdgeSet& unselectedEdges = m_unselectedEdgeHandles[position];
-                unselectedEdges.insert(selectedEdges.begin(), selectedEdges.end());
-            }
-            m_selectedEdgeHandles.clear();
+            moveAllHandles(m_selectedEdgeHandles, m_selectedEdgeHandleIndex, m_unselectedEdgeHandles, m_unselectedEdgeHandleIndex);
             m_selectedEdgeCount = 0;
             m_renderStateValid = false;
         }
@@ -466,7 +458,7 @@ namespace TrenchBroom {
 
         void VertexHandleManager::selectFaceHandle(const Vec3& position) {
             size_t count = 0;
-            if ((count = moveHandle(position, m_unselectedFaceHandles, m_selectedFaceHandles)) > 0) {
+            if ((count = moveHandle(position, m_unselectedFaceHandles, m_unselectedFaceHandleIndex, m_selectedFaceHandles, m_selectedFaceHandleIndex)) > 0) {
                 m_selectedFaceCount += count;
                 m_renderStateValid = false;
             }
@@ -474,7 +466,7 @@ namespace TrenchBroom {
         
         void VertexHandleManager::deselectFaceHandle(const Vec3& position) {
             size_t count = 0;
-            if ((count = moveHandle(position, m_selectedFaceHandles, m_unselectedFaceHandles)) > 0) {
+            if ((count = moveHandle(position, m_selectedFaceHandles, m_selectedFaceHandleIndex, m_unselectedFaceHandles, m_unselectedFaceHandleIndex)) > 0) {
                 assert(m_selectedFaceCount >= count);
                 m_selectedFaceCount -= count;
                 m_renderStateValid = false;
@@ -483,10 +475,10 @@ namespace TrenchBroom {
         
         void VertexHandleManager::toggleFaceHandle(const Vec3& position) {
             size_t count = 0;
-            if ((count = moveHandle(position, m_unselectedFaceHandles, m_selectedFaceHandles)) > 0) {
+            if ((count = moveHandle(position, m_unselectedFaceHandles, m_unselectedFaceHandleIndex, m_selectedFaceHandles, m_selectedFaceHandleIndex)) > 0) {
                 m_selectedFaceCount += count;
                 m_renderStateValid = false;
-            } else if ((count = moveHandle(position, m_selectedFaceHandles, m_unselectedFaceHandles)) > 0) {
+            } else if ((count = moveHandle(position, m_selectedFaceHandles, m_selectedFaceHandleIndex, m_unselectedFaceHandles, m_unselectedFaceHandleIndex)) > 0) {
                 assert(m_selectedFaceCount >= count);
                 m_selectedFaceCount -= count;
                 m_renderStateValid = false;
@@ -502,14 +494,7 @@ namespace TrenchBroom {
         }
         
         void VertexHandleManager::deselectAllFaceHandles() {
-            Model::VertexToFacesMap::const_iterator fIt, fEnd;
-            for (fIt = m_selectedFaceHandles.begin(), fEnd = m_selectedFaceHandles.end(); fIt != fEnd; ++fIt) {
-                const Vec3& position = fIt->first;
-                const Model::BrushFaceSet& selectedFaces = fIt->second;
-                Model::BrushFaceSet& unselectedFaces = m_unselectedFaceHandles[position];
-                unselectedFaces.insert(selectedFaces.begin(), selectedFaces.end());
-            }
-            m_selectedFaceHandles.clear();
+            moveAllHandles(m_selectedFaceHandles, m_selectedFaceHandleIndex, m_unselectedFaceHandles, m_unselectedFaceHandleIndex);
             m_selectedFaceCount = 0;
             m_renderStateValid = false;
         }
@@ -567,57 +552,17 @@ namespace TrenchBroom {
         }
 
         void VertexHandleManager::pick(const Ray3& ray, const Renderer::Camera& camera, Model::PickResult& pickResult, bool splitMode) const {
-            Model::VertexToBrushesMap::const_iterator vIt, vEnd;
-            Model::VertexToEdgesMap::const_iterator eIt, eEnd;
-            Model::VertexToFacesMap::const_iterator fIt, fEnd;
-            
-            if ((m_selectedEdgeHandles.empty() && m_selectedFaceHandles.empty()) || splitMode) {
-                for (vIt = m_unselectedVertexHandles.begin(), vEnd = m_unselectedVertexHandles.end(); vIt != vEnd; ++vIt) {
-                    const Vec3& position = vIt->first;
-                    const Model::Hit hit = pickHandle(ray, camera, position, VertexHandleHit);
-                    if (hit.isMatch())
-                        pickResult.addHit(hit);
-                }
-            }
-            
-            for (vIt = m_selectedVertexHandles.begin(), vEnd = m_selectedVertexHandles.end(); vIt != vEnd; ++vIt) {
-                const Vec3& position = vIt->first;
-                const Model::Hit hit = pickHandle(ray, camera, position, VertexHandleHit);
-                if (hit.isMatch())
-                    pickResult.addHit(hit);
-            }
+            if ((m_selectedEdgeHandles.empty() && m_selectedFaceHandles.empty()) || splitMode)
+                pickHandles(ray, camera, m_unselectedVertexHandles, m_unselectedVertexHandleIndex, VertexHandleHit, pickResult);
+            pickHandles(ray, camera, m_selectedVertexHandles, m_selectedVertexHandleIndex, VertexHandleHit, pickResult);
             
-            if (m_selectedVertexHandles.empty() && m_selectedFaceHandles.empty() && !splitMode) {
-                for (eIt = m_unselectedEdgeHandles.begin(), eEnd = m_unselectedEdgeHandles.end(); eIt != eEnd; ++eIt) {
-                    const Vec3& position = eIt->first;
-                    const Model::Hit hit = pickHandle(ray, camera, position, EdgeHandleHit);
-                    if (hit.isMatch())
-                        pickResult.addHit(hit);
-                }
-            }
-            
-            for (eIt = m_selectedEdgeHandles.begin(), eEnd = m_selectedEdgeHandles.end(); eIt != eEnd; ++eIt) {
-                const Vec3& position = eIt->first;
-                const Model::Hit hit = pickHandle(ray, camera, position, EdgeHandleHit);
-                if (hit.isMatch())
-                    pickResult.addHit(hit);
-            }
-            
-            if (m_selectedVertexHandles.empty() && m_selectedEdgeHandles.empty() && !splitMode) {
-                for (fIt = m_unselectedFaceHandles.begin(), fEnd = m_unselectedFaceHandles.end(); fIt != fEnd; ++fIt) {
-                    const Vec3& position = fIt->first;
-                    const Model::Hit hit = pickHandle(ray, camera, position, FaceHandleHit);
-                    if (hit.isMatch())
-                        pickResult.addHit(hit);
-                }
-            }
+            if (m_selectedVertexHandles.empty() && m_selectedFaceHandles.empty() && !splitMode)
+                pickHandles(ray, camera, m_unselectedEdgeHandles, m_unselectedEdgeHandleIndex, EdgeHandleHit, pickResult);
+            pickHandles(ray, camera, m_selectedEdgeHandles, m_selectedEdgeHandleIndex, EdgeHandleHit, pickResult);
             
-            for (fIt = m_selectedFaceHandles.begin(), fEnd = m_selectedFaceHandles.end(); fIt != fEnd; ++fIt) {
-                const Vec3& position = fIt->first;
-                const Model::Hit hit = pickHandle(ray, camera, position, FaceHandleHit);
-                if (hit.isMatch())
-                    pickResult.addHit(hit);
-            }
+            if (m_selectedVertexHandles.empty() && m_selectedEdgeHandles.empty() && !splitMode)
+                pickHandles(ray, camera, m_unselectedFaceHandles, m_unselectedFaceHandleIndex, FaceHandleHit, pickResult);
+            pickHandles(ray, camera, m_selectedFaceHandles, m_selectedFaceHandleIndex, FaceHandleHit, pickResult);
         }
 
         void VertexHandleManager::render(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch, const bool splitMode) {
@@ -749,6 +694,21 @@ namespace TrenchBroom {
             return result;
         }
 
+        template <typename T, typename O>
+        void VertexHandleManager::pickHandles(const Ray3& ray, const Renderer::Camera& camera, const std::map<Vec3, T, O>& handles, PointHandleIndex& index, const Model::Hit::HitType type, Model::PickResult& pickResult) const {
+            if (!index.valid())
+                index.build(handles);
+            
+            const PointHandleIndex::List candidates = index.findHandles(ray, camera, pref(Preferences::HandleRadius));
+            PointHandleIndex::List::const_iterator it, end;
+            for (it = candidates.begin(), end = candidates.end(); it != end; ++it) {
+                const Vec3& position = **it;
+                const Model::Hit hit = pickHandle(ray, camera, position, type);
+                if (hit.isMatch())
+                    pickResult.addHit(hit);
+            }
+        }
+        
         Model::Hit VertexHandleManager::pickHandle(const Ray3& ray, const Renderer::Camera& camera, const Vec3& position, Model::Hit::HitType type) const {
             const FloatType distance = camera.pickPointHandle(ray, position, pref(Preferences::HandleRadius));
             if (!Math::isnan(distance)) {
@@ -27,6 +27,7 @@
 #include "Model/ModelTypes.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/PointGuideRenderer.h"
+#include "View/PointHandleIndex.h"
 #include "View/ViewTypes.h"
 
 #include <map>
@@ -56,6 +57,14 @@ namespace TrenchBroom {
             Model::VertexToFacesMap m_unselectedFaceHandles;
             Model::VertexToFacesMap m_selectedFaceHandles;
             
+            // built on demand when picking and then kept up to date as handles are added and removed
+            mutable PointHandleIndex m_unselectedVertexHandleIndex;
+            mutable PointHandleIndex m_selectedVertexHandleIndex;
+            mutable PointHandleIndex m_unselectedEdgeHandleIndex;
+            mutable PointHandleIndex m_selectedEdgeHandleIndex;
+            mutable PointHandleIndex m_unselectedFaceHandleIndex;
+            mutable PointHandleIndex m_selectedFaceHandleIndex;
+            
             size_t m_totalVertexCount;
             size_t m_selectedVertexCount;
             size_t m_totalEdgeCount;
@@ -164,7 +173,23 @@ namespace TrenchBroom {
             void renderGuide(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch, const Vec3& position);
         private:
             template <typename Element>
-            inline bool removeHandle(const Vec3& position, Element* element, std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& map) {
+            inline std::set<Element*>& findOrInsertHandle(const Vec3& position, std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& map, PointHandleIndex& index) {
+                typedef std::set<Element*> Set;
+                typedef std::map<Vec3, Set, Vec3::LexicographicOrder> Map;
+                
+                const std::pair<typename Map::iterator, bool> result = map.insert(std::make_pair(position, Set()));
+                if (result.second)
+                    index.addHandle(&result.first->first);
+                return result.first->second;
+            }
+            
+            template <typename Element>
+            inline void addHandle(const Vec3& position, Element* element, std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& map, PointHandleIndex& index) {
+                findOrInsertHandle(position, map, index).insert(element);
+            }
+            
+            template <typename Element>
+            inline bool removeHandle(const Vec3& position, Element* element, std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& map, PointHandleIndex& index) {
                 typedef std::set<Element*> Set;
                 typedef std::map<Vec3, Set, Vec3::LexicographicOrder> Map;
                 
@@ -178,13 +203,15 @@ namespace TrenchBroom {
                     return false;
                 
                 elements.erase(setIt);
-                if (elements.empty())
+                if (elements.empty()) {
+                    index.removeHandle(&mapIt->first);
                     map.erase(mapIt);
+                }
                 return true;
             }
             
             template <typename Element>
-            inline size_t moveHandle(const Vec3& position, std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& from, std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& to) {
+            inline size_t moveHandle(const Vec3& position, std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& from, PointHandleIndex& fromIndex, std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& to, PointHandleIndex& toIndex) {
                 typedef std::set<Element*> Set;
                 typedef std::map<Vec3, Set, Vec3::LexicographicOrder> Map;
                 
@@ -193,13 +220,31 @@ namespace TrenchBroom {
                     return 0;
                 
                 Set& fromElements = mapIt->second;
-                Set& toElements = to[position];
+                Set& toElements = findOrInsertHandle(position, to, toIndex);
                 const size_t elementCount = fromElements.size();
                 toElements.insert(fromElements.begin(), fromElements.end());
                 
+                fromIndex.removeHandle(&mapIt->first);
                 from.erase(mapIt);
                 return elementCount;
             }
+            
+            template <typename Element>
+            inline void moveAllHandles(std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& from, PointHandleIndex& fromIndex, std::map<Vec3, std::set<Element*>, Vec3::LexicographicOrder >& to, PointHandleIndex& toIndex) {
+                typedef std::set<Element*> Set;
+                typedef std::map<Vec3, Set, Vec3::LexicographicOrder> Map;
+                
+                typename Map::const_iterator it, end;
+                for (it = from.begin(), end = from.end(); it != end; ++it) {
+                    const Vec3& position = it->first;
+                    const Set& fromElements = it->second;
+                    Set& toElements = findOrInsertHandle(position, to, toIndex);
+                    toElements.insert(fromElements.begin(), fromElements.end());
+                }
+                
+                fromIndex.invalidate();
+                from.clear();
+            }
 
             template <typename T, typename O>
             void handlePositions(const std::map<Vec3, T, O>& handles, Vec3::List& result) const {
@@ -216,7 +261,10 @@ namespace TrenchBroom {
             Vec3::List findEdgeHandlePositions(const Model::BrushSet& brushes, const Vec3& query, FloatType maxDistance);
             Vec3::List findFaceHandlePositions(const Model::BrushSet& brushes, const Vec3& query, FloatType maxDistance);
             
+            template <typename T, typename O>
+            void pickHandles(const Ray3& ray, const Renderer::Camera& camera, const std::map<Vec3, T, O>& handles, PointHandleIndex& index, Model::Hit::HitType type, Model::PickResult& pickResult) const;
             Model::Hit pickHandle(const Ray3& ray, const Renderer::Camera& camera, const Vec3& position, Model::Hit::HitType type) const;
+            
             void validateRenderState(bool splitMode);
         };
     }
@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Allocator.h"
+#include "ThreadPool.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    class AllocatedObject : public Allocator<AllocatedObject, 16> {
+    public:
+        size_t value;
+        char padding[24];
+        
+        AllocatedObject(const size_t i_value) :
+        value(i_value) {}
+    };
+    
+    typedef std::vector<AllocatedObject*> AllocatedObjectList;
+    
+    class AllocateObjectsTask : public ThreadPool::Task {
+    private:
+        size_t m_first;
+        size_t m_count;
+        AllocatedObjectList m_objects;
+    public:
+        AllocateObjectsTask(const size_t first, const size_t count) :
+        m_first(first),
+        m_count(count) {}
+        
+        const AllocatedObjectList& objects() const {
+            return m_objects;
+        }
+    private:
+        void doRun() {
+            for (size_t i = 0; i < m_count; ++i) {
+                m_objects.push_back(new AllocatedObject(m_first + i));
+                // free some of the objects right away to exercise the thread's cache
+                if (i % 3 == 0) {
+                    delete m_objects.back();
+                    m_objects.pop_back();
+                }
+            }
+        }
+    };
+    
+    TEST(AllocatorTest, allocateAndFree) {
+        AllocatedObjectList objects;
+        for (size_t i = 0; i < 1000; ++i)
+            objects.push_back(new AllocatedObject(i));
+        for (size_t i = 0; i < objects.size(); ++i)
+            ASSERT_EQ(i, objects[i]->value);
+        
+        for (size_t i = 0; i < objects.size(); i += 2)
+            delete objects[i];
+        for (size_t i = 0; i < objects.size(); i += 2)
+            objects[i] = new AllocatedObject(i);
+        for (size_t i = 0; i < objects.size(); ++i)
+            ASSERT_EQ(i, objects[i]->value);
+        
+        for (size_t i = 0; i < objects.size(); ++i)
+            delete objects[i];
+    }
+    
+    TEST(AllocatorTest, freeOnOtherThread) {
+        std::vector<AllocateObjectsTask*> tasks;
+        ThreadPool::TaskList taskList;
+        for (size_t i = 0; i < 8; ++i) {
+            tasks.push_back(new AllocateObjectsTask(i * 1000, 1000));
+            taskList.push_back(tasks.back());
+        }
+        
+        {
+            ThreadPool pool(4);
+            pool.run(taskList);
+        }
+        
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            const AllocatedObjectList& objects = tasks[i]->objects();
+            for (size_t j = 0; j < objects.size(); ++j) {
+                ASSERT_EQ(i * 1000 + (j / 2) * 3 + 1 + j % 2, objects[j]->value);
+                delete objects[j];
+            }
+            delete tasks[i];
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "Exceptions.h"
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelManager.h"
+#include "IO/EntityModelLoader.h"
+#include "IO/Path.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        class TestEntityModel : public EntityModel {
+        private:
+            Renderer::TexturedIndexRangeRenderer* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const {
+                return NULL;
+            }
+            
+            BBox3f doGetBounds(const size_t skinIndex, const size_t frameIndex) const {
+                return BBox3f(8.0f);
+            }
+            
+            BBox3f doGetTransformedBounds(const size_t skinIndex, const size_t frameIndex, const Mat4x4f& transformation) const {
+                return BBox3f(8.0f);
+            }
+            
+            void doPrepare(int minFilter, int magFilter) {}
+            void doSetTextureMode(int minFilter, int magFilter) {}
+        };
+        
+        class MockEntityModelLoader : public IO::EntityModelLoader {
+        private:
+            EntityModel* doLoadEntityModel(const IO::Path& path) const {
+                return mockLoadEntityModel(path);
+            }
+        public:
+            MOCK_CONST_METHOD1(mockLoadEntityModel, EntityModel*(const IO::Path&));
+        };
+        
+        TEST(EntityModelManagerTest, loadModelOnce) {
+            using namespace testing;
+            
+            MockEntityModelLoader loader;
+            EntityModelManager manager(NULL, 1, 2);
+            manager.setLoader(&loader);
+            
+            const IO::Path path("progs/player.mdl");
+            EntityModel* model = new TestEntityModel();
+            EXPECT_CALL(loader, mockLoadEntityModel(path)).WillOnce(Return(model));
+            
+            // the model is not available until it has been loaded and committed
+            ASSERT_TRUE(manager.model(path) == NULL);
+            ASSERT_TRUE(manager.model(path) == NULL);
+            ASSERT_TRUE(manager.hasPendingModels());
+            
+            manager.waitUntilLoaded();
+            ASSERT_TRUE(manager.model(path) == NULL);
+            ASSERT_TRUE(manager.commitLoadedModels());
+            ASSERT_EQ(model, manager.model(path));
+            ASSERT_FALSE(manager.commitLoadedModels());
+        }
+        
+        TEST(EntityModelManagerTest, loadMissingModel) {
+            using namespace testing;
+            
+            MockEntityModelLoader loader;
+            EntityModelManager manager(NULL, 1, 2);
+            manager.setLoader(&loader);
+            
+            const IO::Path path("progs/missing.mdl");
+            EXPECT_CALL(loader, mockLoadEntityModel(path)).WillOnce(Throw(GameException("Cannot load model")));
+            
+            ASSERT_TRUE(manager.model(path) == NULL);
+            manager.waitUntilLoaded();
+            ASSERT_FALSE(manager.commitLoadedModels());
+            ASSERT_FALSE(manager.hasPendingModels());
+            
+            // failed models are not loaded again
+            ASSERT_TRUE(manager.model(path) == NULL);
+            ASSERT_FALSE(manager.hasPendingModels());
+        }
+        
+        TEST(EntityModelManagerTest, clearWhileLoading) {
+            using namespace testing;
+            
+            MockEntityModelLoader loader;
+            EntityModelManager manager(NULL, 1, 2);
+            manager.setLoader(&loader);
+            
+            EXPECT_CALL(loader, mockLoadEntityModel(_)).WillRepeatedly(ReturnNew<TestEntityModel>());
+            
+            for (size_t i = 0; i < 32; ++i) {
+                StringStream name;
+                name << "progs/model" << i << ".mdl";
+                manager.model(IO::Path(name.str()));
+            }
+            
+            manager.clear();
+            ASSERT_FALSE(manager.hasPendingModels());
+            ASSERT_FALSE(manager.commitLoadedModels());
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "ByteBuffer.h"
+#include "Color.h"
+#include "Assets/Palette.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/Path.h"
+#include "IO/Wad.h"
+
+#include <fstream>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace Assets {
+        // the per pixel implementation that the palette used before the average color was computed from a histogram
+        static void referenceIndexedToRgb(const Buffer<unsigned char>& paletteData, const char* indexedImage, const size_t pixelCount, Buffer<unsigned char>& rgbImage, Color& averageColor) {
+            double avg[3];
+            avg[0] = avg[1] = avg[2] = 0.0;
+            for (size_t i = 0; i < pixelCount; ++i) {
+                const size_t index = static_cast<size_t>(static_cast<unsigned char>(indexedImage[i]));
+                for (size_t j = 0; j < 3; ++j) {
+                    const unsigned char c = paletteData[index * 3 + j];
+                    rgbImage[i * 3 + j] = c;
+                    avg[j] += static_cast<double>(c);
+                }
+            }
+            
+            for (size_t i = 0; i < 3; ++i)
+                averageColor[i] = static_cast<float>(avg[i] / pixelCount / 0xFF);
+            averageColor[3] = 1.0f;
+        }
+        
+        static Buffer<unsigned char> readPaletteData(const IO::Path& path) {
+            std::ifstream stream(path.asString().c_str(), std::ios::binary | std::ios::in);
+            const std::vector<char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            
+            Buffer<unsigned char> result(data.size());
+            for (size_t i = 0; i < data.size(); ++i)
+                result[i] = static_cast<unsigned char>(data[i]);
+            return result;
+        }
+        
+        static void assertIndexedToRgbMatchesReference(const Palette& palette, const Buffer<unsigned char>& paletteData, const char* indexedImage, const size_t pixelCount) {
+            Buffer<unsigned char> expectedImage(3 * pixelCount);
+            Color expectedColor;
+            referenceIndexedToRgb(paletteData, indexedImage, pixelCount, expectedImage, expectedColor);
+            
+            Buffer<unsigned char> actualImage(3 * pixelCount);
+            Color actualColor;
+            palette.indexedToRgb(indexedImage, pixelCount, actualImage, actualColor);
+            
+            for (size_t i = 0; i < 3 * pixelCount; ++i)
+                ASSERT_EQ(expectedImage[i], actualImage[i]);
+            for (size_t i = 0; i < 4; ++i)
+                ASSERT_EQ(expectedColor[i], actualColor[i]);
+        }
+        
+        TEST(PaletteTest, indexedToRgbMatchesReferenceForAllIndices) {
+            const IO::Path palettePath = IO::Disk::getCurrentWorkingDir() + IO::Path("data/palette.lmp");
+            const Palette palette(palettePath);
+            const Buffer<unsigned char> paletteData = readPaletteData(palettePath);
+            
+            std::vector<char> indices;
+            for (size_t i = 0; i < 1000; ++i)
+                indices.push_back(static_cast<char>((i * 7) % 256));
+            assertIndexedToRgbMatchesReference(palette, paletteData, &indices.front(), indices.size());
+        }
+        
+        TEST(PaletteTest, indexedToRgbMatchesReferenceForAllLengths) {
+            const IO::Path palettePath = IO::Disk::getCurrentWorkingDir() + IO::Path("data/palette.lmp");
+            const Palette palette(palettePath);
+            const Buffer<unsigned char> paletteData = readPaletteData(palettePath);
+            
+            // the pixels are converted in groups of sixteen with the remainder converted one by one
+            std::vector<char> indices;
+            for (size_t i = 0; i < 48; ++i)
+                indices.push_back(static_cast<char>((i * 37) % 256));
+            for (size_t pixelCount = 1; pixelCount <= indices.size(); ++pixelCount)
+                assertIndexedToRgbMatchesReference(palette, paletteData, &indices.front(), pixelCount);
+        }
+        
+        TEST(PaletteTest, indexedToRgbMatchesReferenceForWadTextures) {
+            const IO::Path palettePath = IO::Disk::getCurrentWorkingDir() + IO::Path("data/palette.lmp");
+            const Palette palette(palettePath);
+            const Buffer<unsigned char> paletteData = readPaletteData(palettePath);
+            
+            const IO::Wad wad(IO::Disk::getCurrentWorkingDir() + IO::Path("data/IO/Wad/cr8_czg.wad"));
+            const IO::WadEntryList entries = wad.entriesWithType(IO::WadEntryType::WEMip);
+            ASSERT_FALSE(entries.empty());
+            
+            IO::WadEntryList::const_iterator it, end;
+            for (it = entries.begin(), end = entries.end(); it != end; ++it) {
+                const IO::WadEntry& entry = *it;
+                for (size_t i = 0; i < 4; ++i) {
+                    const IO::MipData mipData = wad.mipData(entry, i);
+                    const size_t pixelCount = static_cast<size_t>(std::distance(mipData.begin, mipData.end));
+                    assertIndexedToRgbMatchesReference(palette, paletteData, mipData.begin, pixelCount);
+                }
+            }
+        }
+    }
+}
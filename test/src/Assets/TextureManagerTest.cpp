@@ -154,6 +154,29 @@ namespace TrenchBroom {
             ASSERT_TRUE(textureManager.collections().empty());
         }
         
+        TEST(TextureManagerTest, clearBuiltinTextureCollections) {
+            using namespace testing;
+            
+            MockTextureLoader loader;
+            TextureManager textureManager(NULL, 1, 2);
+            textureManager.setLoader(&loader);
+            
+            bool deleted = false;
+            TextureCollection* collection = new TestTextureCollection("coll1.wad", TextureList(), deleted);
+            EXPECT_CALL(loader, mockLoadTextureCollection(_)).WillOnce(Return(collection));
+            
+            textureManager.setBuiltinTextureCollections(IO::Path::List(1, IO::Path("textures/coll1.wad")));
+            ASSERT_TRUE(textureManager.hasPendingChanges());
+            
+            textureManager.setBuiltinTextureCollections(IO::Path::List());
+            ASSERT_TRUE(textureManager.collections().empty());
+            ASSERT_FALSE(deleted);
+            
+            textureManager.commitChanges();
+            ASSERT_TRUE(deleted);
+            ASSERT_FALSE(textureManager.hasPendingChanges());
+        }
+        
         TEST(TextureManagerTest, texture) {
             using namespace testing;
             InSequence forceInSequenceMockCalls;
@@ -183,6 +183,21 @@ TEST(BBoxTest, intersectsBBox) {
     ASSERT_FALSE(bounds1.intersects(bounds5));
 }
 
+TEST(BBoxTest, intersectsPlanes) {
+    // a frustum with its apex at the origin which looks along the positive X axis
+    Plane3f::List frustum;
+    frustum.push_back(Plane3f(Vec3f::Null, Vec3f(-1.0f,  1.0f,  0.0f).normalized()));
+    frustum.push_back(Plane3f(Vec3f::Null, Vec3f(-1.0f, -1.0f,  0.0f).normalized()));
+    frustum.push_back(Plane3f(Vec3f::Null, Vec3f(-1.0f,  0.0f,  1.0f).normalized()));
+    frustum.push_back(Plane3f(Vec3f::Null, Vec3f(-1.0f,  0.0f, -1.0f).normalized()));
+    
+    ASSERT_TRUE(BBox3f(Vec3f(10.0f, -1.0f, -1.0f), Vec3f(12.0f, 1.0f, 1.0f)).intersects(frustum));
+    ASSERT_TRUE(BBox3f(Vec3f(10.0f,  9.0f, -1.0f), Vec3f(12.0f, 11.0f, 1.0f)).intersects(frustum));
+    ASSERT_FALSE(BBox3f(Vec3f(10.0f, 13.0f, -1.0f), Vec3f(12.0f, 15.0f, 1.0f)).intersects(frustum));
+    ASSERT_FALSE(BBox3f(Vec3f(-12.0f, -1.0f, -1.0f), Vec3f(-10.0f, 1.0f, 1.0f)).intersects(frustum));
+    ASSERT_TRUE(BBox3f(Vec3f(-1.0f, -1.0f, -1.0f), Vec3f(1.0f, 1.0f, 1.0f)).intersects(frustum));
+}
+
 TEST(BBoxTest, intersectWithRay) {
     const BBox3f bounds(Vec3f(-12.0f, -3.0f,  4.0f), Vec3f(  8.0f,  9.0f,  8.0f));
     Vec3f normal;
@@ -22,12 +22,15 @@
 #include "StringUtils.h"
 #include "IO/NodeWriter.h"
 #include "Model/Brush.h"
+#include "Model/BrushFace.h"
 #include "Model/BrushBuilder.h"
 #include "Model/Group.h"
 #include "Model/Layer.h"
 #include "Model/MapFormat.h"
 #include "Model/World.h"
 
+#include <cstdio>
+
 namespace TrenchBroom {
     namespace IO {
         TEST(NodeWriterTest, writeEmptyMap) {
@@ -91,6 +94,52 @@ namespace TrenchBroom {
                          "}\n", result.c_str());
         }
         
+        TEST(NodeWriterTest, writeMapToFile) {
+            const BBox3 worldBounds(8192.0);
+            
+            Model::World map(Model::MapFormat::Quake2, NULL, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+            
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::Brush* brush = builder.createCube(64.0, "none");
+            map.defaultLayer()->addChild(brush);
+            
+            Model::BrushFace* face = brush->faces().front();
+            face->setXOffset(0.1f);
+            face->setRotation(22.5f);
+            face->setXScale(-1.25f);
+            face->setSurfaceContents(1);
+            face->setSurfaceFlags(-3);
+            face->setSurfaceValue(1234567.0f);
+            
+            FILE* file = std::tmpfile();
+            ASSERT_TRUE(file != NULL);
+            {
+                NodeWriter writer(&map, file);
+                writer.writeMap();
+            }
+            
+            std::rewind(file);
+            String result;
+            char buffer[256];
+            size_t count;
+            while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+                result.append(buffer, count);
+            std::fclose(file);
+            
+            ASSERT_STREQ("{\n"
+                         "\"classname\" \"worldspawn\"\n"
+                         "{\n"
+                         "( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) none 0.1 0 22.5 -1.25 1 1 -3 1.23457e+06\n"
+                         "( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) none 0 0 0 1 1 0 0 0\n"
+                         "( -32 -32 -32 ) ( -32 -32 -31 ) ( -31 -32 -32 ) none 0 0 0 1 1 0 0 0\n"
+                         "( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) none 0 0 0 1 1 0 0 0\n"
+                         "( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) none 0 0 0 1 1 0 0 0\n"
+                         "( -32 -32 -32 ) ( -31 -32 -32 ) ( -32 -31 -32 ) none 0 0 0 1 1 0 0 0\n"
+                         "}\n"
+                         "}\n", result.c_str());
+        }
+        
         TEST(NodeWriterTest, writeWorldspawnWithBrushInCustomLayer) {
             const BBox3 worldBounds(8192.0);
             
@@ -25,9 +25,21 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace TrenchBroom {
     namespace IO {
+        static void writeInt(std::vector<char>& buffer, const size_t offset, const int32_t value) {
+            std::memcpy(&buffer[offset], &value, sizeof(int32_t));
+        }
+        
+        static void writeEntry(std::vector<char>& buffer, const size_t index, const String& name, const int32_t address, const int32_t length) {
+            const size_t offset = 12 + index * 0x40;
+            std::memcpy(&buffer[offset], name.c_str(), name.size());
+            writeInt(buffer, offset + 0x38, address);
+            writeInt(buffer, offset + 0x3C, length);
+        }
+        
         TEST(PakFileSystemTest, directoryExists) {
             const Path pakPath = Disk::getCurrentWorkingDir() + Path("data/IO/Pak/pak3.pak");
             const MappedFile::Ptr pakFile = Disk::openFile(pakPath);
@@ -148,5 +160,45 @@ namespace TrenchBroom {
             
             ASSERT_TRUE(fs.openFile(Path("amnet.cfg")) != NULL);
         }
+
+        TEST(PakFileSystemTest, duplicateAndNestedEntries) {
+            // header, four directory entries and the contents "abcd"
+            std::vector<char> buffer(12 + 4 * 0x40 + 4, 0);
+            std::memcpy(&buffer[0], "PACK", 4);
+            writeInt(buffer, 4, 12);
+            writeInt(buffer, 8, 4 * 0x40);
+            writeEntry(buffer, 0, "Maps/Start.bsp", 12 + 4 * 0x40, 1);
+            writeEntry(buffer, 1, "progs/player.mdl", 12 + 4 * 0x40 + 1, 1);
+            writeEntry(buffer, 2, "progs/h_player/head.mdl", 12 + 4 * 0x40 + 2, 1);
+            writeEntry(buffer, 3, "maps/start.bsp", 12 + 4 * 0x40 + 3, 1);
+            std::memcpy(&buffer[12 + 4 * 0x40], "abcd", 4);
+            
+            const MappedFile::Ptr pakFile(new MappedFileView(&buffer.front(), &buffer.front() + buffer.size()));
+            const PakFileSystem fs(Path("test.pak"), pakFile);
+            
+            ASSERT_TRUE(fs.directoryExists(Path("")));
+            ASSERT_TRUE(fs.directoryExists(Path("PROGS/h_player")));
+            ASSERT_FALSE(fs.directoryExists(Path("progs/player.mdl")));
+            ASSERT_FALSE(fs.fileExists(Path("progs")));
+            ASSERT_TRUE(fs.fileExists(Path("progs/H_Player/head.mdl")));
+            
+            const Path::List rootItems = fs.getDirectoryContents(Path(""));
+            ASSERT_EQ(2u, rootItems.size());
+            ASSERT_EQ(Path("maps"), rootItems[0]);
+            ASSERT_EQ(Path("progs"), rootItems[1]);
+            
+            const Path::List progsItems = fs.getDirectoryContents(Path("Progs"));
+            ASSERT_EQ(2u, progsItems.size());
+            ASSERT_EQ(Path("h_player"), progsItems[0]);
+            ASSERT_EQ(Path("player.mdl"), progsItems[1]);
+            
+            // the later entry replaces the earlier one
+            const MappedFile::Ptr map = fs.openFile(Path("maps/start.bsp"));
+            ASSERT_EQ(1u, map->size());
+            ASSERT_EQ('d', *map->begin());
+            
+            const MappedFile::Ptr head = fs.openFile(Path("progs/h_player/head.mdl"));
+            ASSERT_EQ('c', *head->begin());
+        }
     }
 }
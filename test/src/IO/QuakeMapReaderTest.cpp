@@ -545,6 +545,111 @@ namespace TrenchBroom {
             ASSERT_EQ(1u, mySubGroup->childCount());
         }
 
+        static void assertEqualNodes(const Model::Node* expected, const Model::Node* actual) {
+            ASSERT_EQ(expected->name(), actual->name());
+            ASSERT_EQ(expected->lineNumber(), actual->lineNumber());
+            ASSERT_EQ(expected->childCount(), actual->childCount());
+            
+            const Model::Brush* expectedBrush = dynamic_cast<const Model::Brush*>(expected);
+            if (expectedBrush != NULL) {
+                const Model::Brush* actualBrush = dynamic_cast<const Model::Brush*>(actual);
+                ASSERT_TRUE(actualBrush != NULL);
+                ASSERT_EQ(expectedBrush->bounds(), actualBrush->bounds());
+                
+                const Model::BrushFaceList& expectedFaces = expectedBrush->faces();
+                const Model::BrushFaceList& actualFaces = actualBrush->faces();
+                ASSERT_EQ(expectedFaces.size(), actualFaces.size());
+                for (size_t i = 0; i < expectedFaces.size(); ++i) {
+                    for (size_t j = 0; j < 3; ++j)
+                        ASSERT_EQ(expectedFaces[i]->points()[j], actualFaces[i]->points()[j]);
+                    ASSERT_EQ(expectedFaces[i]->textureName(), actualFaces[i]->textureName());
+                    ASSERT_EQ(expectedFaces[i]->attribs().xOffset(), actualFaces[i]->attribs().xOffset());
+                }
+            }
+            
+            const Model::NodeList& expectedChildren = expected->children();
+            const Model::NodeList& actualChildren = actual->children();
+            for (size_t i = 0; i < expectedChildren.size(); ++i)
+                assertEqualNodes(expectedChildren[i], actualChildren[i]);
+        }
+        
+        static String makeCube(const int x, const String& textureName) {
+            StringStream str;
+            str << "{\n";
+            str << "( " << x     << " 0 0 ) ( " << x     << " 1 0 ) ( " << x     << " 0 1 ) " << textureName << " 1 0 0 1 1\n";
+            str << "( " << x + 8 << " 0 0 ) ( " << x + 8 << " 0 1 ) ( " << x + 8 << " 1 0 ) " << textureName << " 2 0 0 1 1\n";
+            str << "( " << x     << " 0 0 ) ( " << x     << " 0 1 ) ( " << x + 1 << " 0 0 ) " << textureName << " 3 0 0 1 1\n";
+            str << "( " << x     << " 8 0 ) ( " << x + 1 << " 8 0 ) ( " << x     << " 8 1 ) " << textureName << " 4 0 0 1 1\n";
+            str << "( " << x     << " 0 0 ) ( " << x + 1 << " 0 0 ) ( " << x     << " 1 0 ) " << textureName << " 5 0 0 1 1\n";
+            str << "( " << x     << " 0 8 ) ( " << x     << " 1 8 ) ( " << x + 1 << " 0 8 ) " << textureName << " 6 0 0 1 1\n";
+            str << "}\n";
+            return str.str();
+        }
+        
+        TEST(WorldReaderTest, parseBrushesInParallel) {
+            StringStream str;
+            str << "// Game: Quake\n";
+            str << "{\n";
+            str << "\"classname\" \"worldspawn\"\n";
+            for (int i = 0; i < 40; ++i)
+                str << makeCube(i * 16, i % 2 == 0 ? "{fence" : "wall");
+            // an empty brush which is skipped
+            str << "{\n";
+            str << "( 0 0 0 ) ( 0 0 1 ) ( 0 1 0 ) wall 0 0 0 1 1\n";
+            str << "( 64 0 0 ) ( 64 1 0 ) ( 64 0 1 ) wall 0 0 0 1 1\n";
+            str << "}\n";
+            str << "}\n";
+            str << "{\n";
+            str << "\"classname\" \"func_group\"\n";
+            str << "\"_tb_type\" \"_tb_layer\"\n";
+            str << "\"_tb_name\" \"My Layer\"\n";
+            str << "\"_tb_id\" \"1\"\n";
+            for (int i = 0; i < 10; ++i)
+                str << makeCube(i * 16, "layer");
+            str << "}\n";
+            str << "{\n";
+            str << "\"classname\" \"func_door\"\n";
+            str << "\"_tb_layer\" \"1\"\n";
+            str << makeCube(0, "door");
+            str << "\"message\" \"multi\nline\"\n";
+            str << makeCube(16, "door");
+            str << "}\n";
+            const String data = str.str();
+            BBox3 worldBounds(8192);
+            
+            WorldReader serialReader(data, NULL);
+            const Model::World* expected = serialReader.read(Model::MapFormat::Standard, worldBounds);
+            
+            WorldReader parallelReader(data, NULL);
+            parallelReader.setThreadCount(4);
+            const Model::World* actual = parallelReader.read(Model::MapFormat::Standard, worldBounds);
+            
+            ASSERT_EQ(2u, actual->childCount());
+            ASSERT_EQ(40u, actual->children().front()->childCount());
+            assertEqualNodes(expected, actual);
+            
+            delete expected;
+            delete actual;
+        }
+        
+        TEST(WorldReaderTest, parseInvalidBrushInParallel) {
+            StringStream str;
+            str << "{\n";
+            str << "\"classname\" \"worldspawn\"\n";
+            for (int i = 0; i < 8; ++i)
+                str << makeCube(i * 16, "wall");
+            str << "{\n";
+            str << "( 0 0 0 ) ( 0 1 0 ) ( 0 0 1 ) wall 1 0 0 1\n";
+            str << "}\n";
+            str << "}\n";
+            const String data = str.str();
+            BBox3 worldBounds(8192);
+            
+            WorldReader reader(data, NULL);
+            reader.setThreadCount(4);
+            ASSERT_THROW(reader.read(Model::MapFormat::Standard, worldBounds), ParserException);
+        }
+
         /*
         TEST(WorldReaderTest, parseIssueIgnoreFlags) {
             const String data("{"
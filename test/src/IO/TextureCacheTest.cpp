@@ -0,0 +1,255 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "ThreadPool.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureCollectionSpec.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/Path.h"
+#include "IO/TextureCache.h"
+#include "IO/Wad.h"
+#include "IO/WadTextureLoader.h"
+
+#include <fstream>
+
+#include <wx/filefn.h>
+
+namespace TrenchBroom {
+    namespace IO {
+        class TextureCacheEnvironment {
+        private:
+            Path m_dir;
+        public:
+            TextureCacheEnvironment() :
+            m_dir(Disk::getCurrentWorkingDir() + Path("texturecachetest")) {
+                deleteEnvironment();
+            }
+            
+            ~TextureCacheEnvironment() {
+                deleteEnvironment();
+            }
+            
+            const Path& dir() const {
+                return m_dir;
+            }
+            
+            size_t fileCount() const {
+                if (!Disk::directoryExists(m_dir))
+                    return 0;
+                return Disk::getDirectoryContents(m_dir).size();
+            }
+        private:
+            void deleteEnvironment() {
+                if (Disk::directoryExists(m_dir)) {
+                    const Path::List contents = Disk::getDirectoryContents(m_dir);
+                    Path::List::const_iterator it, end;
+                    for (it = contents.begin(), end = contents.end(); it != end; ++it)
+                        ::wxRemoveFile((m_dir + *it).asString());
+                    ::wxRmdir(m_dir.asString());
+                }
+            }
+        };
+        
+        static TextureCache::EntryList createEntries() {
+            TextureCache::EntryList entries;
+            for (size_t i = 0; i < 2; ++i) {
+                const size_t size = 16 << i;
+                Assets::TextureBuffer::List buffers(4);
+                Assets::setMipBufferSize(buffers, size, size);
+                for (size_t j = 0; j < buffers.size(); ++j) {
+                    for (size_t k = 0; k < buffers[j].size(); ++k)
+                        buffers[j][k] = static_cast<unsigned char>(i + j + k);
+                }
+                
+                StringStream name;
+                name << "texture" << i;
+                entries.push_back(TextureCache::Entry(name.str(), size, size, Color(0.1f, 0.2f, 0.3f, 1.0f), buffers));
+            }
+            return entries;
+        }
+        
+        static void assertEntriesEqual(const TextureCache::EntryList& expected, const TextureCache::EntryList& actual) {
+            ASSERT_EQ(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_EQ(expected[i].name, actual[i].name);
+                ASSERT_EQ(expected[i].width, actual[i].width);
+                ASSERT_EQ(expected[i].height, actual[i].height);
+                ASSERT_EQ(expected[i].averageColor, actual[i].averageColor);
+                ASSERT_EQ(expected[i].buffers.size(), actual[i].buffers.size());
+                for (size_t j = 0; j < expected[i].buffers.size(); ++j) {
+                    ASSERT_EQ(expected[i].buffers[j].size(), actual[i].buffers[j].size());
+                    for (size_t k = 0; k < expected[i].buffers[j].size(); ++k)
+                        ASSERT_EQ(expected[i].buffers[j][k], actual[i].buffers[j][k]);
+                }
+            }
+        }
+        
+        static void patchCacheFile(const Path& cacheFilePath, const size_t offset, const uint32_t value) {
+            std::fstream stream(cacheFilePath.asString().c_str(), std::ios::in | std::ios::out | std::ios::binary);
+            stream.seekp(static_cast<std::streamoff>(offset));
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(uint32_t));
+        }
+        
+        // magic, version, source path, modification time and palette hash
+        static size_t entryCountOffset(const Path& sourcePath) {
+            return 4 + 4 + 4 + sourcePath.asString().size() + 8 + 8;
+        }
+        
+        TEST(TextureCacheTest, readMissingEntry) {
+            TextureCacheEnvironment env;
+            TextureCache cache(env.dir());
+            
+            const Path sourcePath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            TextureCache::EntryList entries;
+            ASSERT_FALSE(cache.read(sourcePath, 1, entries));
+        }
+        
+        TEST(TextureCacheTest, writeAndRead) {
+            TextureCacheEnvironment env;
+            TextureCache cache(env.dir());
+            
+            const Path sourcePath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            const TextureCache::EntryList expected = createEntries();
+            cache.write(sourcePath, 1, expected);
+            ASSERT_EQ(1u, env.fileCount());
+            
+            TextureCache::EntryList actual;
+            ASSERT_TRUE(cache.read(sourcePath, 1, actual));
+            assertEntriesEqual(expected, actual);
+        }
+        
+        TEST(TextureCacheTest, paletteChangeInvalidatesEntry) {
+            TextureCacheEnvironment env;
+            TextureCache cache(env.dir());
+            
+            const Path sourcePath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            cache.write(sourcePath, 1, createEntries());
+            
+            TextureCache::EntryList entries;
+            ASSERT_FALSE(cache.read(sourcePath, 2, entries));
+            ASSERT_TRUE(entries.empty());
+        }
+        
+        TEST(TextureCacheTest, truncatedFileIsIgnored) {
+            TextureCacheEnvironment env;
+            TextureCache cache(env.dir());
+            
+            const Path sourcePath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            cache.write(sourcePath, 1, createEntries());
+            ASSERT_EQ(1u, env.fileCount());
+            
+            const Path cacheFilePath = env.dir() + Disk::getDirectoryContents(env.dir()).front();
+            {
+                std::ofstream stream(cacheFilePath.asString().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+                stream.write("TBTC", 4);
+            }
+            
+            TextureCache::EntryList entries;
+            ASSERT_FALSE(cache.read(sourcePath, 1, entries));
+        }
+        
+        TEST(TextureCacheTest, corruptEntryCountIsIgnored) {
+            TextureCacheEnvironment env;
+            TextureCache cache(env.dir());
+            
+            const Path sourcePath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            cache.write(sourcePath, 1, createEntries());
+            
+            const Path cacheFilePath = env.dir() + Disk::getDirectoryContents(env.dir()).front();
+            patchCacheFile(cacheFilePath, entryCountOffset(sourcePath), 0xFFFFFFFF);
+            
+            TextureCache::EntryList entries;
+            ASSERT_FALSE(cache.read(sourcePath, 1, entries));
+            ASSERT_TRUE(entries.empty());
+        }
+        
+        TEST(TextureCacheTest, mismatchedMipSizeIsIgnored) {
+            TextureCacheEnvironment env;
+            TextureCache cache(env.dir());
+            
+            const Path sourcePath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            cache.write(sourcePath, 1, createEntries());
+            
+            // the width of the first entry follows the entry count and its name "texture0"
+            const Path cacheFilePath = env.dir() + Disk::getDirectoryContents(env.dir()).front();
+            patchCacheFile(cacheFilePath, entryCountOffset(sourcePath) + 4 + 4 + 8, 32);
+            
+            TextureCache::EntryList entries;
+            ASSERT_FALSE(cache.read(sourcePath, 1, entries));
+            ASSERT_TRUE(entries.empty());
+        }
+        
+        TEST(TextureCacheTest, sizeLimit) {
+            TextureCacheEnvironment env;
+            TextureCache cache(env.dir());
+            
+            const Path sourcePath1 = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            const Path sourcePath2 = Disk::getCurrentWorkingDir() + Path("data/palette.lmp");
+            cache.write(sourcePath1, 1, createEntries());
+            cache.write(sourcePath2, 1, createEntries());
+            ASSERT_EQ(2u, env.fileCount());
+            
+            cache.setSizeLimit(1);
+            ASSERT_EQ(0u, env.fileCount());
+            
+            cache.write(sourcePath1, 1, createEntries());
+            TextureCache::EntryList entries;
+            ASSERT_FALSE(cache.read(sourcePath1, 1, entries));
+        }
+        
+        TEST(TextureCacheTest, loadWadFromCache) {
+            TextureCacheEnvironment env;
+            TextureCache cache(env.dir());
+            
+            const Assets::Palette palette(Disk::getCurrentWorkingDir() + Path("data/palette.lmp"));
+            WadTextureLoader loader(palette, &cache);
+            
+            const Path wadPath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            const Assets::TextureCollectionSpec spec("cr8_czg.wad", wadPath);
+            
+            Assets::TextureCollection* decoded = loader.loadTextureCollection(spec);
+            ThreadPool pool(2);
+            decoded->startLoading(pool);
+            decoded->waitUntilLoaded();
+            delete decoded;
+            ASSERT_EQ(1u, env.fileCount());
+            
+            Assets::TextureCollection* cached = loader.loadTextureCollection(spec);
+            const Assets::TextureList& textures = cached->textures();
+            
+            const Wad wad(wadPath);
+            const WadEntryList entries = wad.entriesWithType(WadEntryType::WEMip);
+            ASSERT_EQ(entries.size(), textures.size());
+            for (size_t i = 0; i < entries.size(); ++i) {
+                Assets::Texture* expected = WadTextureLoader::loadTexture(wad, entries[i], palette);
+                ASSERT_EQ(expected->name(), textures[i]->name());
+                ASSERT_EQ(expected->width(), textures[i]->width());
+                ASSERT_EQ(expected->height(), textures[i]->height());
+                ASSERT_EQ(expected->averageColor(), textures[i]->averageColor());
+                delete expected;
+            }
+            
+            delete cached;
+        }
+    }
+}
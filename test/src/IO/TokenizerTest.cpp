@@ -22,6 +22,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <cstring>
+
 namespace TrenchBroom {
     namespace IO {
         namespace SimpleToken {
@@ -243,5 +246,44 @@ namespace TrenchBroom {
             ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
             ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
         }
+        
+        TEST(TokenizerTest, simpleLanguagePushMultipleTokens) {
+            const String testString("{ a = 1; }");
+            
+            SimpleTokenizer tokenizer(testString);
+            const SimpleTokenizer::Token first = tokenizer.nextToken();
+            const SimpleTokenizer::Token second = tokenizer.nextToken();
+            const SimpleTokenizer::Token third = tokenizer.nextToken();
+            tokenizer.pushToken(third);
+            tokenizer.pushToken(second);
+            tokenizer.pushToken(first);
+            ASSERT_EQ(SimpleToken::OBrace, tokenizer.nextToken().type());
+            ASSERT_EQ(SimpleToken::String, tokenizer.nextToken().type());
+            ASSERT_EQ(SimpleToken::Equals, tokenizer.nextToken().type());
+            ASSERT_EQ(SimpleToken::Integer, tokenizer.nextToken().type());
+        }
+        
+        TEST(TokenizerTest, tokenToFloatMatchesAtof) {
+            const char* numbers[] = { "0", "-0", "+0", "1", "-1", "12328", "-343.38283", ".38283", "-.5", "5.", "0.1", "0.3",
+                                      "-64", "1024.000001", "3.14159265358979", "0.000000000000000000000123",
+                                      "123456789012345678", "1e10", "-2.5e-3", "7.0000000000000001" };
+            
+            for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i) {
+                const char* number = numbers[i];
+                const SimpleTokenizer::Token token(SimpleToken::Decimal, number, number + strlen(number), 0, 1, 1);
+                ASSERT_EQ(std::atof(number), token.toFloat<double>()) << number;
+                ASSERT_EQ(static_cast<float>(std::atof(number)), token.toFloat<float>()) << number;
+            }
+        }
+        
+        TEST(TokenizerTest, tokenToIntegerMatchesAtoi) {
+            const char* numbers[] = { "0", "-0", "+17", "12328", "-12328", "2147483647", "-2147483647" };
+            
+            for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i) {
+                const char* number = numbers[i];
+                const SimpleTokenizer::Token token(SimpleToken::Integer, number, number + strlen(number), 0, 1, 1);
+                ASSERT_EQ(std::atoi(number), token.toInteger<int>()) << number;
+            }
+        }
     }
 }
@@ -18,10 +18,14 @@
  */
 
 #include <gtest/gtest.h>
+#include <gmock/gmock.h>
 
+#include "ThreadPool.h"
+#include "GL/GLMock.h"
 #include "Assets/TextureCollectionSpec.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/Path.h"
+#include "IO/Wad.h"
 #include "IO/WadTextureLoader.h"
 #include "Assets/Palette.h"
 #include "Assets/Texture.h"
@@ -71,5 +75,49 @@ namespace TrenchBroom {
             
             delete collection;
         }
+        
+        static void genTextureIds(const GLsizei count, GLuint* ids) {
+            for (GLsizei i = 0; i < count; ++i)
+                ids[i] = static_cast<GLuint>(i + 1);
+        }
+        
+        TEST(WadTextureLoaderTest, decodeAndPrepareInBackground) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+            ON_CALL(glMock, GenTextures(_,_)).WillByDefault(Invoke(genTextureIds));
+            
+            const Assets::Palette palette(Disk::getCurrentWorkingDir() + Path("data/palette.lmp"));
+            WadTextureLoader loader(palette);
+            
+            const Path wadPath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            const Assets::TextureCollectionSpec spec("cr8_czg.wad", wadPath);
+            Assets::TextureCollection* collection = loader.loadTextureCollection(spec);
+            
+            const Assets::TextureList& textures = collection->textures();
+            ASSERT_EQ(21u, textures.size());
+            for (size_t i = 0; i < textures.size(); ++i)
+                ASSERT_FALSE(textures[i]->isPrepared());
+
+            ThreadPool pool(2);
+            collection->startLoading(pool);
+            collection->waitUntilLoaded();
+            ASSERT_FALSE(collection->prepared());
+            
+            ASSERT_EQ(5u, collection->prepare(1, 2, 5));
+            ASSERT_FALSE(collection->prepared());
+            ASSERT_EQ(16u, collection->prepare(1, 2, 100));
+            ASSERT_TRUE(collection->prepared());
+            
+            const Wad wad(wadPath);
+            const WadEntryList entries = wad.entriesWithType(WadEntryType::WEMip);
+            for (size_t i = 0; i < textures.size(); ++i) {
+                Assets::Texture* expected = WadTextureLoader::loadTexture(wad, entries[i], palette);
+                ASSERT_TRUE(textures[i]->isPrepared());
+                ASSERT_EQ(expected->averageColor(), textures[i]->averageColor());
+                delete expected;
+            }
+            
+            delete collection;
+        }
     }
 }
@@ -0,0 +1,207 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "IO/DiskFileSystem.h"
+#include "IO/MappedFile.h"
+#include "IO/ZipFileSystem.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST(ZipFileSystemTest, directoryExists) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("data/IO/Zip/zip1.zip");
+            const MappedFile::Ptr zipFile = Disk::openFile(zipPath);
+            assert(zipFile != NULL);
+            
+            const ZipFileSystem fs(zipPath, zipFile);
+            ASSERT_THROW(fs.directoryExists(Path("/pics")), FileSystemException);
+            
+            ASSERT_TRUE(fs.directoryExists(Path("")));
+            ASSERT_TRUE(fs.directoryExists(Path("pics")));
+            ASSERT_TRUE(fs.directoryExists(Path("TEXTURES/e1u1")));
+            ASSERT_FALSE(fs.directoryExists(Path("pics/tag1.pcx")));
+            ASSERT_FALSE(fs.directoryExists(Path("maps")));
+        }
+        
+        TEST(ZipFileSystemTest, fileExists) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("data/IO/Zip/zip1.zip");
+            const MappedFile::Ptr zipFile = Disk::openFile(zipPath);
+            assert(zipFile != NULL);
+            
+            const ZipFileSystem fs(zipPath, zipFile);
+            ASSERT_THROW(fs.fileExists(Path("/amnet.cfg")), FileSystemException);
+            
+            ASSERT_TRUE(fs.fileExists(Path("amnet.cfg")));
+            ASSERT_TRUE(fs.fileExists(Path("Pics/Tag1.PCX")));
+            ASSERT_FALSE(fs.fileExists(Path("pics")));
+        }
+        
+        TEST(ZipFileSystemTest, findItemsRecursively) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("data/IO/Zip/zip1.zip");
+            const MappedFile::Ptr zipFile = Disk::openFile(zipPath);
+            assert(zipFile != NULL);
+            
+            const ZipFileSystem fs(zipPath, zipFile);
+            Path::List items = fs.findItems(Path(""));
+            ASSERT_EQ(4u, items.size());
+            ASSERT_TRUE(std::find(items.begin(), items.end(), Path("amnet.cfg")) != items.end());
+            ASSERT_TRUE(std::find(items.begin(), items.end(), Path("bear.cfg")) != items.end());
+            ASSERT_TRUE(std::find(items.begin(), items.end(), Path("pics")) != items.end());
+            ASSERT_TRUE(std::find(items.begin(), items.end(), Path("textures")) != items.end());
+            
+            items = fs.findItemsRecursively(Path(""));
+            ASSERT_EQ(9u, items.size());
+            ASSERT_TRUE(std::find(items.begin(), items.end(), Path("textures/e1u1")) != items.end());
+            ASSERT_TRUE(std::find(items.begin(), items.end(), Path("textures/e1u1/box1_3.wal")) != items.end());
+            ASSERT_TRUE(std::find(items.begin(), items.end(), Path("textures/e1u1/brlava.wal")) != items.end());
+            
+            items = fs.findItemsRecursively(Path("pics"), FileSystem::ExtensionMatcher("pcx"));
+            ASSERT_EQ(2u, items.size());
+            ASSERT_TRUE(std::find(items.begin(), items.end(), Path("pics/tag1.pcx")) != items.end());
+            ASSERT_TRUE(std::find(items.begin(), items.end(), Path("pics/tag2.pcx")) != items.end());
+        }
+        
+        TEST(ZipFileSystemTest, openFile) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("data/IO/Zip/zip1.zip");
+            const MappedFile::Ptr zipFile = Disk::openFile(zipPath);
+            assert(zipFile != NULL);
+            
+            const ZipFileSystem fs(zipPath, zipFile);
+            ASSERT_THROW(fs.openFile(Path("")), FileSystemException);
+            ASSERT_THROW(fs.openFile(Path("pics")), FileSystemException);
+            
+            // stored entries are views onto the archive
+            const MappedFile::Ptr stored = fs.openFile(Path("amnet.cfg"));
+            ASSERT_EQ(String("bind a +attack\n"), String(stored->begin(), stored->end()));
+            ASSERT_TRUE(stored->begin() >= zipFile->begin() && stored->end() <= zipFile->end());
+            ASSERT_EQ(0u, fs.cacheSize());
+            
+            const MappedFile::Ptr deflated = fs.openFile(Path("bear.cfg"));
+            ASSERT_EQ(832u, deflated->size());
+            ASSERT_EQ(String("bind b +jump\n"), String(deflated->begin(), deflated->begin() + 13));
+            ASSERT_EQ(String("bind b +jump\n"), String(deflated->end() - 13, deflated->end()));
+            ASSERT_EQ(832u, fs.cacheSize());
+            
+            const MappedFile::Ptr pcx = fs.openFile(Path("pics/tag1.pcx"));
+            ASSERT_EQ(4096u, pcx->size());
+            for (size_t i = 0; i < pcx->size(); ++i)
+                ASSERT_EQ(static_cast<unsigned char>(i % 256), static_cast<unsigned char>(pcx->begin()[i]));
+            
+            // opening a file again returns the cached data
+            ASSERT_EQ(deflated, fs.openFile(Path("BEAR.CFG")));
+        }
+        
+        TEST(ZipFileSystemTest, evictLeastRecentlyOpenedFiles) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("data/IO/Zip/zip1.zip");
+            const MappedFile::Ptr zipFile = Disk::openFile(zipPath);
+            assert(zipFile != NULL);
+            
+            ZipFileSystem fs(zipPath, zipFile, 1500);
+            const MappedFile::Ptr bear = fs.openFile(Path("bear.cfg"));
+            const MappedFile::Ptr box = fs.openFile(Path("textures/e1u1/box1_3.wal"));
+            ASSERT_EQ(1432u, fs.cacheSize());
+            
+            ASSERT_EQ(bear, fs.openFile(Path("bear.cfg")));
+            
+            // box1_3.wal was opened least recently and is evicted
+            const MappedFile::Ptr lava = fs.openFile(Path("textures/e1u1/brlava.wal"));
+            ASSERT_EQ(1432u, fs.cacheSize());
+            ASSERT_EQ(bear, fs.openFile(Path("bear.cfg")));
+            ASSERT_NE(box, fs.openFile(Path("textures/e1u1/box1_3.wal")));
+            
+            // evicted files remain valid
+            ASSERT_EQ(String("box1_3"), String(box->begin(), box->begin() + 6));
+            
+            fs.setCacheLimit(0);
+            ASSERT_EQ(0u, fs.cacheSize());
+        }
+        
+        TEST(ZipFileSystemTest, preloadFiles) {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("data/IO/Zip/zip1.zip");
+            const MappedFile::Ptr zipFile = Disk::openFile(zipPath);
+            assert(zipFile != NULL);
+            
+            const ZipFileSystem fs(zipPath, zipFile);
+            fs.preloadFiles(fs.findItemsRecursively(Path("")));
+            ASSERT_EQ(832u + 4096u + 600u + 600u, fs.cacheSize());
+            
+            const MappedFile::Ptr lava = fs.openFile(Path("textures/e1u1/brlava.wal"));
+            ASSERT_EQ(String("brlava"), String(lava->end() - 6, lava->end()));
+            ASSERT_EQ(832u + 4096u + 600u + 600u, fs.cacheSize());
+        }
+        
+        static void writeValue(std::vector<char>& buffer, const size_t offset, const size_t value, const size_t size) {
+            for (size_t i = 0; i < size; ++i)
+                buffer[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+        
+        // Creates a zip file with a single entry whose length is given separately from its data.
+        static MappedFile::Ptr createZipFile(const String& name, const String& data, const size_t method, const size_t length) {
+            const size_t localHeader = 0;
+            const size_t centralHeader = localHeader + 30 + name.size() + data.size();
+            const size_t endOfDirectory = centralHeader + 46 + name.size();
+            
+            std::vector<char> buffer(endOfDirectory + 22, 0);
+            writeValue(buffer, localHeader, 0x04034b50, 4);
+            writeValue(buffer, localHeader + 8, method, 2);
+            writeValue(buffer, localHeader + 18, data.size(), 4);
+            writeValue(buffer, localHeader + 22, length, 4);
+            writeValue(buffer, localHeader + 26, name.size(), 2);
+            std::copy(name.begin(), name.end(), buffer.begin() + localHeader + 30);
+            std::copy(data.begin(), data.end(), buffer.begin() + localHeader + 30 + name.size());
+            
+            writeValue(buffer, centralHeader, 0x02014b50, 4);
+            writeValue(buffer, centralHeader + 10, method, 2);
+            writeValue(buffer, centralHeader + 20, data.size(), 4);
+            writeValue(buffer, centralHeader + 24, length, 4);
+            writeValue(buffer, centralHeader + 28, name.size(), 2);
+            writeValue(buffer, centralHeader + 42, localHeader, 4);
+            std::copy(name.begin(), name.end(), buffer.begin() + centralHeader + 46);
+            
+            writeValue(buffer, endOfDirectory, 0x06054b50, 4);
+            writeValue(buffer, endOfDirectory + 10, 1, 2);
+            writeValue(buffer, endOfDirectory + 12, endOfDirectory - centralHeader, 4);
+            writeValue(buffer, endOfDirectory + 16, centralHeader, 4);
+            
+            return MappedFile::Ptr(new MappedFileBuffer(buffer));
+        }
+        
+        TEST(ZipFileSystemTest, rejectStoredFileWithInvalidLength) {
+            const String name = "file.txt";
+            
+            // the length is larger than the stored data
+            const ZipFileSystem fs(Path("invalid.zip"), createZipFile(name, "data", 0, 1024));
+            ASSERT_TRUE(fs.fileExists(Path(name)));
+            ASSERT_THROW(fs.openFile(Path(name)), FileSystemException);
+        }
+        
+        TEST(ZipFileSystemTest, rejectDeflatedFileWithInvalidLength) {
+            const String name = "file.txt";
+            
+            // no deflated data of four bytes can expand to this length
+            const ZipFileSystem fs(Path("invalid.zip"), createZipFile(name, "data", 8, 0xFFFFFFFF));
+            ASSERT_TRUE(fs.fileExists(Path(name)));
+            ASSERT_THROW(fs.openFile(Path(name)), FileSystemException);
+        }
+    }
+}
@@ -177,5 +177,111 @@ namespace TrenchBroom {
             
             delete entity1;
         }
+        
+        TEST(EntityAttributeIndexTest, addRemoveDuplicatedAttribute) {
+            AttributableNodeIndex index;
+            
+            // map files may contain the same attribute line twice
+            EntityAttribute::List attributes;
+            attributes.push_back(EntityAttribute("target", "door"));
+            attributes.push_back(EntityAttribute("target", "door"));
+            
+            Entity* entity1 = new Entity();
+            entity1->setAttributes(attributes);
+            ASSERT_EQ(2u, entity1->attributes().size());
+            
+            index.addAttributableNode(entity1);
+            
+            AttributableNodeList attributables = findExactExact(index, "target", "door");
+            ASSERT_EQ(1u, attributables.size());
+            ASSERT_TRUE(VectorUtils::contains(attributables, entity1));
+            
+            index.removeAttribute(entity1, "target", "door");
+            attributables = findExactExact(index, "target", "door");
+            ASSERT_EQ(1u, attributables.size());
+            
+            index.addAttribute(entity1, "target", "door");
+            ASSERT_NO_THROW(index.removeAttributableNode(entity1));
+            ASSERT_TRUE(findExactExact(index, "target", "door").empty());
+            
+            delete entity1;
+        }
+        
+        TEST(EntityAttributeIndexTest, findPrefixedAttribute) {
+            AttributableNodeIndex index;
+            
+            Entity* entity1 = new Entity();
+            entity1->addOrUpdateAttribute("target", "somevalue");
+            entity1->addOrUpdateAttribute("targetname", "somevalue");
+            
+            Entity* entity2 = new Entity();
+            entity2->addOrUpdateAttribute("targetx", "somevalue");
+            entity2->addOrUpdateAttribute("tar", "somevalue");
+            
+            index.addAttributableNode(entity1);
+            index.addAttributableNode(entity2);
+            
+            AttributableNodeList attributables = index.findAttributableNodes(AttributableNodeIndexQuery::prefix("target"), "somevalue");
+            ASSERT_EQ(2u, attributables.size());
+            
+            attributables = findNumberedExact(index, "target", "somevalue");
+            ASSERT_EQ(1u, attributables.size());
+            ASSERT_TRUE(VectorUtils::contains(attributables, entity1));
+            
+            // the any query ignores the attribute names
+            attributables = index.findAttributableNodes(AttributableNodeIndexQuery::any(), "somevalue");
+            ASSERT_EQ(2u, attributables.size());
+            
+            index.removeAttributableNode(entity2);
+            attributables = index.findAttributableNodes(AttributableNodeIndexQuery::prefix("target"), "somevalue");
+            ASSERT_EQ(1u, attributables.size());
+            ASSERT_TRUE(VectorUtils::contains(attributables, entity1));
+            
+            delete entity1;
+            delete entity2;
+        }
+        
+        TEST(EntityAttributeIndexTest, findInLargeIndex) {
+            static const size_t EntityCount = 10000;
+            
+            AttributableNodeIndex index;
+            AttributableNodeList entities;
+            entities.reserve(EntityCount);
+            
+            for (size_t i = 0; i < EntityCount; ++i) {
+                StringStream targetname;
+                StringStream target;
+                targetname << "t" << i;
+                target << "t" << (i + 1) % EntityCount;
+                
+                Entity* entity = new Entity();
+                entity->addOrUpdateAttribute("classname", "light");
+                entity->addOrUpdateAttribute("targetname", targetname.str());
+                entity->addOrUpdateAttribute("target", target.str());
+                index.addAttributableNode(entity);
+                entities.push_back(entity);
+            }
+            
+            for (size_t i = 0; i < EntityCount; ++i) {
+                StringStream value;
+                value << "t" << i;
+                
+                const AttributableNodeList sources = findNumberedExact(index, "target", value.str());
+                ASSERT_EQ(1u, sources.size());
+                ASSERT_EQ(entities[(i + EntityCount - 1) % EntityCount], sources.front());
+                
+                const AttributableNodeList targets = findExactExact(index, "targetname", value.str());
+                ASSERT_EQ(1u, targets.size());
+                ASSERT_EQ(entities[i], targets.front());
+            }
+            
+            ASSERT_EQ(EntityCount, findExactExact(index, "classname", "light").size());
+            
+            for (size_t i = 0; i < EntityCount; ++i)
+                index.removeAttributableNode(entities[i]);
+            ASSERT_TRUE(findExactExact(index, "classname", "light").empty());
+            
+            VectorUtils::clearAndDelete(entities);
+        }
     }
 }
@@ -347,5 +347,52 @@ namespace TrenchBroom {
             
             delete target;
         }
+        
+        TEST(AttributableNodeLinkTest, testFindMissingLinkTargets) {
+            const BBox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, NULL, worldBounds);
+            Entity* source = world.createEntity();
+            Entity* target = world.createEntity();
+            world.defaultLayer()->addChild(source);
+            world.defaultLayer()->addChild(target);
+            
+            source->addOrUpdateAttribute(AttributeNames::Target, "target_name");
+            source->addOrUpdateAttribute(AttributeNames::Target + "2", "other_name");
+            target->addOrUpdateAttribute(AttributeNames::Targetname, "target_name");
+            
+            AttributeNameList missing = source->findMissingLinkTargets();
+            ASSERT_EQ(1u, missing.size());
+            ASSERT_EQ(AttributeNames::Target + "2", missing.front());
+            
+            target->addOrUpdateAttribute(AttributeNames::Targetname, "other_name");
+            missing = source->findMissingLinkTargets();
+            ASSERT_EQ(1u, missing.size());
+            ASSERT_EQ(AttributeNames::Target, missing.front());
+            
+            world.defaultLayer()->removeChild(target);
+            missing = source->findMissingLinkTargets();
+            ASSERT_EQ(2u, missing.size());
+            
+            delete target;
+        }
+        
+        TEST(AttributableNodeLinkTest, testFindMissingKillTargets) {
+            const BBox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, NULL, worldBounds);
+            Entity* source = world.createEntity();
+            Entity* target = world.createEntity();
+            world.defaultLayer()->addChild(source);
+            world.defaultLayer()->addChild(target);
+            
+            source->addOrUpdateAttribute(AttributeNames::Killtarget, "target_name");
+            ASSERT_EQ(1u, source->findMissingKillTargets().size());
+            
+            target->addOrUpdateAttribute(AttributeNames::Targetname, "target_name");
+            ASSERT_TRUE(source->findMissingKillTargets().empty());
+            ASSERT_EQ(1u, source->killTargets().size());
+            
+            source->addOrUpdateAttribute(AttributeNames::Killtarget, "");
+            ASSERT_EQ(1u, source->findMissingKillTargets().size());
+        }
     }
 }
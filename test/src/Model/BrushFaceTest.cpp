@@ -106,5 +106,28 @@ namespace TrenchBroom {
             EXPECT_EQ(1, texture.usageCount());
             EXPECT_EQ(0, texture2.usageCount());
         }
+        
+        TEST(BrushFaceTest, textureNamesAreShared) {
+            const Vec3 p0(0.0,  0.0, 4.0);
+            const Vec3 p1(1.f,  0.0, 4.0);
+            const Vec3 p2(0.0, -1.0, 4.0);
+            Assets::Texture texture("sharedTexture2", 64, 64);
+            
+            const BrushFaceAttributes attribs1("sharedTexture");
+            const BrushFaceAttributes attribs2(String("shared") + "Texture");
+            ASSERT_EQ("sharedTexture", attribs1.textureName());
+            ASSERT_EQ(&attribs1.textureName(), &attribs2.textureName());
+            
+            BrushFace face1(p0, p1, p2, attribs1, new ParaxialTexCoordSystem(p0, p1, p2, attribs1));
+            BrushFace face2(p0, p1, p2, attribs2, new ParaxialTexCoordSystem(p0, p1, p2, attribs2));
+            ASSERT_EQ(&face1.textureName(), &face2.textureName());
+            
+            face1.setTexture(&texture);
+            ASSERT_EQ("sharedTexture2", face1.textureName());
+            ASSERT_EQ("sharedTexture", face2.textureName());
+            
+            face2.setTexture(&texture);
+            ASSERT_EQ(&face1.textureName(), &face2.textureName());
+        }
     }
 }
@@ -0,0 +1,171 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometryCache.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace Model {
+        class ResetBrushGeometryCache {
+        private:
+            size_t m_memoryLimit;
+        public:
+            ResetBrushGeometryCache() :
+            m_memoryLimit(BrushGeometryCache::instance().memoryLimit()) {
+                BrushGeometryCache::instance().clear();
+            }
+            
+            ~ResetBrushGeometryCache() {
+                BrushGeometryCache::instance().setMemoryLimit(m_memoryLimit);
+                BrushGeometryCache::instance().clear();
+            }
+        };
+        
+        static BrushFaceList createCubeFaces(const FloatType size) {
+            BrushFaceList faces;
+            faces.push_back(BrushFace::createParaxial(Vec3(0.0, 0.0, 0.0), Vec3(0.0, 1.0, 0.0), Vec3(0.0, 0.0, 1.0)));
+            faces.push_back(BrushFace::createParaxial(Vec3(size, 0.0, 0.0), Vec3(size, 0.0, 1.0), Vec3(size, 1.0, 0.0)));
+            faces.push_back(BrushFace::createParaxial(Vec3(0.0, 0.0, 0.0), Vec3(0.0, 0.0, 1.0), Vec3(1.0, 0.0, 0.0)));
+            faces.push_back(BrushFace::createParaxial(Vec3(0.0, size, 0.0), Vec3(1.0, size, 0.0), Vec3(0.0, size, 1.0)));
+            faces.push_back(BrushFace::createParaxial(Vec3(0.0, 0.0, size), Vec3(0.0, 1.0, size), Vec3(1.0, 0.0, size)));
+            faces.push_back(BrushFace::createParaxial(Vec3(0.0, 0.0, 0.0), Vec3(1.0, 0.0, 0.0), Vec3(0.0, 1.0, 0.0)));
+            return faces;
+        }
+        
+        TEST(BrushGeometryCacheTest, cloneReusesGeometry) {
+            const ResetBrushGeometryCache reset;
+            const BrushGeometryCache& cache = BrushGeometryCache::instance();
+            
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, NULL, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+            
+            Brush* original = builder.createCube(32.0, "texture");
+            ASSERT_EQ(0u, cache.hits());
+            ASSERT_EQ(1u, cache.misses());
+            ASSERT_EQ(1u, cache.entryCount());
+            
+            Brush* clone = static_cast<Brush*>(original->clone(worldBounds));
+            ASSERT_EQ(1u, cache.hits());
+            ASSERT_EQ(1u, cache.misses());
+            
+            ASSERT_EQ(original->faces().size(), clone->faces().size());
+            ASSERT_EQ(original->bounds(), clone->bounds());
+            
+            Vec3::List originalVertices;
+            Vec3::List cloneVertices;
+            
+            const Brush::VertexList originalVertexList = original->vertices();
+            const Brush::VertexList cloneVertexList = clone->vertices();
+            
+            Brush::VertexList::const_iterator vIt, vEnd;
+            for (vIt = originalVertexList.begin(), vEnd = originalVertexList.end(); vIt != vEnd; ++vIt)
+                originalVertices.push_back((*vIt)->position());
+            for (vIt = cloneVertexList.begin(), vEnd = cloneVertexList.end(); vIt != vEnd; ++vIt)
+                cloneVertices.push_back((*vIt)->position());
+            
+            std::sort(originalVertices.begin(), originalVertices.end());
+            std::sort(cloneVertices.begin(), cloneVertices.end());
+            ASSERT_EQ(originalVertices, cloneVertices);
+            
+            const BrushFaceList& faces = clone->faces();
+            BrushFaceList::const_iterator it, end;
+            for (it = faces.begin(), end = faces.end(); it != end; ++it) {
+                const BrushFace* face = *it;
+                ASSERT_TRUE(face->geometry() != NULL);
+                ASSERT_EQ(face, face->geometry()->payload());
+                ASSERT_EQ(clone, face->brush());
+                ASSERT_EQ(4u, face->vertexCount());
+            }
+            
+            delete clone;
+            delete original;
+        }
+        
+        TEST(BrushGeometryCacheTest, dropRedundantFacesOnHit) {
+            const ResetBrushGeometryCache reset;
+            const BrushGeometryCache& cache = BrushGeometryCache::instance();
+            
+            const BBox3 worldBounds(4096.0);
+            
+            BrushFaceList faces1 = createCubeFaces(16.0);
+            faces1.push_back(BrushFace::createParaxial(Vec3(0.0, 0.0, 0.0), Vec3(1.0, 0.0, 0.0), Vec3(0.0, 1.0, 0.0)));
+            Brush brush1(worldBounds, faces1);
+            ASSERT_EQ(6u, brush1.faces().size());
+            
+            BrushFaceList faces2 = createCubeFaces(16.0);
+            faces2.push_back(BrushFace::createParaxial(Vec3(0.0, 0.0, 0.0), Vec3(1.0, 0.0, 0.0), Vec3(0.0, 1.0, 0.0)));
+            Brush brush2(worldBounds, faces2);
+            ASSERT_EQ(1u, cache.hits());
+            ASSERT_EQ(6u, brush2.faces().size());
+            ASSERT_EQ(brush1.bounds(), brush2.bounds());
+        }
+        
+        TEST(BrushGeometryCacheTest, keyIncludesWorldBounds) {
+            const ResetBrushGeometryCache reset;
+            const BrushGeometryCache& cache = BrushGeometryCache::instance();
+            
+            Brush brush1(BBox3(4096.0), createCubeFaces(16.0));
+            Brush brush2(BBox3(8192.0), createCubeFaces(16.0));
+            ASSERT_EQ(0u, cache.hits());
+            ASSERT_EQ(2u, cache.entryCount());
+        }
+        
+        TEST(BrushGeometryCacheTest, evictLeastRecentlyUsed) {
+            const ResetBrushGeometryCache reset;
+            BrushGeometryCache& cache = BrushGeometryCache::instance();
+            
+            const BBox3 worldBounds(4096.0);
+            
+            Brush brush1(worldBounds, createCubeFaces(16.0));
+            const size_t entrySize = cache.memoryUsage();
+            cache.setMemoryLimit(2 * entrySize);
+            
+            Brush brush2(worldBounds, createCubeFaces(32.0));
+            ASSERT_EQ(2u, cache.entryCount());
+            
+            // make brush1 the most recently used entry
+            Brush brush3(worldBounds, createCubeFaces(16.0));
+            ASSERT_EQ(1u, cache.hits());
+            
+            // evicts the entry of brush2
+            Brush brush4(worldBounds, createCubeFaces(64.0));
+            ASSERT_EQ(2u, cache.entryCount());
+            ASSERT_EQ(2u * entrySize, cache.memoryUsage());
+            
+            Brush brush5(worldBounds, createCubeFaces(16.0));
+            ASSERT_EQ(2u, cache.hits());
+            
+            Brush brush6(worldBounds, createCubeFaces(32.0));
+            ASSERT_EQ(2u, cache.hits());
+            
+            cache.setMemoryLimit(0);
+            ASSERT_EQ(0u, cache.entryCount());
+            ASSERT_EQ(0u, cache.memoryUsage());
+        }
+    }
+}
@@ -19,7 +19,9 @@
 
 #include <gtest/gtest.h>
 
+#include "CollectionUtils.h"
 #include "TestUtils.h"
+#include "ThreadPool.h"
 
 #include "IO/NodeReader.h"
 #include "Model/Brush.h"
@@ -459,6 +461,139 @@ namespace TrenchBroom {
             ASSERT_TRUE(hits2.empty());
         }
         
+        TEST(BrushTest, pickMatchesFaceIntersection) {
+            const BBox3 worldBounds(4096.0);
+            
+            BrushFaceList faces;
+            faces.push_back(BrushFace::createParaxial(Vec3(624.0, 688.0, -456.0), Vec3(656.0, 760.0, -480.0), Vec3(624.0, 680.0, -480.0), "face7"));
+            faces.push_back(BrushFace::createParaxial(Vec3(536.0, 792.0, -480.0), Vec3(536.0, 792.0, -432.0), Vec3(488.0, 720.0, -480.0), "face12"));
+            faces.push_back(BrushFace::createParaxial(Vec3(568.0, 656.0, -464.0), Vec3(568.0, 648.0, -480.0), Vec3(520.0, 672.0, -456.0), "face14"));
+            faces.push_back(BrushFace::createParaxial(Vec3(520.0, 672.0, -456.0), Vec3(520.0, 664.0, -480.0), Vec3(488.0, 720.0, -452.0), "face15"));
+            faces.push_back(BrushFace::createParaxial(Vec3(560.0, 728.0, -440.0), Vec3(488.0, 720.0, -452.0), Vec3(536.0, 792.0, -432.0), "face17"));
+            faces.push_back(BrushFace::createParaxial(Vec3(568.0, 656.0, -464.0), Vec3(520.0, 672.0, -456.0), Vec3(624.0, 688.0, -456.0), "face19"));
+            faces.push_back(BrushFace::createParaxial(Vec3(560.0, 728.0, -440.0), Vec3(624.0, 688.0, -456.0), Vec3(520.0, 672.0, -456.0), "face20"));
+            faces.push_back(BrushFace::createParaxial(Vec3(600.0, 840.0, -480.0), Vec3(536.0, 792.0, -480.0), Vec3(636.0, 812.0, -480.0), "face22"));
+            
+            const Brush brush(worldBounds, faces);
+            const BBox3 bounds = brush.bounds().expanded(16.0);
+            const Vec3 center = bounds.center();
+            
+            const Vec3 origins[] = {
+                Vec3(bounds.min.x(), bounds.min.y(), bounds.min.z()),
+                Vec3(bounds.max.x(), bounds.min.y(), bounds.max.z()),
+                Vec3(bounds.min.x(), bounds.max.y(), center.z()),
+                Vec3(center.x(), center.y(), bounds.max.z()),
+                Vec3(center.x(), bounds.min.y(), center.z()),
+                center
+            };
+            
+            for (size_t i = 0; i < sizeof(origins) / sizeof(origins[0]); ++i) {
+                for (size_t x = 0; x < 10; ++x) {
+                    for (size_t y = 0; y < 10; ++y) {
+                        for (size_t z = 0; z < 10; ++z) {
+                            const Vec3 target(bounds.min.x() + (x + 0.37) * bounds.size().x() / 10.0,
+                                              bounds.min.y() + (y + 0.61) * bounds.size().y() / 10.0,
+                                              bounds.min.z() + (z + 0.23) * bounds.size().z() / 10.0);
+                            const Ray3 ray(origins[i], (target - origins[i]).normalized());
+                            
+                            const BrushFace* expectedFace = NULL;
+                            FloatType expectedDistance = Math::nan<FloatType>();
+                            const BrushFaceList& brushFaces = brush.faces();
+                            for (size_t j = 0; j < brushFaces.size() && expectedFace == NULL; ++j) {
+                                expectedDistance = brushFaces[j]->intersectWithRay(ray);
+                                if (!Math::isnan(expectedDistance))
+                                    expectedFace = brushFaces[j];
+                            }
+                            
+                            PickResult hits;
+                            brush.pick(ray, hits);
+                            if (expectedFace == NULL) {
+                                ASSERT_TRUE(hits.empty());
+                            } else {
+                                ASSERT_EQ(1u, hits.size());
+                                const Hit& hit = hits.all().front();
+                                ASSERT_EQ(expectedFace, hit.target<BrushFace*>());
+                                ASSERT_NEAR(expectedDistance, hit.distance(), 0.0001);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        
+        TEST(BrushTest, rebuildGeometryOnThreadPool) {
+            const BBox3 worldBounds(4096.0);
+            
+            World world(MapFormat::Standard, NULL, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+            
+            BrushList brushes;
+            for (size_t i = 0; i < 100; ++i)
+                brushes.push_back(builder.createCube(static_cast<FloatType>(i + 1), "texture"));
+            
+            // flipping the top face leaves the brush unbounded
+            Brush* invalidBrush = brushes[42];
+            BrushFace* topFace = invalidBrush->findFaceByNormal(Vec3::PosZ);
+            ASSERT_TRUE(topFace != NULL);
+            topFace->invert();
+            
+            ThreadPool threadPool(4);
+            const Brush::GeometryErrorList errors = Brush::rebuildGeometry(brushes, worldBounds, threadPool);
+            ASSERT_EQ(1u, errors.size());
+            ASSERT_EQ(invalidBrush, errors.front().first);
+            
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                if (brushes[i] != invalidBrush) {
+                    const FloatType size = static_cast<FloatType>(i + 1);
+                    ASSERT_EQ(BBox3(size / 2.0), brushes[i]->bounds());
+                    ASSERT_EQ(6u, brushes[i]->faces().size());
+                    ASSERT_EQ(8u, brushes[i]->vertexCount());
+                }
+            }
+            
+            VectorUtils::clearAndDelete(brushes);
+        }
+        
+        TEST(BrushTest, transformBrushesOnThreadPool) {
+            const BBox3 worldBounds(4096.0);
+            
+            World world(MapFormat::Standard, NULL, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+            
+            BrushList brushes;
+            for (size_t i = 0; i < 100; ++i)
+                brushes.push_back(builder.createCube(static_cast<FloatType>(i + 1), "texture"));
+            
+            BrushList expected;
+            for (size_t i = 0; i < brushes.size(); ++i)
+                expected.push_back(brushes[i]->clone(worldBounds));
+            
+            const Mat4x4 transformation = translationMatrix(Vec3(16.0, 32.0, 8.0)) * rotationMatrix(Vec3::PosZ, Math::radians(30.0));
+            for (size_t i = 0; i < expected.size(); ++i)
+                expected[i]->transform(transformation, true, worldBounds);
+            
+            ThreadPool threadPool(4);
+            ASSERT_TRUE(Brush::transformBrushes(brushes, transformation, true, worldBounds, threadPool).empty());
+            
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                ASSERT_EQ(expected[i]->bounds(), brushes[i]->bounds());
+                ASSERT_EQ(expected[i]->vertexCount(), brushes[i]->vertexCount());
+                
+                const BrushFaceList& expectedFaces = expected[i]->faces();
+                const BrushFaceList& faces = brushes[i]->faces();
+                ASSERT_EQ(expectedFaces.size(), faces.size());
+                for (size_t j = 0; j < faces.size(); ++j) {
+                    ASSERT_EQ(expectedFaces[j]->boundary(), faces[j]->boundary());
+                    ASSERT_FLOAT_EQ(expectedFaces[j]->xOffset(), faces[j]->xOffset());
+                    ASSERT_FLOAT_EQ(expectedFaces[j]->yOffset(), faces[j]->yOffset());
+                    ASSERT_FLOAT_EQ(expectedFaces[j]->rotation(), faces[j]->rotation());
+                }
+            }
+            
+            VectorUtils::clearAndDelete(expected);
+            VectorUtils::clearAndDelete(brushes);
+        }
+        
         TEST(BrushTest, partialSelectionAfterAdd) {
             const BBox3 worldBounds(4096.0);
             
@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "ThreadPool.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CollectContainedNodesVisitor.h"
+#include "Model/CollectMatchingNodesVisitor.h"
+#include "Model/CollectTouchingNodesVisitor.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        // a grid of overlapping brushes with an entity and a group in it
+        static void createGrid(World& world, BrushBuilder& builder) {
+            Layer* layer = world.defaultLayer();
+            for (size_t x = 0; x < 20; ++x) {
+                for (size_t y = 0; y < 20; ++y) {
+                    for (size_t z = 0; z < 5; ++z) {
+                        const Vec3 min(32.0 * x - 320.0, 32.0 * y - 320.0, 32.0 * z - 80.0);
+                        layer->addChild(builder.createCuboid(BBox3(min, min + Vec3(48.0, 48.0, 48.0)), "texture"));
+                    }
+                }
+            }
+            
+            Entity* entity = new Entity();
+            entity->addChild(builder.createCuboid(BBox3(Vec3(-8.0, -8.0, 200.0), Vec3(8.0, 8.0, 216.0)), "texture"));
+            layer->addChild(entity);
+            
+            Group* group = new Group("group");
+            group->addChild(builder.createCuboid(BBox3(Vec3(100.0, 100.0, 200.0), Vec3(132.0, 132.0, 232.0)), "texture"));
+            layer->addChild(group);
+        }
+        
+        TEST(CollectMatchingNodesVisitorTest, findMatchingNodesEqualsCollectMatchingNodes) {
+            const BBox3 worldBounds(4096.0);
+            
+            World world(MapFormat::Standard, NULL, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+            createGrid(world, builder);
+            
+            BrushList brushes;
+            brushes.push_back(builder.createCuboid(BBox3(Vec3(-64.0, -64.0, -64.0), Vec3(64.0, 64.0, 240.0)), "texture"));
+            brushes.push_back(builder.createCuboid(BBox3(Vec3(90.0, 90.0, 190.0), Vec3(140.0, 140.0, 240.0)), "texture"));
+            world.defaultLayer()->addChildren(brushes.begin(), brushes.end());
+            
+            ThreadPool threadPool(4);
+            
+            NodeList touching = collectMatchingNodes<CollectTouchingNodesVisitor>(brushes.begin(), brushes.end(), &world);
+            VectorUtils::sortAndRemoveDuplicates(touching);
+            ASSERT_FALSE(touching.empty());
+            ASSERT_EQ(touching, findMatchingNodes<MatchTouchingNodes>(brushes.begin(), brushes.end(), &world, threadPool));
+            
+            NodeList contained = collectMatchingNodes<CollectContainedNodesVisitor>(brushes.begin(), brushes.end(), &world);
+            VectorUtils::sortAndRemoveDuplicates(contained);
+            ASSERT_FALSE(contained.empty());
+            ASSERT_EQ(contained, findMatchingNodes<MatchContainedNodes>(brushes.begin(), brushes.end(), &world, threadPool));
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "ThreadPool.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Issue.h"
+#include "Model/IssueValidator.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/MissingEntityClassnameIssueGenerator.h"
+#include "Model/WorldBoundsIssueGenerator.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST(IssueValidatorTest, validateInvalidNodes) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, NULL, worldBounds);
+            world.registerIssueGenerator(new MissingEntityClassnameIssueGenerator());
+            
+            Entity* entity = new Entity();
+            world.defaultLayer()->addChild(entity);
+            ASSERT_FALSE(entity->issuesValid());
+            
+            ThreadPool threadPool(2);
+            IssueValidator validator(threadPool);
+            validator.validate(&world, world.registeredIssueGenerators());
+            ASSERT_EQ(3u, validator.nodeCount());
+            ASSERT_EQ(1u, validator.times().size());
+            ASSERT_TRUE(entity->issuesValid());
+            ASSERT_EQ(1u, entity->issues(world.registeredIssueGenerators()).size());
+            
+            validator.validate(&world, world.registeredIssueGenerators());
+            ASSERT_EQ(0u, validator.nodeCount());
+            
+            entity->addOrUpdateAttribute(AttributeNames::Classname, "light");
+            ASSERT_FALSE(entity->issuesValid());
+            
+            validator.validate(&world, world.registeredIssueGenerators());
+            ASSERT_TRUE(entity->issuesValid());
+            ASSERT_TRUE(entity->issues(world.registeredIssueGenerators()).empty());
+        }
+        
+        TEST(IssueValidatorTest, registerGeneratorKeepsOtherIssues) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, NULL, worldBounds);
+            world.registerIssueGenerator(new MissingEntityClassnameIssueGenerator());
+            
+            Entity* entity = new Entity();
+            entity->addOrUpdateAttribute("origin", "256 0 0");
+            world.defaultLayer()->addChild(entity);
+            
+            ThreadPool threadPool(0);
+            IssueValidator validator(threadPool);
+            validator.validate(&world, world.registeredIssueGenerators());
+            ASSERT_EQ(1u, entity->issues(world.registeredIssueGenerators()).size());
+            const Issue* classnameIssue = entity->issues(world.registeredIssueGenerators()).front();
+            
+            world.registerIssueGenerator(new WorldBoundsIssueGenerator(BBox3(64.0)));
+            ASSERT_FALSE(entity->issuesValid());
+            
+            validator.validate(&world, world.registeredIssueGenerators());
+            const IssueList& issues = entity->issues(world.registeredIssueGenerators());
+            ASSERT_EQ(2u, issues.size());
+            ASSERT_EQ(classnameIssue, issues.front());
+            ASSERT_EQ(2u, validator.times().size());
+            
+            world.unregisterAllIssueGenerators();
+            validator.validate(&world, world.registeredIssueGenerators());
+            ASSERT_TRUE(entity->issues(world.registeredIssueGenerators()).empty());
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Entity.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST(LayerTest, findNodesInFrustum) {
+            const BBox3 worldBounds(4096.0);
+            
+            World world(MapFormat::Standard, NULL, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+            
+            Brush* visibleBrush = builder.createCuboid(BBox3(Vec3(-16.0, -16.0, -16.0), Vec3(16.0, 16.0, 16.0)), "texture");
+            Brush* culledBrush = builder.createCuboid(BBox3(Vec3(1024.0, -16.0, -16.0), Vec3(1056.0, 16.0, 16.0)), "texture");
+            Brush* entityBrush = builder.createCuboid(BBox3(Vec3(32.0, -16.0, -16.0), Vec3(64.0, 16.0, 16.0)), "texture");
+            
+            Entity* entity = new Entity();
+            entity->addChild(entityBrush);
+            
+            Layer* layer = world.defaultLayer();
+            layer->addChild(visibleBrush);
+            layer->addChild(culledBrush);
+            layer->addChild(entity);
+            
+            // a box around the origin, the plane normals point out of it
+            Plane3::List frustum;
+            frustum.push_back(Plane3(Vec3(128.0, 128.0, 128.0), Vec3::PosX));
+            frustum.push_back(Plane3(Vec3(128.0, 128.0, 128.0), Vec3::PosY));
+            frustum.push_back(Plane3(Vec3(128.0, 128.0, 128.0), Vec3::PosZ));
+            frustum.push_back(Plane3(Vec3(-128.0, -128.0, -128.0), Vec3::NegX));
+            frustum.push_back(Plane3(Vec3(-128.0, -128.0, -128.0), Vec3::NegY));
+            frustum.push_back(Plane3(Vec3(-128.0, -128.0, -128.0), Vec3::NegZ));
+            
+            NodeList nodes;
+            world.findNodesInFrustum(frustum, nodes);
+            
+            ASSERT_EQ(3u, nodes.size());
+            ASSERT_TRUE(VectorUtils::contains(nodes, visibleBrush));
+            ASSERT_TRUE(VectorUtils::contains(nodes, entity));
+            ASSERT_TRUE(VectorUtils::contains(nodes, entityBrush));
+            ASSERT_FALSE(VectorUtils::contains(nodes, culledBrush));
+        }
+    }
+}
@@ -82,6 +82,14 @@ namespace TrenchBroom {
             void doFindNodesContaining(const Vec3& point, NodeList& result) {
                 mockDoFindNodesContaining(point, result);
             }
+            
+            void doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result) {
+                mockDoFindNodesInFrustum(frustum, result);
+            }
+            
+            void doFindNodesIntersecting(const BBox3& bounds, NodeList& result) {
+                mockDoFindNodesIntersecting(bounds, result);
+            }
 
             FloatType doIntersectWithRay(const Ray3& ray) const {
                 return mockDoIntersectWithRay(ray);
@@ -108,6 +116,8 @@ namespace TrenchBroom {
             
             MOCK_CONST_METHOD2(mockDoPick, void(const Ray3&, PickResult&));
             MOCK_CONST_METHOD2(mockDoFindNodesContaining, void(const Vec3&, NodeList&));
+            MOCK_CONST_METHOD2(mockDoFindNodesInFrustum, void(const Plane3::List&, NodeList&));
+            MOCK_CONST_METHOD2(mockDoFindNodesIntersecting, void(const BBox3&, NodeList&));
             MOCK_CONST_METHOD1(mockDoIntersectWithRay, FloatType(const Ray3&));
             
             MOCK_METHOD1(mockDoAccept, void(NodeVisitor&));
@@ -153,6 +163,8 @@ namespace TrenchBroom {
             
             virtual void doPick(const Ray3& ray, PickResult& pickResult) const {}
             virtual void doFindNodesContaining(const Vec3& point, NodeList& result) {}
+            virtual void doFindNodesInFrustum(const Plane3::List& frustum, NodeList& result) {}
+            virtual void doFindNodesIntersecting(const BBox3& bounds, NodeList& result) {}
             virtual FloatType doIntersectWithRay(const Ray3& ray) const { return Math::nan<FloatType>(); }
 
             virtual void doAccept(NodeVisitor& visitor) {}
@@ -25,6 +25,10 @@
 #include "Model/Object.h"
 #include "Model/Brush.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         TEST(OctreeTest, insertObject) {
@@ -73,5 +77,99 @@ namespace TrenchBroom {
             octree.addObject(aBounds, a);
             ASSERT_THROW(octree.removeObject(b), OctreeException);
         }
+        
+        TEST(OctreeTest, updateObject) {
+            const BBox3f bounds(-128.0f, +128.0f);
+            const float minSize = 32.0f;
+            Octree<float,int> octree(bounds, minSize);
+            
+            const int a = 1;
+            const int b = 2;
+            const BBox3f aBounds(1.0f, 2.0f);
+            const BBox3f bBounds(-100.0f, -90.0f);
+            octree.addObject(aBounds, a);
+            octree.addObject(bBounds, b);
+            
+            const BBox3f newBounds(100.0f, 120.0f);
+            octree.updateObject(newBounds, a);
+            ASSERT_TRUE(octree.containsObject(newBounds, a));
+            ASSERT_TRUE(octree.containsObject(bBounds, b));
+            ASSERT_TRUE(octree.findObjects(Vec3f(1.5f, 1.5f, 1.5f)).empty());
+            ASSERT_EQ(1u, octree.findObjects(Vec3f(110.0f, 110.0f, 110.0f)).size());
+            
+            octree.removeObject(b);
+            ASSERT_EQ(1u, octree.objectCount());
+            ASSERT_THROW(octree.updateObject(bBounds, b), OctreeException);
+        }
+        
+        static BBox3f randomBounds(const BBox3f& worldBounds) {
+            Vec3f center, size;
+            for (size_t i = 0; i < 3; ++i) {
+                const float extent = worldBounds.max[i] - worldBounds.min[i];
+                size[i] = 1.0f + static_cast<float>(std::rand() % 64);
+                center[i] = worldBounds.min[i] + size[i] + static_cast<float>(std::rand()) / RAND_MAX * (extent - 2.0f * size[i]);
+            }
+            return BBox3f(center - size / 2.0f, center + size / 2.0f);
+        }
+        
+        static std::vector<int> sorted(std::vector<int> list) {
+            std::sort(list.begin(), list.end());
+            return list;
+        }
+        
+        TEST(OctreeTest, findObjects) {
+            const BBox3f worldBounds(-4096.0f, +4096.0f);
+            Octree<float,int> octree(worldBounds, 64.0f);
+            
+            std::srand(1);
+            std::vector<BBox3f> objectBounds;
+            for (int i = 0; i < 2000; ++i) {
+                objectBounds.push_back(randomBounds(worldBounds));
+                octree.addObject(objectBounds.back(), i);
+            }
+            
+            // move and remove some objects
+            for (int i = 0; i < 2000; i += 3) {
+                objectBounds[i] = randomBounds(worldBounds);
+                octree.updateObject(objectBounds[i], i);
+            }
+            for (int i = 0; i < 2000; i += 7) {
+                octree.removeObject(i);
+                objectBounds[i] = BBox3f();
+            }
+            
+            for (size_t i = 0; i < 50; ++i) {
+                const Vec3f point = randomBounds(worldBounds).center();
+                const Ray3f ray(point, Vec3f(static_cast<float>(i % 3), 1.0f, -0.5f).normalized());
+                const BBox3f range = randomBounds(worldBounds).expand(256.0f);
+                
+                Octree<float,int>::PlaneList frustum;
+                frustum.push_back(Plane3f(range.max, Vec3f::PosX));
+                frustum.push_back(Plane3f(range.max, Vec3f::PosY));
+                frustum.push_back(Plane3f(range.min, Vec3f::NegX));
+                frustum.push_back(Plane3f(range.min, Vec3f::NegY));
+                
+                std::vector<int> rayHits, pointHits, rangeHits, frustumHits;
+                for (int j = 0; j < 2000; ++j) {
+                    if (j % 7 == 0)
+                        continue;
+                    const BBox3f& b = objectBounds[j];
+                    if (b.contains(ray.origin) || !Math::isnan(b.intersectWithRay(ray)))
+                        rayHits.push_back(j);
+                    if (b.contains(point))
+                        pointHits.push_back(j);
+                    if (b.intersects(range))
+                        rangeHits.push_back(j);
+                    if (b.max.x() >= range.min.x() && b.min.x() <= range.max.x() &&
+                        b.max.y() >= range.min.y() && b.min.y() <= range.max.y())
+                        frustumHits.push_back(j);
+                }
+                
+                ASSERT_EQ(rayHits, sorted(octree.findObjects(ray)));
+                ASSERT_EQ(pointHits, sorted(octree.findObjects(point)));
+                ASSERT_EQ(rangeHits, sorted(octree.findObjects(range)));
+                ASSERT_EQ(frustumHits, sorted(octree.findObjects(frustum)));
+            }
+        }
     }
 }
@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "TestUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/MapFormat.h"
+#include "Model/Snapshot.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST(SnapshotTest, restoreTransformedBrush) {
+            const BBox3 worldBounds(4096.0);
+            
+            World world(MapFormat::Standard, NULL, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush = builder.createCube(64.0, "texture");
+            
+            BrushFace* topFace = brush->findFaceByNormal(Vec3::PosZ);
+            topFace->setXOffset(8.0f);
+            topFace->setRotation(45.0f);
+            topFace->setFilePosition(3, 4);
+            topFace->select();
+            
+            std::vector<Vec3> points;
+            const BrushFaceList& faces = brush->faces();
+            for (size_t i = 0; i < faces.size(); ++i) {
+                for (size_t j = 0; j < 3; ++j)
+                    points.push_back(faces[i]->points()[j]);
+            }
+            
+            NodeList nodes(1, brush);
+            Snapshot snapshot(nodes.begin(), nodes.end());
+            ASSERT_LT(0u, snapshot.memorySize());
+            
+            brush->transform(translationMatrix(Vec3(32.0, 0.0, 0.0)), false, worldBounds);
+            topFace->setXOffset(0.0f);
+            ASSERT_EQ(BBox3(Vec3(0.0, -32.0, -32.0), Vec3(64.0, 32.0, 32.0)), brush->bounds());
+            
+            snapshot.restoreNodes(worldBounds);
+            ASSERT_EQ(BBox3(32.0), brush->bounds());
+            ASSERT_EQ(6u, brush->faces().size());
+            ASSERT_EQ(8u, brush->vertexCount());
+            
+            for (size_t i = 0; i < brush->faces().size(); ++i) {
+                for (size_t j = 0; j < 3; ++j)
+                    ASSERT_VEC_EQ(points[3 * i + j], brush->faces()[i]->points()[j]);
+            }
+            
+            const BrushFace* restoredTopFace = brush->findFaceByNormal(Vec3::PosZ);
+            ASSERT_TRUE(restoredTopFace != NULL);
+            ASSERT_FLOAT_EQ(8.0f, restoredTopFace->xOffset());
+            ASSERT_FLOAT_EQ(45.0f, restoredTopFace->rotation());
+            ASSERT_EQ("texture", restoredTopFace->textureName());
+            ASSERT_EQ(3u, restoredTopFace->lineNumber());
+            ASSERT_EQ(4u, restoredTopFace->lineCount());
+            ASSERT_TRUE(restoredTopFace->selected());
+            ASSERT_TRUE(brush->descendantSelected());
+            
+            delete brush;
+        }
+    }
+}
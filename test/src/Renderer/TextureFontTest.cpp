@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "AttrString.h"
+#include "Renderer/FontGlyph.h"
+#include "Renderer/FontTexture.h"
+#include "Renderer/TextureFont.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static TextureFont* createFont() {
+            const unsigned char firstChar = 32;
+            const unsigned char charCount = 96;
+            
+            FontGlyph::List glyphs;
+            for (size_t i = 0; i < charCount; ++i)
+                glyphs.push_back(FontGlyph((i % 16) * 10, (i / 16) * 14, 8, 12, 9));
+            return new TextureFont(new FontTexture(charCount, 14, 2), glyphs, 14, firstChar, charCount);
+        }
+        
+        TEST(TextureFontTest, layoutMatchesQuadsAndMeasure) {
+            TextureFont* font = createFont();
+            
+            AttrString string;
+            string.appendLeftJustified("info_player_start");
+            string.appendRightJustified("1 2 3");
+            string.appendCentered("light");
+            
+            const TextureFont::Layout& layout = font->layout(string);
+            ASSERT_EQ(font->quads(string, true), layout.vertices);
+            ASSERT_EQ(font->measure(string), layout.size);
+            
+            delete font;
+        }
+        
+        TEST(TextureFontTest, layoutIsCachedByContents) {
+            TextureFont* font = createFont();
+            
+            AttrString string1;
+            string1.appendLeftJustified("worldspawn");
+            AttrString string2;
+            string2.appendLeftJustified("worldspawn");
+            AttrString string3;
+            string3.appendLeftJustified("func_door");
+            
+            const TextureFont::Layout* layout1 = &font->layout(string1);
+            ASSERT_EQ(layout1, &font->layout(string2));
+            ASSERT_NE(layout1, &font->layout(string3));
+            ASSERT_NE(layout1->size, font->layout(string3).size);
+            
+            delete font;
+        }
+    }
+}
@@ -183,5 +183,56 @@ namespace TrenchBroom {
             // destroy vbo
             EXPECT_CALL(glMock, DeleteBuffers(1, Pointee(13)));
         }
+
+        TEST(VboTest, compactFragmentedBlocks) {
+            using namespace testing;
+            InSequence forceInSequenceMockCalls;
+
+            GLMock glMock;
+
+            Vbo vbo(0x100, GL_ARRAY_BUFFER);
+
+            unsigned char buffer[0x100];
+            for (size_t i = 0; i < 0x100; ++i)
+                buffer[i] = static_cast<unsigned char>(i);
+
+            // activate for the first time
+            EXPECT_CALL(glMock, GenBuffers(1,_)).WillOnce(SetArgumentPointee<1>(13));
+            EXPECT_CALL(glMock, BindBuffer(GL_ARRAY_BUFFER, 13));
+            EXPECT_CALL(glMock, BufferData(GL_ARRAY_BUFFER, 0x100, NULL, GL_DYNAMIC_DRAW));
+            {
+                ActivateVbo activate(vbo);
+
+                VboBlock* block1 = vbo.allocateBlock(0x40);
+                VboBlock* block2 = vbo.allocateBlock(0x40);
+                VboBlock* block3 = vbo.allocateBlock(0x40);
+                VboBlock* block4 = vbo.allocateBlock(0x40);
+
+                // leaves two free blocks which are too small for the next allocation
+                block1->free();
+                block3->free();
+
+                // the used blocks are moved to the front instead of growing the buffer
+                EXPECT_CALL(glMock, MapBuffer(GL_ARRAY_BUFFER, GL_READ_WRITE)).WillOnce(Return(buffer));
+                EXPECT_CALL(glMock, UnmapBuffer(GL_ARRAY_BUFFER));
+
+                VboBlock* block5 = vbo.allocateBlock(0x80);
+                ASSERT_EQ(0x80u, block5->capacity());
+                ASSERT_EQ(0x00u, block2->offset());
+                ASSERT_EQ(0x40u, block4->offset());
+                ASSERT_EQ(0x80u, block5->offset());
+
+                ASSERT_EQ(0x40u, buffer[0x00]);
+                ASSERT_EQ(0x7Fu, buffer[0x3F]);
+                ASSERT_EQ(0xC0u, buffer[0x40]);
+                ASSERT_EQ(0xFFu, buffer[0x7F]);
+
+                // deactivate by leaving block
+                EXPECT_CALL(glMock, BindBuffer(GL_ARRAY_BUFFER, 0));
+            }
+
+            // destroy vbo
+            EXPECT_CALL(glMock, DeleteBuffers(1, Pointee(13)));
+        }
     }
 }
@@ -21,6 +21,9 @@
 
 #include "StringUtils.h"
 
+#include <cstdio>
+#include <cstring>
+
 namespace StringUtils {
     TEST(StringUtilsTest, trim) {
         String result;
@@ -226,4 +229,24 @@ namespace StringUtils {
         ASSERT_EQ(String("asdf\\"), StringUtils::unescape("asdf\\", ""));
         ASSERT_EQ(String("asdf\\"), StringUtils::unescape("asdf\\\\", ""));
     }
+    
+    TEST(StringUtilsTest, formatFloatMatchesPrintf) {
+        const double values[] = {
+            0.0, -0.0, 1.0, -1.0, 16.0, -64.0, 0.5, -0.25, 0.1, 1.0 / 3.0,
+            999999.0, 1000000.0, -1000000.0, 1234567.0, 123456789.0, 1e15, 1e17, 1e18, -4294967296.0,
+            1.5e-7, 3.0e300, -2.5e-300
+        };
+        const int precisions[] = { 6, 17 };
+        
+        char expected[FormatFloatBufferSize];
+        char actual[FormatFloatBufferSize];
+        for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+            for (size_t j = 0; j < sizeof(precisions) / sizeof(precisions[0]); ++j) {
+                std::sprintf(expected, "%.*g", precisions[j], values[i]);
+                const size_t length = formatFloat(actual, values[i], precisions[j]);
+                ASSERT_STREQ(expected, actual);
+                ASSERT_EQ(std::strlen(expected), length);
+            }
+        }
+    }
 }
@@ -0,0 +1,181 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/ComputeMemoryUsageVisitor.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+#include "View/AddRemoveNodesCommand.h"
+#include "View/CommandProcessor.h"
+#include "View/MapDocumentCommandFacade.h"
+#include "View/UndoableCommand.h"
+
+namespace TrenchBroom {
+    namespace View {
+        class TestCommand : public UndoableCommand {
+        public:
+            static const CommandType Type;
+            typedef std::tr1::shared_ptr<TestCommand> Ptr;
+        private:
+            size_t m_memorySize;
+            bool m_collatable;
+        public:
+            static Ptr create(const String& name, const size_t memorySize, const bool collatable = false) {
+                return Ptr(new TestCommand(name, memorySize, collatable));
+            }
+        private:
+            TestCommand(const String& name, const size_t memorySize, const bool collatable) :
+            UndoableCommand(Type, name),
+            m_memorySize(memorySize),
+            m_collatable(collatable) {}
+            
+            bool doPerformDo(MapDocumentCommandFacade* document) { return true; }
+            bool doPerformUndo(MapDocumentCommandFacade* document) { return true; }
+            bool doIsRepeatable(MapDocumentCommandFacade* document) const { return false; }
+            
+            bool doCollateWith(UndoableCommand::Ptr command) {
+                if (!m_collatable)
+                    return false;
+                m_memorySize += command->memorySize();
+                return true;
+            }
+            
+            size_t doGetMemorySize() const { return m_memorySize; }
+        };
+        
+        const Command::CommandType TestCommand::Type = Command::freeType();
+        
+        static MapDocumentCommandFacade* commandFacade(MapDocumentSPtr document) {
+            return static_cast<MapDocumentCommandFacade*>(document.get());
+        }
+        
+        TEST(CommandProcessorTest, evictOldestCommandsWhenLimitIsExceeded) {
+            MapDocumentSPtr document = MapDocumentCommandFacade::newMapDocument();
+            CommandProcessor processor(commandFacade(document));
+            processor.setMemoryLimit(250);
+            
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("1", 100)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("2", 100)));
+            ASSERT_EQ(200u, processor.memorySize());
+            
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("3", 100)));
+            ASSERT_EQ(200u, processor.memorySize());
+            ASSERT_EQ("3", processor.lastCommandName());
+            
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_EQ("2", processor.lastCommandName());
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_FALSE(processor.hasLastCommand());
+            ASSERT_EQ(200u, processor.memorySize());
+        }
+        
+        TEST(CommandProcessorTest, keepMostRecentCommandWhenLimitIsExceeded) {
+            MapDocumentSPtr document = MapDocumentCommandFacade::newMapDocument();
+            CommandProcessor processor(commandFacade(document));
+            processor.setMemoryLimit(50);
+            
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("1", 100)));
+            ASSERT_TRUE(processor.hasLastCommand());
+            ASSERT_EQ("1", processor.lastCommandName());
+            
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("2", 100)));
+            ASSERT_EQ(100u, processor.memorySize());
+            ASSERT_EQ("2", processor.lastCommandName());
+        }
+        
+        TEST(CommandProcessorTest, evictOldestCommandsWhenLimitIsLowered) {
+            MapDocumentSPtr document = MapDocumentCommandFacade::newMapDocument();
+            CommandProcessor processor(commandFacade(document));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("1", 100)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("2", 100)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("3", 100)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("4", 100)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("5", 100)));
+            ASSERT_EQ(500u, processor.memorySize());
+            
+            processor.setMemoryLimit(300);
+            ASSERT_EQ(300u, processor.memorySize());
+            ASSERT_EQ("5", processor.lastCommandName());
+            
+            for (size_t i = 0; i < 3; ++i)
+                ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_FALSE(processor.hasLastCommand());
+        }
+        
+        TEST(CommandProcessorTest, countNextCommandsTowardsLimit) {
+            MapDocumentSPtr document = MapDocumentCommandFacade::newMapDocument();
+            CommandProcessor processor(commandFacade(document));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("1", 100)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("2", 100)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("3", 100)));
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_EQ(300u, processor.memorySize());
+            
+            // only the undo history is evicted, the redo history is kept
+            processor.setMemoryLimit(250);
+            ASSERT_EQ(200u, processor.memorySize());
+            ASSERT_EQ("2", processor.lastCommandName());
+            ASSERT_EQ("3", processor.nextCommandName());
+            
+            ASSERT_TRUE(processor.redoNextCommand());
+            ASSERT_EQ("3", processor.lastCommandName());
+            ASSERT_EQ(200u, processor.memorySize());
+        }
+        
+        TEST(CommandProcessorTest, evictOldestCommandsWhenCollatedCommandGrows) {
+            MapDocumentSPtr document = MapDocumentCommandFacade::newMapDocument();
+            CommandProcessor processor(commandFacade(document));
+            processor.setMemoryLimit(250);
+            
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("1", 100)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("2", 100, true)));
+            ASSERT_EQ(200u, processor.memorySize());
+            
+            // "3" is collated into "2", which then takes up 200 bytes
+            ASSERT_TRUE(processor.submitAndStoreCommand(TestCommand::create("3", 100)));
+            ASSERT_EQ(200u, processor.memorySize());
+            ASSERT_EQ("2", processor.lastCommandName());
+            
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_FALSE(processor.hasLastCommand());
+        }
+        
+        TEST(CommandProcessorTest, addCommandCountsOwnedNodes) {
+            const BBox3 worldBounds(4096.0);
+            Model::World world(Model::MapFormat::Standard, NULL, worldBounds);
+            Model::BrushBuilder builder(&world, worldBounds);
+            
+            Model::NodeList brushes;
+            for (size_t i = 0; i < 10; ++i)
+                brushes.push_back(builder.createCube(64.0, "texture"));
+            
+            Model::ComputeMemoryUsageVisitor visitor;
+            Model::Node::acceptAndRecurse(brushes.begin(), brushes.end(), visitor);
+            ASSERT_EQ(10u, visitor.brushes().count);
+            
+            // the command owns the brushes until it is performed
+            const UndoableCommand::Ptr command = AddRemoveNodesCommand::add(&world, brushes);
+            ASSERT_GT(command->memorySize(), visitor.total().bytes);
+        }
+    }
+}
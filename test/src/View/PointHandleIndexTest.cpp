@@ -0,0 +1,110 @@
+/*
+ Copyright (C) 2010-2014 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "VecMath.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/PointHandleIndex.h"
+
+namespace TrenchBroom {
+    namespace View {
+        TEST(PointHandleIndexTest, findHandlesContainsAllHits) {
+            // roughly 100k handles on a grid
+            Vec3::List positions;
+            for (size_t x = 0; x < 47; ++x) {
+                for (size_t y = 0; y < 47; ++y) {
+                    for (size_t z = 0; z < 47; ++z)
+                        positions.push_back(Vec3(64.0 * x - 1504.0, 64.0 * y - 1504.0, 64.0 * z - 1504.0));
+                }
+            }
+            
+            PointHandleIndex::List handles;
+            for (size_t i = 0; i < positions.size(); ++i)
+                handles.push_back(&positions[i]);
+            
+            PointHandleIndex index;
+            ASSERT_FALSE(index.valid());
+            index.build(handles);
+            ASSERT_TRUE(index.valid());
+            
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, viewport, Vec3f(-2048.0f, -1024.0f, 512.0f), Vec3f::PosX, Vec3f::PosZ);
+            camera.setViewport(viewport);
+            camera.setDirection(Vec3f(2048.0f, 1024.0f, -512.0f).normalized(), Vec3f::PosZ);
+            const FloatType handleRadius = 3.0;
+            
+            for (size_t x = 0; x < 1024; x += 97) {
+                for (size_t y = 0; y < 768; y += 89) {
+                    const Ray3 ray(camera.pickRay(static_cast<int>(x), static_cast<int>(y)));
+                    const PointHandleIndex::List candidates = index.findHandles(ray, camera, handleRadius);
+                    ASSERT_LT(candidates.size(), handles.size() / 10);
+                    
+                    for (size_t i = 0; i < handles.size(); ++i) {
+                        if (!Math::isnan(camera.pickPointHandle(ray, *handles[i], handleRadius))) {
+                            ASSERT_TRUE(VectorUtils::contains(candidates, handles[i]));
+                        }
+                    }
+                }
+            }
+            
+            index.invalidate();
+            ASSERT_FALSE(index.valid());
+        }
+        
+        TEST(PointHandleIndexTest, addAndRemoveHandles) {
+            const Vec3 min(-64.0, -64.0, -64.0);
+            const Vec3 max(64.0, 64.0, 64.0);
+            const Vec3 inside(Vec3::Null);
+            const Vec3 outside(4096.0, 4096.0, 4096.0);
+            
+            // adding and removing handles does nothing while the index is invalid
+            PointHandleIndex index;
+            index.addHandle(&inside);
+            index.removeHandle(&inside);
+            ASSERT_FALSE(index.valid());
+            
+            PointHandleIndex::List handles;
+            handles.push_back(&min);
+            handles.push_back(&max);
+            index.build(handles);
+            
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, viewport, Vec3f(-2048.0f, -1024.0f, 512.0f), Vec3f::PosX, Vec3f::PosZ);
+            const Vec3 origin(camera.position());
+            const Ray3 ray(origin, (inside - origin).normalized());
+            const FloatType handleRadius = 3.0;
+            
+            ASSERT_FALSE(VectorUtils::contains(index.findHandles(ray, camera, handleRadius), &inside));
+            
+            index.addHandle(&inside);
+            ASSERT_TRUE(index.valid());
+            ASSERT_TRUE(VectorUtils::contains(index.findHandles(ray, camera, handleRadius), &inside));
+            
+            index.removeHandle(&inside);
+            ASSERT_TRUE(index.valid());
+            ASSERT_FALSE(VectorUtils::contains(index.findHandles(ray, camera, handleRadius), &inside));
+            
+            // a handle outside of the bounds of the index requires it to be rebuilt
+            index.addHandle(&outside);
+            ASSERT_FALSE(index.valid());
+        }
+    }
+}